@@ -0,0 +1,118 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Find the AES secret key by its label
+ *      4. Encrypt or decrypt given file in bounded memory and print the throughput
+ *      5. Disconnect from a connect slot
+ *
+ * The encrypted file is the IV followed by the ciphertext of CKM_AES_CBC_PAD. The files are
+ * memory-mapped and processed in chunks (8 MiB by default), therefore, files larger than RAM
+ * e.g., backups can be encrypted.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make p11crypt
+ *
+ * If Makefile was used to build, then to execute the program, run the following commands
+ *      ./p11crypt enc <key label> <plain file> <encrypted file> [chunk MiB]
+ *      ./p11crypt dec <key label> <encrypted file> <plain file> [chunk MiB]
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_p11crypt
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror p11crypt.cpp ../source/file_crypt.cpp ../source/slot_dispatcher.cpp ../source/async_operation.cpp ../source/login_manager.cpp ../source/conn_dis_token.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o p11crypt -I../include -pthread
+ *
+ * To generate an AES key on the token, one can run test_AESKeys, where the label is e.g., "AES 256-bit key"
+ *
+*/
+
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "../header/basic_operation.hpp"
+#include "../header/conn_dis_token.hpp"
+#include "../header/file_crypt.hpp"
+#include "../header/slot_dispatcher.hpp"
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function prints the usage of the program
+*/
+inline void print_usage(const char* program)
+{
+	cout << "Usage:\n"
+		 << "\t" << program << " enc <key label> <plain file> <encrypted file> [chunk MiB]\n"
+		 << "\t" << program << " dec <key label> <encrypted file> <plain file> [chunk MiB]\n";
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	int retVal = 0;
+	bool encrypt = false;
+	size_t chunkSz = FILE_CRYPT_CHUNK_SIZE;
+	void *libHandle = nullptr;
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	CK_OBJECT_HANDLE hSecretkey = CK_INVALID_HANDLE;
+	std::string usrPIN;
+	file_crypt_stats stats;
+	key_selector selector;
+
+	if (argc < 5 || argc > 6 || (std::strcmp(argv[1], "enc") && std::strcmp(argv[1], "dec"))) {
+		print_usage(argv[0]);
+		return -1;
+	}
+	encrypt = !std::strcmp(argv[1], "enc");
+	if (argc == 6) {
+		chunkSz = std::strtoul(argv[5], NULL_PTR, 10) << 20;
+		if (!chunkSz) {
+			cout << "Error, chunk size should be at least 1 MiB\n";
+			return -1;
+		}
+	}
+	selector.label = argv[2];
+	selector.keyClass = CKO_SECRET_KEY;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = find_key(funclistPtr, hSession, selector, hSecretkey);
+			if (retVal) {
+				cout << "Error, no secret key labeled \"" << selector.label << "\" on the token\n";
+			}
+			else if (encrypt) {
+				retVal = encrypt_file(funclistPtr, hSession, hSecretkey, argv[3], argv[4], stats, chunkSz);
+			}
+			else {
+				retVal = decrypt_file(funclistPtr, hSession, hSecretkey, argv[3], argv[4], stats, chunkSz);
+			}
+			if (!retVal) {
+				cout << (encrypt ? "Encrypted " : "Decrypted ") << stats.bytesIn << " bytes into "
+					 << stats.bytesOut << " bytes in " << stats.chunkCount << " chunks\n"
+					 << "\t" << stats.seconds << " s, " << stats.MiBps << " MiB/s\n";
+			}
+			if (!disconnect_slot(funclistPtr, hSession)) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -8,7 +8,9 @@
  * 		3. Generate AES key (symmetric key) by invoking
  *      4. Encrypt given plaintext/data  
  *      5. Decrypt given ciphertext/data
- *      6. Disconnect from a connect slot
+ *      6. Encrypt and decrypt given plaintext/data again as scatter-gather lists of struct iovec,
+ *      whose segment boundaries fall in the middle of AES blocks
+ *      7. Disconnect from a connect slot
  *      
  * 
  * To use the Makefile, make sure you're in the same directory of Makefile
@@ -23,7 +25,7 @@
  * 
  * To build the program in the example directory, one can run the following command
  * On Linux
- *      g++ -Wall -Werror test_AES_enc_dec.cpp ../source/AES_enc_dec.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_AESEncDec -I../include
+ *      g++ -Wall -Werror test_AES_enc_dec.cpp ../source/AES_enc_dec.cpp ../source/secure_pool.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_AESEncDec -I../include
  * 
  * On Windows
  * 
@@ -59,11 +61,13 @@
 	#include "..\header\conn_dis_token.hpp"
 	#include "..\header\gen_AES_keys.hpp"
     #include "..\header\AES_enc_dec.hpp"
+	#include "..\header\secure_pool.hpp"
 #else
 	#include "../header/basic_operation.hpp"
 	#include "../header/conn_dis_token.hpp"
 	#include "../header/gen_AES_keys.hpp"
     #include "../header/AES_enc_dec.hpp"
+	#include "../header/secure_pool.hpp"
 #endif
 
 // AES uses 128-bit (16-byte) block
@@ -79,6 +83,61 @@ using std::cin;
 
 
 
+/**
+ * The function splits given buffer into three segments, the first two of given byte-lengths
+ * and the third of the remaining bytes
+*/
+void split_segments(void* bufPtr, const size_t bufLen, const size_t firstLen, const size_t secondLen,
+                    struct iovec iov[3])
+{
+    CK_BYTE_PTR bytePtr = static_cast<CK_BYTE_PTR>(bufPtr);
+
+    iov[0] = {bytePtr, firstLen};
+    iov[1] = {bytePtr + firstLen, secondLen};
+    iov[2] = {bytePtr + firstLen + secondLen, bufLen - firstLen - secondLen};
+}
+
+
+
+/**
+ * The function encrypts and decrypts given plaintext as scatter-gather lists, where every
+ * boundary of the segments falls in the middle of an AES block, so the updates are written
+ * both directly into the segments and through the bounce buffer
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int iovec_enc_dec(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hSecretkey, const secure_string& plaintext)
+{
+    int retVal = 0;
+    secure_bytes ciphertext(plaintext.length() + BYTE_LEN);
+    secure_bytes dectext(ciphertext.size());
+    struct iovec ptIov[3], ctIov[3], dtIov[3];
+    size_t ctLen = 0;
+    size_t dtLen = 0;
+
+    // The plaintext is cut at bytes 5 and 35, the ciphertext at bytes 7 and 27
+    split_segments(const_cast<char*>(plaintext.data()), plaintext.length(), 5, 30, ptIov);
+    split_segments(ciphertext.data(), ciphertext.size(), 7, 20, ctIov);
+    retVal = encrypt_plaintext(funclistPtr, hSession, hSecretkey, ptIov, 3, ctIov, 3, ctLen);
+    if (!retVal) {
+        cout << "\tData successfully encrypted from 3 segments into 3 segments\n";
+        // The ciphertext is cut at bytes 13 and 37, the decrypted text at bytes 9 and 39
+        split_segments(ciphertext.data(), ctLen, 13, 24, ctIov);
+        split_segments(dectext.data(), dectext.size(), 9, 30, dtIov);
+        retVal = decrypt_ciphertext(funclistPtr, hSession, hSecretkey, ctIov, 3, dtIov, 3, dtLen);
+        if (!retVal && !plaintext.compare(0, plaintext.length(), reinterpret_cast<const char*>(dectext.data()), dtLen)) {
+            cout << "\tAfter decryption, plaintext matches decrypted text of the segments!!!\n";
+        }
+        else if (!retVal) {
+            cout << "Error, plaintext does not match decrypted text of the segments\n";
+            retVal = 1;
+        }
+    }
+    return retVal;
+}
+
+
 
 int main()
 {
@@ -105,9 +164,12 @@ int main()
     CK_BYTE IV[BYTE_LEN];
     
     std::string label("AES xxx-bit key");
-    std::string plaintext("This is to test our AES encryption scheme implementation and we are adding some texts on line #2");
-    std::string ciphertext;
-    std::string dectext;
+    // The plaintext and the decrypted text are held in the locked secure pool, and zeroized on release
+    secure_string plaintext("This is to test our AES encryption scheme implementation and we are adding some texts on line #2");
+    secure_bytes ciphertext(plaintext.length() + BYTE_LEN);
+    secure_bytes dectext(ciphertext.size());
+    byte_span ctSpan(ciphertext.data(), ciphertext.size());
+    byte_span dtSpan(dectext.data(), dectext.size());
 
     /**
      * typedef CK_ULONG CK_OBJECT_HANDLE;
@@ -170,20 +232,25 @@ int main()
                 if (!retVal) {
                     // Encrypt plaintext
                     retVal = encrypt_plaintext(funclistPtr, hSession, keyHandle,
-                                            plaintext, ciphertext);
+                                            const_byte_span(plaintext.data(), plaintext.length()), ctSpan);
                     if (!retVal) {
                         cout << "\tData successfully encrypted\n";
                         // Decrypt ciphertext
                         retVal = decrypt_ciphertext(funclistPtr, hSession, keyHandle,
-                                                ciphertext, dectext);
+                                                const_byte_span(ciphertext.data(), ctSpan.size), dtSpan);
                         
                         // Comparing plaintext to decrypted text
                         // dectext += "error";
-                        if (!plaintext.compare(dectext)) {
+                        if (!retVal && !plaintext.compare(0, plaintext.length(),
+                                                            reinterpret_cast<const char*>(dectext.data()), dtSpan.size)) {
                             cout << "\tAfter decryption, plaintext matches decrypted text!!!\n";
                         }
                     }
                 }
+                // The same key and plaintext again as segments, with a new IV
+                if (!retVal && !(retVal = init_Mech(funclistPtr, hSession, IV, sizeof(IV)))) {
+                    retVal = iovec_enc_dec(funclistPtr, hSession, keyHandle, plaintext);
+                }
             }
 			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
 				cout << "Disconnected from token successfully\n";
@@ -191,10 +258,9 @@ int main()
 		}
 	}
 	free_resource(libHandle, funclistPtr);
-    usrPIN.clear();
-    plaintext.clear();
-    ciphertext.clear();
-    dectext.clear();
+    // clear() zeroizes nothing, the PIN and short strings are held in the string itself
+    secure_wipe(usrPIN);
+    secure_wipe(plaintext);
     label.clear();
     keyLen = 0;
     
@@ -0,0 +1,149 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an HMAC 256-bit key (token object)
+ *      4. Compute the HMAC SHA-256 of a message
+ *          i.      in a single part, and verify it
+ *          ii.     in multiple parts, and compare it with the single part one
+ *      5. Verify a tampered MAC, which should fail
+ *      6. Compute and verify the MACs of 32 messages across the worker sessions of an asynchronous executor
+ *      7. Stop the executor and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_HMAC
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_HMAC
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_HMAC
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_HMAC_sign_verify.cpp ../source/HMAC_sign_verify.cpp ../source/async_operation.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_HMAC -I../include -pthread
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\HMAC_sign_verify.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/HMAC_sign_verify.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	const CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	const std::string keyLabel("HMAC 256-bit key");
+	std::string message("This is to test HMAC SHA-256, in a single part and in multiple parts");
+	std::string mac, partsMac;
+	const size_t partLen = 16;
+	const size_t batchCount = 32;
+	std::vector<std::string> messages(batchCount, message);
+	std::vector<std::string> macs;
+	std::vector<int> results;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_HMAC_key(funclistPtr, hSession, keyLen, keyLabel, hKey);
+			if (!retVal) {
+				cout << "\t" << keyLabel << " successfully generated\n";
+				retVal = sign_HMAC(funclistPtr, hSession, hKey, CKM_SHA256_HMAC, message, mac);
+			}
+			if (!retVal) {
+				retVal = verify_HMAC(funclistPtr, hSession, hKey, CKM_SHA256_HMAC, message, mac);
+			}
+			if (!retVal) {
+				cout << "\tSingle part MAC correctly verified\n";
+				retVal = sign_HMAC_init(funclistPtr, hSession, hKey, CKM_SHA256_HMAC);
+				for (size_t offset = 0; !retVal && offset < message.length(); offset += partLen) {
+					size_t len = message.length() - offset < partLen ? message.length() - offset : partLen;
+					retVal = sign_HMAC_update(funclistPtr, hSession,
+												reinterpret_cast<CK_BYTE_PTR>(&message[offset]), len);
+				}
+				if (!retVal) {
+					retVal = sign_HMAC_final(funclistPtr, hSession, CKM_SHA256_HMAC, partsMac);
+				}
+			}
+			if (!retVal) {
+				if (constant_time_equal(mac, partsMac)) {
+					cout << "\tMultiple part MAC is the same as single part MAC\n";
+				}
+				else {
+					cout << "Error, multiple part MAC is not the same as single part MAC\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				// Changing one byte of MAC only
+				partsMac[0] ^= 0xFF;
+				if (verify_HMAC(funclistPtr, hSession, hKey, CKM_SHA256_HMAC, message, partsMac)) {
+					cout << "\tTampered MAC rejected\n";
+				}
+				else {
+					cout << "Error, tampered MAC verified\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				async_executor executor;
+				retVal = executor.start(funclistPtr, hSession, 4);
+				if (!retVal) {
+					for (size_t i = 0; i < batchCount; ++i) {
+						messages[i] += " #" + std::to_string(i);
+					}
+					retVal = sign_HMAC_batch(executor, hKey, CKM_SHA256_HMAC, messages, macs);
+					if (!retVal) {
+						retVal = verify_HMAC_batch(executor, hKey, CKM_SHA256_HMAC, messages, macs, results);
+					}
+					if (!retVal) {
+						cout << "\t" << batchCount << " MACs computed and verified across "
+							 << executor.worker_count() << " worker sessions\n";
+					}
+					executor.stop();
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -8,7 +8,8 @@
  * 		3. Generate RSA key pair (Public and Private keys)
  *      4. Encrypt plaintext using RAS-OAEP encryption scheme
  *      5. Decrypt ciphertext using RAS-OAEP encryption scheme
- *      4. Disconnect from a connect slot
+ *      6. Encrypt and decrypt plaintext again as scatter-gather lists of struct iovec
+ *      7. Disconnect from a connect slot
  * 
  * To use the Makefile, make sure you're in the same directory of Makefile
  * To build the program using Makefile, run the following command
@@ -22,7 +23,7 @@
  * 
  * To build the program in the example directory, one can run the following command
  * On Linux
- *      g++ -Wall -Werror test_RSA_OAEP_enc_dec.cpp ../source/RSA_OAEP_enc_dec.cpp ../source/gen_RSA_keypair.cpp ../source/conn_dis_token.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_RSAOAEP -I../include
+ *      g++ -Wall -Werror test_RSA_OAEP_enc_dec.cpp ../source/RSA_OAEP_enc_dec.cpp ../source/secure_pool.cpp ../source/gen_RSA_keypair.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_RSAOAEP -I../include
  * 
  * On Windows
  * 
@@ -51,6 +52,7 @@
 
 #include <iostream>
 #include <limits>
+#include <string>
 #ifdef WIND
 	#include "..\header\win_basic_operation.hpp"
 	#include "..\header\conn_dis_token.hpp"
@@ -68,6 +70,65 @@ using std::cout;
 using std::cin;
 
 
+
+/**
+ * The function splits given buffer into three segments, the first two of given byte-lengths
+ * and the third of the remaining bytes
+*/
+void split_segments(void* bufPtr, const size_t bufLen, const size_t firstLen, const size_t secondLen,
+                    struct iovec iov[3])
+{
+    CK_BYTE_PTR bytePtr = static_cast<CK_BYTE_PTR>(bufPtr);
+
+    iov[0] = {bytePtr, firstLen};
+    iov[1] = {bytePtr + firstLen, secondLen};
+    iov[2] = {bytePtr + firstLen + secondLen, bufLen - firstLen - secondLen};
+}
+
+
+
+/**
+ * The function encrypts and decrypts given plaintext as scatter-gather lists of three segments,
+ * so the input is gathered and the output is scattered through the buffers of the functions
+ *
+ * modulusLen represents the byte-length of the modulus
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int iovec_enc_dec(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hPublic, const CK_OBJECT_HANDLE& hPrivate,
+                    const size_t modulusLen, const std::string& plaintext)
+{
+    int retVal = 0;
+    std::string ciphertext(modulusLen, '\0');
+    std::string dectext(modulusLen, '\0');
+    struct iovec ptIov[3], ctIov[3], dtIov[3];
+    size_t ctLen = 0;
+    size_t dtLen = 0;
+
+    // The plaintext is cut at bytes 5 and 35, the ciphertext at bytes 7 and 107
+    split_segments(const_cast<char*>(plaintext.data()), plaintext.length(), 5, 30, ptIov);
+    split_segments(&ciphertext[0], ciphertext.length(), 7, 100, ctIov);
+    retVal = encrypt_plaintext(funclistPtr, hSession, hPublic, ptIov, 3, ctIov, 3, ctLen);
+    if (!retVal) {
+        cout << "\tData successfully encrypted from 3 segments into 3 segments\n";
+        // The ciphertext is cut at bytes 13 and 133, the decrypted text at bytes 9 and 29
+        split_segments(&ciphertext[0], ctLen, 13, 120, ctIov);
+        split_segments(&dectext[0], dectext.length(), 9, 20, dtIov);
+        retVal = decrypt_ciphertext(funclistPtr, hSession, hPrivate, ctIov, 3, dtIov, 3, dtLen);
+        if (!retVal && !plaintext.compare(0, plaintext.length(), dectext, 0, dtLen)) {
+            cout << "\tAfter decryption, plaintext matches decrypted text of the segments!!!\n";
+        }
+        else if (!retVal) {
+            cout << "Error, plaintext does not match decrypted text of the segments\n";
+            retVal = 1;
+        }
+    }
+    return retVal;
+}
+
+
+
 int main()
 {
 	int retVal = 0;
@@ -81,7 +142,7 @@ int main()
 	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
 	CK_SESSION_HANDLE hSession = 0; 
 	std::string usrPIN;
-	size_t modBitLen = 0;
+	CK_ULONG modBitLen = 0;
 
     std::string plaintext("This is to test our RSA-OAEP encryption scheme implementation.");
 	std::string ciphertext;
@@ -150,6 +211,10 @@ int main()
                         cout << "\tAfter decryption, plaintext matches decrypted text!!!\n";
                     }
                 }
+                // The same key pair and plaintext again as segments
+                if (!retVal) {
+                    retVal = iovec_enc_dec(funclistPtr, hSession, hPublic, hPrivate, modBitLen / 8, plaintext);
+                }
 
 			}
 
@@ -0,0 +1,126 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Start an asynchronous executor of 4 worker threads, each owning its own session
+ *      4. Generate AES keys asynchronously, where the result is returned through
+ *          i.      std::future
+ *          ii.     completion callback
+ *      5. Generate a batch of AES keys split in chunks across the worker threads
+ *      6. Stop the executor i.e., join the worker threads and close their sessions
+ *      7. Disconnect from a connect slot
+ *
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_AsyncOpr
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_AsyncOpr
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_AsyncOpr
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_async_operation.cpp ../source/async_operation.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_AsyncOpr -I../include -pthread
+ *
+ * To see the list of slots, run the following command
+ *      softhsm2-util --show-slots
+ *
+ * If a slot has not initialized, then to initialize a token slot, one can run the following commands
+ * 		softhsm2-util --init-token --free --so-pin <so_pin> --pin <user_pin> --label <token_label>
+ * OR
+ *      softhsm2-util --init-token --slot <slot_number> --label <text>
+ *
+ * Using p11tool to see the generated keys on token, run the following command.
+ * Note that session keys exist only during the session
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --login --list-all <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_AES_keys.hpp"
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_AES_keys.hpp"
+	#include "../header/async_operation.hpp"
+#endif
+
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+    CK_ULONG keyLen = 32;       // byte-length
+    const size_t batchCount = 16;
+    CK_OBJECT_HANDLE hFuture = 0;
+    CK_OBJECT_HANDLE hCallback = 0;
+    CK_OBJECT_HANDLE hBatch[batchCount] = {0};
+    std::promise<int> callbackDone;
+
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+            async_executor executor;
+            retVal = executor.start(funclistPtr, hSession, 4);
+            if (!retVal) {
+                cout << "\tExecutor started with " << executor.worker_count() << " worker threads\n";
+                std::future<int> keyFuture = async_operation(executor, gen_AES_key, &hFuture, keyLen,
+                                                                std::string("AES 256-bit key (future)"));
+                async_operation_callback(executor, [&callbackDone](int opVal) { callbackDone.set_value(opVal); },
+                                            gen_AES_key, &hCallback, keyLen, std::string("AES 256-bit key (callback)"));
+                if (!(retVal = keyFuture.get())) {
+                    cout << "\tAES key " << hFuture << " generated through std::future\n";
+                }
+                if (!retVal && !(retVal = callbackDone.get_future().get())) {
+                    cout << "\tAES key " << hCallback << " generated through completion callback\n";
+                }
+                if (!retVal) {
+                    retVal = async_batch(executor, batchCount, 4,
+                                            [&hBatch, keyLen](const CK_FUNCTION_LIST_PTR funcPtr, CK_SESSION_HANDLE& hWorker, size_t i) {
+                                                CK_ULONG len = keyLen;
+                                                return gen_AES_key(funcPtr, hWorker, &hBatch[i], len, "AES 256-bit key (batch)");
+                                            }, NULL_PTR);
+                    if (!retVal) {
+                        cout << "\t" << batchCount << " AES keys generated in a batch\n";
+                    }
+                }
+                executor.stop();
+            }
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+    keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,117 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Build the template of an AES 128-bit session key at compile time, where only
+ *      CKA_VALUE_LEN and CKA_LABEL are set per call
+ *      4. Generate the key with the template and read its CKA_VALUE_LEN back
+ *      5. Destroy the key and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_AttrTmpl
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_AttrTmpl
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_AttrTmpl
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_attribute_template.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_AttrTmpl -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_attribute_template.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_AttrTmpl.exe -I../include -DWIND
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\attribute_template.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/attribute_template.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The template of an AES session key, where the fixed attributes are laid out at compile time
+*/
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							variable_attribute<CKA_VALUE_LEN>,
+							variable_attribute<CKA_LABEL> > AES_session_key_template;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_ULONG keyLen = 16;       // byte-length
+	CK_ULONG readLen = 0;
+	CK_OBJECT_HANDLE hKey = 0;
+	CK_MECHANISM keyMech = {CKM_AES_KEY_GEN};
+	const std::string keyLabel("AES 128-bit key (template)");
+	AES_session_key_template keyAttrb;
+	CK_ATTRIBUTE readAttrb[] = {
+		{CKA_VALUE_LEN, &readLen, sizeof(readLen)}
+	};
+
+	// keyLen must have the type CK_ULONG, otherwise e.g., int, the template does not compile.
+	// size_t only compiles where it is CK_ULONG i.e., LP64
+	keyAttrb.set<CKA_VALUE_LEN>(keyLen);
+	keyAttrb.set_bytes<CKA_LABEL>(keyLabel.c_str(), keyLabel.length());
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = check_operation(funclistPtr->C_GenerateKey(hSession, &keyMech, keyAttrb.data(), keyAttrb.size(),
+																&hKey), "C_GenerateKey()");
+			if (!retVal) {
+				cout << "\t" << keyLabel << " successfully generated with " << keyAttrb.size() << " attributes\n";
+				retVal = check_operation(funclistPtr->C_GetAttributeValue(hSession, hKey, readAttrb,
+																		  sizeof(readAttrb) / sizeof(CK_ATTRIBUTE)),
+										 "C_GetAttributeValue()");
+				if (!retVal) {
+					cout << "\tCKA_VALUE_LEN of the key :: " << readLen << endl;
+				}
+				check_operation(funclistPtr->C_DestroyObject(hSession, hKey), "C_DestroyObject()");
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
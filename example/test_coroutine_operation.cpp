@@ -0,0 +1,143 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Initialize the AES CBC encryption mechanism with a random IV, and start an asynchronous
+ *      executor of 2 worker threads
+ *      4. Spawn a coroutine which awaits, one after the other
+ *          i.      co_generate_random() for a random prefix of the plaintext
+ *          ii.     co_generate_key() for an AES 256-bit key
+ *          iii.    co_encrypt() and co_decrypt() of the plaintext
+ *      5. Wait for the coroutine to complete and compare the plaintext to the decrypted text
+ *      6. Stop the executor and disconnect from a connect slot
+ *
+ * It requires -std=c++20
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_CoroOpr
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_CoroOpr
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_CoroOpr
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror -std=c++20 test_coroutine_operation.cpp ../source/coroutine_operation.cpp ../source/async_operation.cpp ../source/AES_enc_dec.cpp ../source/secure_pool.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_CoroOpr -I../include -pthread
+ *
+ * To see the list of slots, run the following command
+ *      softhsm2-util --show-slots
+ *
+ * If a slot has not initialized, then to initialize a token slot, one can run the following commands
+ * 		softhsm2-util --init-token --free --so-pin <so_pin> --pin <user_pin> --label <token_label>
+ * OR
+ *      softhsm2-util --init-token --slot <slot_number> --label <text>
+ *
+*/
+
+
+#include <future>
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\coroutine_operation.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/coroutine_operation.hpp"
+#endif
+
+// AES uses 128-bit (16-byte) block, which is also the byte-length of the IV
+#define BYTE_LEN 16
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The coroutine prefixes given plaintext with random bytes and generates an AES key, then encrypts and
+ * decrypts the plaintext, where every step is performed by a worker thread
+*/
+token_task encrypt_decrypt(async_executor& executor, std::string& plaintext, std::string& dectext)
+{
+	CK_OBJECT_HANDLE hKey = 0;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_BYTE prefix[BYTE_LEN];
+	std::string label("AES 256-bit key (coroutine)");
+	std::string ciphertext;
+	int retVal = 0;
+
+	if ((retVal = co_await co_generate_random(executor, prefix, sizeof(prefix)))) {
+		co_return retVal;
+	}
+	plaintext.insert(0, reinterpret_cast<const char*>(prefix), sizeof(prefix));
+	if ((retVal = co_await co_generate_key(executor, &hKey, keyLen, label))) {
+		co_return retVal;
+	}
+	cout << "\t" << label << " successfully generated\n";
+	if ((retVal = co_await co_encrypt(executor, hKey, plaintext, ciphertext))) {
+		co_return retVal;
+	}
+	cout << "\tData successfully encrypted, " << ciphertext.length() << " bytes\n";
+	co_return co_await co_decrypt(executor, hKey, ciphertext, dectext);
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+    CK_BYTE IV[BYTE_LEN];
+    std::string plaintext("This is to test the coroutines on top of the asynchronous executor");
+    std::string dectext;
+    std::promise<int> taskDone;
+
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+            async_executor executor;
+            // Initializing the AES CBC encryption mechansim
+            retVal = init_Mech(funclistPtr, hSession, IV, sizeof(IV));
+            if (!retVal) {
+                retVal = executor.start(funclistPtr, hSession, 2);
+            }
+            if (!retVal) {
+                // The calling thread only waits for the coroutine, which runs on the worker threads
+                spawn_task(encrypt_decrypt(executor, plaintext, dectext),
+                            [&taskDone](int taskVal) { taskDone.set_value(taskVal); });
+                retVal = taskDone.get_future().get();
+                if (!retVal && plaintext == dectext) {
+                    cout << "\tAfter decryption, plaintext matches decrypted text!!!\n";
+                }
+                executor.stop();
+            }
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,134 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an AES 256-bit key (token object) and write a test file of 1 MiB and 100 bytes
+ *      4. Write the encrypted container of the test file in 256 KiB chunks (AES-GCM) across the
+ *      worker sessions of an asynchronous executor
+ *      5. Read a range crossing a chunk boundary and the whole file back from the container,
+ *      where only the chunks of the range are decrypted, and compare them with the test file
+ *      6. Remove the files, stop the executor and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_Container
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_Container
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_Container
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_crypt_container.cpp ../source/crypt_container.cpp ../source/async_operation.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_Container -I../include -pthread
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../header/basic_operation.hpp"
+#include "../header/conn_dis_token.hpp"
+#include "../header/gen_AES_keys.hpp"
+#include "../header/crypt_container.hpp"
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	void *libHandle = nullptr;
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	const size_t chunkSz = 256 << 10;
+	const std::string plainPath("test_crypt_container.plain");
+	const std::string containerPath("test_crypt_container.p11c");
+	std::string plain((1 << 20) + 100, '\0');
+	std::string plaintext;
+	// A range crossing the boundary of the first and second chunks
+	const unsigned long long rangeOffset = chunkSz - 10;
+	const size_t rangeLen = 20;
+
+	for (size_t i = 0; i < plain.length(); ++i) {
+		plain[i] = static_cast<char>(i * 31 + i / 4096);
+	}
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_AES_key(funclistPtr, hSession, &hKey, keyLen, "AES 256-bit key (container)");
+			if (!retVal) {
+				std::ofstream plainFile(plainPath, std::ios::binary | std::ios::trunc);
+				if (!plainFile.write(plain.data(), plain.length())) {
+					cout << "Error, " << plainPath << " cannot be written\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				async_executor executor;
+				retVal = executor.start(funclistPtr, hSession, 4);
+				if (!retVal) {
+					retVal = write_container(executor, hKey, "container-key", plainPath, containerPath, chunkSz);
+					executor.stop();
+				}
+			}
+			if (!retVal) {
+				container_reader reader;
+				retVal = reader.open(containerPath);
+				if (!retVal) {
+					cout << "\tContainer of " << reader.size() << " bytes written, key ID :: "
+						 << reader.header().keyId << endl;
+					retVal = reader.read(funclistPtr, hSession, hKey, rangeOffset, rangeLen, plaintext);
+				}
+				if (!retVal) {
+					if (plaintext == plain.substr(rangeOffset, rangeLen)) {
+						cout << "\t" << rangeLen << " bytes at offset " << rangeOffset << " correctly read\n";
+						retVal = reader.read(funclistPtr, hSession, hKey, 0, plain.length(), plaintext);
+					}
+					else {
+						cout << "Error, range crossing the chunk boundary is not correctly read\n";
+						retVal = 1;
+					}
+				}
+				if (!retVal) {
+					if (plaintext == plain) {
+						cout << "\tWhole file correctly read\n";
+					}
+					else {
+						cout << "Error, whole file is not correctly read\n";
+						retVal = 1;
+					}
+				}
+				reader.close();
+			}
+			std::remove(plainPath.c_str());
+			std::remove(containerPath.c_str());
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,141 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an AES 256-bit key (token object) and write a test file of 3 MiB and 5 bytes
+ *      4. Encrypt and decrypt the test file in 1 MiB chunks through the pipeline of depth 3,
+ *      where reading, the token and writing overlap, and print the time of every stage
+ *      5. Compare the decrypted file with the test file, and digest the test file (SHA-256) through the pipeline
+ *      6. Remove the files and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_Pipeline
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_Pipeline
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_Pipeline
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_crypto_pipeline.cpp ../source/crypto_pipeline.cpp ../source/async_operation.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_Pipeline -I../include -pthread
+ *
+ * To compare the digest of the test file, one can keep it and run the following command
+ * 		sha256sum test_crypto_pipeline.plain
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "../header/basic_operation.hpp"
+#include "../header/conn_dis_token.hpp"
+#include "../header/gen_AES_keys.hpp"
+#include "../header/crypto_pipeline.hpp"
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function prints the statistics of a pipelined run
+*/
+inline void print_stats(const char* name, const pipeline_stats& stats)
+{
+	cout << "\t" << name << " " << stats.bytesIn << " bytes in " << stats.chunkCount << " chunks, "
+		 << stats.MiBps << " MiB/s (read " << stats.readSeconds << " s, token " << stats.cryptoSeconds
+		 << " s, write " << stats.writeSeconds << " s)\n";
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	void *libHandle = nullptr;
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	const pipeline_config config = {1 << 20, 3};
+	const std::string plainPath("test_crypto_pipeline.plain");
+	const std::string encPath("test_crypto_pipeline.enc");
+	const std::string decPath("test_crypto_pipeline.dec");
+	std::string plain(3 * config.chunkSize + 5, '\0');
+	std::string digest;
+	pipeline_stats stats;
+
+	for (size_t i = 0; i < plain.length(); ++i) {
+		plain[i] = static_cast<char>(i * 31 + i / 4096);
+	}
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_AES_key(funclistPtr, hSession, &hKey, keyLen, "AES 256-bit key (pipeline)");
+			if (!retVal) {
+				std::ofstream plainFile(plainPath, std::ios::binary | std::ios::trunc);
+				if (!plainFile.write(plain.data(), plain.length())) {
+					cout << "Error, " << plainPath << " cannot be written\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				retVal = encrypt_file_pipelined(funclistPtr, hSession, hKey, plainPath, encPath, stats, config);
+			}
+			if (!retVal) {
+				print_stats("Encrypted", stats);
+				retVal = decrypt_file_pipelined(funclistPtr, hSession, hKey, encPath, decPath, stats, config);
+			}
+			if (!retVal) {
+				print_stats("Decrypted", stats);
+				std::ifstream decFile(decPath, std::ios::binary);
+				if (std::string(std::istreambuf_iterator<char>(decFile), std::istreambuf_iterator<char>()) == plain) {
+					cout << "\tDecrypted file is the same as the test file\n";
+				}
+				else {
+					cout << "Error, decrypted file is not the same as the test file\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				retVal = digest_file_pipelined(funclistPtr, hSession, CKM_SHA256, plainPath, digest, stats, config);
+			}
+			if (!retVal) {
+				print_stats("Digested", stats);
+				cout << "\tSHA-256 of the test file (hex) :: ";
+				for (size_t i = 0; i < digest.length(); ++i) {
+					cout << "0123456789abcdef"[(digest[i] >> 4) & 0x0F] << "0123456789abcdef"[digest[i] & 0x0F];
+				}
+				cout << endl;
+			}
+			std::remove(plainPath.c_str());
+			std::remove(encPath.c_str());
+			std::remove(decPath.c_str());
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,199 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate two EC key pairs on prime256v1 i.e., of two parties, and read their public points
+ *      4. Derive an AES 128-bit key on each side, and check that both keys encrypt a block the same
+ *      5. Derive 64 AES keys across the worker sessions of an asynchronous executor
+ *      6. Stop the executor, which destroys the derived session keys, and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_ECDH
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_ECDH
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_ECDH
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_derive_ECDH.cpp ../source/derive_ECDH.cpp ../source/gen_EC_keypair.cpp ../source/async_operation.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_ECDH -I../include -pthread
+ *
+ * To delete the generated key pairs, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_EC_keypair.hpp"
+	#include "..\header\derive_ECDH.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_EC_keypair.hpp"
+	#include "../header/derive_ECDH.hpp"
+#endif
+
+// AES uses 128-bit (16-byte) block
+#define BYTE_LEN 16
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function reads the public point of given EC public key, where the DER OCTET STRING
+ * wrapping CKA_EC_POINT (if any) is removed i.e., 0x04 || x || y is returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int read_EC_point(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPub, std::string& point)
+{
+	CK_BYTE value[256];
+	CK_ATTRIBUTE pointAttrb[] = {
+		{CKA_EC_POINT, value, sizeof(value)}
+	};
+
+	if (check_operation(funclistPtr->C_GetAttributeValue(hSession, hPub, pointAttrb, 1), "C_GetAttributeValue()")) {
+		return 1;
+	}
+	// The short form of DER length is enough for the curves up to 521 bits
+	if (pointAttrb[0].ulValueLen > 2 && value[0] == 0x04 && value[1] == pointAttrb[0].ulValueLen - 2) {
+		point.assign(reinterpret_cast<char*>(value) + 2, pointAttrb[0].ulValueLen - 2);
+	}
+	else {
+		point.assign(reinterpret_cast<char*>(value), pointAttrb[0].ulValueLen);
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function encrypts one block with given AES key in ECB mode
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int encrypt_block(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hKey, CK_BYTE_PTR block, CK_BYTE_PTR encrypted)
+{
+	CK_MECHANISM ecbMech = {CKM_AES_ECB, NULL_PTR, 0};
+	CK_ULONG encryptedLen = BYTE_LEN;
+
+	if (check_operation(funclistPtr->C_EncryptInit(hSession, &ecbMech, hKey), "C_EncryptInit()")) {
+		return 1;
+	}
+	return check_operation(funclistPtr->C_Encrypt(hSession, block, BYTE_LEN, encrypted, &encryptedLen), "C_Encrypt()");
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+
+	// prime256v1 i.e., OID 1.2.840.10045.3.1.7
+	CK_BYTE ecPara[] = {0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07};
+	CK_OBJECT_HANDLE hPubA = 0, hPrvA = 0;     // Key pair of the first party
+	CK_OBJECT_HANDLE hPubB = 0, hPrvB = 0;     // Key pair of the second party
+	CK_OBJECT_HANDLE hKeyA = 0, hKeyB = 0;     // Keys derived by each party
+	std::string pointA, pointB;
+	const CK_ULONG keyLen = 16;       // byte-length
+	CK_BYTE block[BYTE_LEN] = "ECDH test block";
+	CK_BYTE encryptedA[BYTE_LEN], encryptedB[BYTE_LEN];
+	const size_t batchCount = 64;
+	std::vector<CK_OBJECT_HANDLE> hKeys;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_EC_keypair(funclistPtr, hSession, ecPara, sizeof(ecPara), &hPubA, &hPrvA);
+			if (!retVal) {
+				retVal = gen_EC_keypair(funclistPtr, hSession, ecPara, sizeof(ecPara), &hPubB, &hPrvB);
+			}
+			if (!retVal) {
+				retVal = read_EC_point(funclistPtr, hSession, hPubA, pointA);
+			}
+			if (!retVal) {
+				retVal = read_EC_point(funclistPtr, hSession, hPubB, pointB);
+			}
+			if (!retVal) {
+				// Every party uses its own private key and the public point of the other
+				retVal = derive_ECDH_AES_key(funclistPtr, hSession, hPrvA, reinterpret_cast<CK_BYTE_PTR>(&pointB[0]),
+												pointB.length(), CKD_NULL, keyLen, hKeyA);
+			}
+			if (!retVal) {
+				retVal = derive_ECDH_AES_key(funclistPtr, hSession, hPrvB, reinterpret_cast<CK_BYTE_PTR>(&pointA[0]),
+												pointA.length(), CKD_NULL, keyLen, hKeyB);
+			}
+			if (!retVal) {
+				// The derived keys are sensitive, so they are compared by what they encrypt
+				retVal = encrypt_block(funclistPtr, hSession, hKeyA, block, encryptedA);
+			}
+			if (!retVal) {
+				retVal = encrypt_block(funclistPtr, hSession, hKeyB, block, encryptedB);
+			}
+			if (!retVal) {
+				if (std::string(reinterpret_cast<char*>(encryptedA), BYTE_LEN) ==
+					std::string(reinterpret_cast<char*>(encryptedB), BYTE_LEN)) {
+					cout << "\tBoth parties derived the same AES key\n";
+				}
+				else {
+					cout << "Error, the parties derived different AES keys\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				async_executor executor;
+				retVal = executor.start(funclistPtr, hSession, 4);
+				if (!retVal) {
+					std::vector<ecdh_request> requests(batchCount);
+					for (size_t i = 0; i < batchCount; ++i) {
+						requests[i].hPrv = hPrvA;
+						requests[i].peerPoint = pointB;
+					}
+					retVal = derive_ECDH_AES_keys_batch(executor, requests, CKD_NULL, keyLen, hKeys);
+					if (!retVal) {
+						cout << "\t" << batchCount << " AES keys derived across " << executor.worker_count()
+							 << " worker sessions\n";
+					}
+					// The keys derived by the workers are destroyed with their sessions
+					executor.stop();
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
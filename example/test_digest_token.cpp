@@ -0,0 +1,132 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Compute the SHA-256 digest of a message
+ *          i.      in a single part
+ *          ii.     in multiple parts, and compare it with the single part one
+ *      4. If a file is given, digest it on the token and on the host (OpenSSL), and print
+ *      both digests with their throughput
+ *      5. Disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_Digest
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_Digest [file]
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_Digest
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_digest_token.cpp ../source/digest_token.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_Digest -I../include -lcrypto
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_digest_token.cpp ..\source\digest_token.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_Digest.exe -I../include -DWIND -lcrypto
+ *
+ * To compare the digest of a file, run the following command
+ * 		sha256sum <file>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\digest_token.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/digest_token.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The function prints given digest in hexadecimal format
+*/
+inline void print_hex(const std::string& digest)
+{
+	const char* hexDigits = "0123456789abcdef";
+	for (size_t i = 0; i < digest.length(); ++i) {
+		cout << hexDigits[(digest[i] >> 4) & 0x0F] << hexDigits[digest[i] & 0x0F];
+	}
+	cout << endl;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	std::string message("This is to test SHA-256 on the token, in a single part and in multiple parts");
+	std::string digest, partsDigest;
+	const size_t partLen = 16;
+	digest_benchmark benchmark;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = digest_data(funclistPtr, hSession, CKM_SHA256, message, digest);
+			if (!retVal) {
+				cout << "\tSingle part digest (hex) :: ";
+				print_hex(digest);
+				retVal = digest_init(funclistPtr, hSession, CKM_SHA256);
+				for (size_t offset = 0; !retVal && offset < message.length(); offset += partLen) {
+					size_t len = message.length() - offset < partLen ? message.length() - offset : partLen;
+					retVal = digest_update(funclistPtr, hSession, reinterpret_cast<CK_BYTE_PTR>(&message[offset]), len);
+				}
+				if (!retVal) {
+					retVal = digest_final(funclistPtr, hSession, CKM_SHA256, partsDigest);
+				}
+			}
+			if (!retVal) {
+				if (digest == partsDigest) {
+					cout << "\tMultiple part digest is the same as single part digest\n";
+				}
+				else {
+					cout << "Error, multiple part digest is not the same as single part digest\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal && argc > 1) {
+				retVal = digest_file_benchmark(funclistPtr, hSession, CKM_SHA256, argv[1], benchmark);
+				if (!retVal) {
+					cout << "\t" << argv[1] << " :: " << benchmark.fileSize << " bytes\n"
+						 << "\tToken digest (hex) :: ";
+					print_hex(benchmark.tokenDigest);
+					cout << "\tHost digest (hex)  :: ";
+					print_hex(benchmark.hostDigest);
+					cout << "\tToken :: " << benchmark.tokenMiBps << " MiB/s, host :: " << benchmark.hostMiBps << " MiB/s\n";
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,127 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an AES 256-bit key (token object) and write a test file of 3 MiB and 5 bytes
+ *      4. Encrypt and decrypt the test file in 1 MiB chunks, and compare the decrypted file
+ *      with the test file
+ *      5. Remove the files and disconnect from a connect slot
+ *
+ * The size of the test file is not a multiple of the chunk size, so the last chunk is partial.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_FileCrypt
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_FileCrypt
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_FileCrypt
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_file_crypt.cpp ../source/file_crypt.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_FileCrypt -I../include
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "../header/basic_operation.hpp"
+#include "../header/conn_dis_token.hpp"
+#include "../header/gen_AES_keys.hpp"
+#include "../header/file_crypt.hpp"
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function reads the whole file of given path, which is small enough for the test
+*/
+inline std::string read_whole_file(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	void *libHandle = nullptr;
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	const size_t chunkSz = 1 << 20;
+	const std::string plainPath("test_file_crypt.plain");
+	const std::string encPath("test_file_crypt.enc");
+	const std::string decPath("test_file_crypt.dec");
+	std::string plain(3 * chunkSz + 5, '\0');
+	file_crypt_stats stats;
+
+	for (size_t i = 0; i < plain.length(); ++i) {
+		plain[i] = static_cast<char>(i * 31 + i / 4096);
+	}
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_AES_key(funclistPtr, hSession, &hKey, keyLen, "AES 256-bit key (file)");
+			if (!retVal) {
+				std::ofstream plainFile(plainPath, std::ios::binary | std::ios::trunc);
+				if (!plainFile.write(plain.data(), plain.length())) {
+					cout << "Error, " << plainPath << " cannot be written\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				retVal = encrypt_file(funclistPtr, hSession, hKey, plainPath, encPath, stats, chunkSz);
+			}
+			if (!retVal) {
+				cout << "\tEncrypted " << stats.bytesIn << " bytes in " << stats.chunkCount << " chunks, "
+					 << stats.MiBps << " MiB/s\n";
+				retVal = decrypt_file(funclistPtr, hSession, hKey, encPath, decPath, stats, chunkSz);
+			}
+			if (!retVal) {
+				cout << "\tDecrypted " << stats.bytesIn << " bytes in " << stats.chunkCount << " chunks, "
+					 << stats.MiBps << " MiB/s\n";
+				if (read_whole_file(decPath) == plain) {
+					cout << "\tDecrypted file is the same as the test file\n";
+				}
+				else {
+					cout << "Error, decrypted file is not the same as the test file\n";
+					retVal = 1;
+				}
+			}
+			std::remove(plainPath.c_str());
+			std::remove(encPath.c_str());
+			std::remove(decPath.c_str());
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,110 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Start an asynchronous executor of 4 worker threads, each owning its own session
+ *      4. Generate 100 AES 256-bit keys (token objects) across the worker sessions, named
+ *      "tenant-000000", "tenant-000001", ... and print the progress
+ *      5. Stop the executor and destroy the generated keys
+ *      6. Disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_BulkAES
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_BulkAES
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_BulkAES
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_gen_AES_keys_bulk.cpp ../source/gen_AES_keys_bulk.cpp ../source/async_operation.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_BulkAES -I../include -pthread
+ *
+ * Using p11tool to see the generated keys on token before they are destroyed, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --login --list-all <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_AES_keys_bulk.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_AES_keys_bulk.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	const CK_ULONG keyLen = 32;       // byte-length
+	const size_t keyCount = 100;
+	std::vector<CK_OBJECT_HANDLE> hKeys;
+	key_name_pattern pattern;
+
+	pattern.labelPrefix = "tenant-";
+	pattern.idPrefix = "tenant-id-";
+	pattern.width = 6;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			async_executor executor;
+			retVal = executor.start(funclistPtr, hSession, 4);
+			if (!retVal) {
+				cout << "\tExecutor started with " << executor.worker_count() << " worker threads\n";
+				// The progress is reported on this thread while the worker threads generate the keys
+				retVal = gen_AES_keys_bulk(executor, keyLen, pattern, keyCount, hKeys, [](size_t done, size_t total) {
+					cout << "\t" << done << " of " << total << " keys generated\n";
+				});
+				if (!retVal) {
+					cout << "\t" << keyCount << " AES keys successfully generated, from "
+						 << key_name(pattern.labelPrefix, pattern.width, 0) << " to "
+						 << key_name(pattern.labelPrefix, pattern.width, keyCount - 1) << endl;
+				}
+				executor.stop();
+			}
+			// The keys are token objects, so they are destroyed to keep the token clean
+			for (size_t i = 0; i < hKeys.size(); ++i) {
+				if (hKeys[i] != CK_INVALID_HANDLE) {
+					check_operation(funclistPtr->C_DestroyObject(hSession, hKeys[i]), "C_DestroyObject()");
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -77,7 +77,7 @@ int main()
 	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
 	CK_SESSION_HANDLE hSession = 0; 
 	std::string usrPIN;
-	size_t modBitLen = 0;
+	CK_ULONG modBitLen = 0;
     
     /**
      * 
@@ -0,0 +1,113 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an RSA 2048-bit key pair on the token
+ *      4. Encrypt messages on the host with RSA OAEP, where the public key is read from the
+ *      token only once and cached
+ *      5. Decrypt the ciphertexts on the token with the private key and compare them
+ *      6. Invalidate the cached public key and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_HostRSAOAEP
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_HostRSAOAEP
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_HostRSAOAEP
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_host_encrypt_RSA_OAEP.cpp ../source/host_encrypt_RSA_OAEP.cpp ../source/RSA_OAEP_enc_dec.cpp ../source/secure_pool.cpp ../source/gen_RSA_keypair.cpp ../source/object_attributes.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_HostRSAOAEP -I../include -lcrypto
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_host_encrypt_RSA_OAEP.cpp ..\source\host_encrypt_RSA_OAEP.cpp ..\source\RSA_OAEP_enc_dec.cpp ..\source\secure_pool.cpp ..\source\gen_RSA_keypair.cpp ..\source\object_attributes.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_HostRSAOAEP.exe -I../include -DWIND -lcrypto
+ *
+ * To delete the generated key pair, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_RSA_keypair.hpp"
+	#include "..\header\RSA_OAEP_enc_dec.hpp"
+	#include "..\header\host_encrypt_RSA_OAEP.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_RSA_keypair.hpp"
+	#include "../header/RSA_OAEP_enc_dec.hpp"
+	#include "../header/host_encrypt_RSA_OAEP.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+
+	CK_OBJECT_HANDLE hPublic = 0;   // Public key handle
+	CK_OBJECT_HANDLE hPrivate = 0;  // Private key handle
+	const CK_ULONG modBitLen = 2048;
+	CK_BYTE pubExpn[] = {0x01, 0x00, 0x01};  // value = 65537;
+	const size_t messageCount = 8;
+	std::string plaintext("This is to test the host RSA OAEP encryption, message #0");
+	std::string ciphertext, decrypted;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			// The parameters are the same as the ones of decrypt_ciphertext() i.e., SHA-1 and MGF1 SHA-1
+			host_rsa_encryptor encryptor(funclistPtr, default_OAEP_params());
+			retVal = gen_RSA_keypair(funclistPtr, hSession, modBitLen, pubExpn, sizeof(pubExpn), &hPublic, &hPrivate);
+			for (size_t i = 0; !retVal && i < messageCount; ++i) {
+				plaintext[plaintext.length() - 1] = '0' + i;
+				// Only the first encryption reads the public key from the token
+				retVal = encryptor.encrypt(hSession, hPublic, plaintext, ciphertext);
+				if (!retVal) {
+					retVal = decrypt_ciphertext(funclistPtr, hSession, hPrivate, ciphertext, decrypted);
+				}
+				if (!retVal && decrypted != plaintext) {
+					cout << "Error, decrypted message #" << i << " does not match\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				cout << "\t" << messageCount << " messages encrypted on the host and decrypted on the token\n";
+			}
+			// The cached key should not outlive the key pair
+			encryptor.invalidate(hPublic);
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,119 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an ECDSA key pair on prime256v1 and sign data on the token
+ *      4. Verify the signature on the host several times, where the public key is read from
+ *      the token only once and cached
+ *      5. Verify a tampered signature on the host, which should fail
+ *      6. Invalidate the cached public key and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_HostECDSA
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_HostECDSA
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_HostECDSA
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_host_verify_ECDSA.cpp ../source/host_verify_ECDSA.cpp ../source/sign_verify_ECDSA.cpp ../source/object_attributes.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_HostECDSA -I../include -lcrypto
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_host_verify_ECDSA.cpp ..\source\host_verify_ECDSA.cpp ..\source\sign_verify_ECDSA.cpp ..\source\object_attributes.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_HostECDSA.exe -I../include -DWIND -lcrypto
+ *
+ * To delete the generated key pair, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\sign_verify_ECDSA.hpp"
+	#include "..\header\host_verify_ECDSA.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/sign_verify_ECDSA.hpp"
+	#include "../header/host_verify_ECDSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+
+	CK_OBJECT_HANDLE hPublic = 0;   // Public key handle
+	CK_OBJECT_HANDLE hPrivate = 0;  // Private key handle
+	// prime256v1 i.e., OID 1.2.840.10045.3.1.7
+	CK_BYTE ecPara[] = {0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07};
+	CK_BYTE sig[64];                // r || s of prime256v1
+	CK_BYTE data[] = "This data is for testing only";
+	CK_ULONG dataLen = sizeof(data) - 1;    // Excluding the null character
+	const size_t verifyCount = 100;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			host_ecdsa_verifier verifier(funclistPtr);
+			retVal = gen_ECDSA_keypair(funclistPtr, hSession, ecPara, sizeof(ecPara), &hPublic, &hPrivate);
+			if (!retVal) {
+				retVal = sign_data_no_hashing(funclistPtr, hSession, hPrivate, data, dataLen, sig, sizeof(sig));
+			}
+			if (!retVal) {
+				cout << "\tSignature produced on the token\n";
+				// Only the first verification reads the public key from the token
+				for (size_t i = 0; !retVal && i < verifyCount; ++i) {
+					retVal = verifier.verify(hSession, hPublic, data, dataLen, sig, sizeof(sig));
+				}
+				if (!retVal) {
+					cout << "\tSignature correctly verified " << verifyCount << " times on the host\n";
+					// Changing one byte of signature only
+					sig[0] ^= 0xFF;
+					if (verifier.verify(hSession, hPublic, data, dataLen, sig, sizeof(sig))) {
+						cout << "\tTampered signature rejected on the host\n";
+					}
+					else {
+						cout << "Error, tampered signature verified\n";
+						retVal = 1;
+					}
+				}
+				// The cached key should not outlive the key pair
+				verifier.invalidate(hPublic);
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	dataLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,122 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an AES 256-bit key (token object) and write a test file of 3 MiB and 5 bytes
+ *      4. For both I/O backends i.e., pread/pwrite and io_uring, encrypt and decrypt the test file
+ *      and compare the decrypted file with the test file
+ *      5. Compare the throughput of both backends for chunks of 256 KiB and 1 MiB
+ *      6. Remove the files and disconnect from a connect slot
+ *
+ * If io_uring is not available e.g., an old kernel or a container forbidding it, then the
+ * pread/pwrite backend is used in its place.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_IOBackend
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_IOBackend
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_IOBackend
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_io_backend.cpp ../source/io_backend.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_IOBackend -I../include
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "../header/basic_operation.hpp"
+#include "../header/conn_dis_token.hpp"
+#include "../header/gen_AES_keys.hpp"
+#include "../header/io_backend.hpp"
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	void *libHandle = nullptr;
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	const std::string plainPath("test_io_backend.plain");
+	const std::string encPath("test_io_backend.enc");
+	const std::string decPath("test_io_backend.dec");
+	std::string plain(3 * IO_CHUNK_SIZE + 5, '\0');
+	const io_backend_type types[] = {IO_BACKEND_PREAD, IO_BACKEND_URING};
+	const std::vector<size_t> chunkSizes = {256 << 10, 1 << 20};
+	io_stream_stats stats;
+
+	for (size_t i = 0; i < plain.length(); ++i) {
+		plain[i] = static_cast<char>(i * 31 + i / 4096);
+	}
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_AES_key(funclistPtr, hSession, &hKey, keyLen, "AES 256-bit key (I/O backend)");
+			if (!retVal) {
+				std::ofstream plainFile(plainPath, std::ios::binary | std::ios::trunc);
+				if (!plainFile.write(plain.data(), plain.length())) {
+					cout << "Error, " << plainPath << " cannot be written\n";
+					retVal = 1;
+				}
+			}
+			for (size_t i = 0; !retVal && i < sizeof(types) / sizeof(types[0]); ++i) {
+				retVal = encrypt_file_io(funclistPtr, hSession, hKey, plainPath, encPath, types[i], stats);
+				if (!retVal) {
+					cout << "\t" << stats.backend << " :: encrypted " << stats.bytesIn << " bytes in "
+						 << stats.submitCount << " submits, " << stats.MiBps << " MiB/s\n";
+					retVal = decrypt_file_io(funclistPtr, hSession, hKey, encPath, decPath, types[i], stats);
+				}
+				if (!retVal) {
+					cout << "\t" << stats.backend << " :: decrypted " << stats.bytesIn << " bytes in "
+						 << stats.submitCount << " submits, " << stats.MiBps << " MiB/s\n";
+					std::ifstream decFile(decPath, std::ios::binary);
+					if (std::string(std::istreambuf_iterator<char>(decFile), std::istreambuf_iterator<char>()) != plain) {
+						cout << "Error, decrypted file is not the same as the test file\n";
+						retVal = 1;
+					}
+				}
+			}
+			if (!retVal) {
+				cout << "\tDecrypted files of both backends are the same as the test file\n";
+				retVal = benchmark_io_backends(funclistPtr, hSession, hKey, plainPath, chunkSizes);
+			}
+			std::remove(plainPath.c_str());
+			std::remove(encPath.c_str());
+			std::remove(decPath.c_str());
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,120 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot, which acquires the login state of its token
+ *      3. Open more sessions on the same slot and acquire the login state for each of them, where
+ *          i.      C_Login() is not called again, only the references are counted
+ *          ii.     every session is in the user functions state
+ *      4. Release the login state and close the extra sessions, where C_Logout() is not called
+ *      5. Disconnect from a connect slot, which releases the last reference and logs out
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_LoginMngr
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_LoginMngr
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_LoginMngr
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_login_manager.cpp ../source/login_manager.cpp ../source/conn_dis_token.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_LoginMngr -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_login_manager.cpp ..\source\login_manager.cpp ..\source\conn_dis_token.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_LoginMngr.exe -I../include -DWIND
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\login_manager.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/login_manager.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_SESSION_INFO sessionInfo = {};
+	const size_t extraCount = 3;
+	std::vector<CK_SESSION_HANDLE> extraSessions;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()");
+			const CK_SLOT_ID slotID = sessionInfo.slotID;
+			for (size_t i = 0; !retVal && i < extraCount; ++i) {
+				CK_SESSION_HANDLE hExtra = 0;
+				retVal = check_operation(funclistPtr->C_OpenSession(slotID, CKF_SERIAL_SESSION | CKF_RW_SESSION,
+																	NULL_PTR, NULL_PTR, &hExtra), "C_OpenSession()");
+				if (!retVal) {
+					// The token is already logged in, so only the reference is counted
+					retVal = application_login().acquire(funclistPtr, slotID, hExtra, usrPIN);
+					if (retVal) {
+						check_operation(funclistPtr->C_CloseSession(hExtra), "C_CloseSession()");
+					}
+					else {
+						extraSessions.push_back(hExtra);
+					}
+				}
+			}
+			if (!retVal) {
+				cout << "\t" << application_login().references(funclistPtr, slotID)
+					 << " sessions share the login state of slot ID " << slotID << endl;
+				for (size_t i = 0; !retVal && i < extraSessions.size(); ++i) {
+					retVal = check_operation(funclistPtr->C_GetSessionInfo(extraSessions[i], &sessionInfo),
+											 "C_GetSessionInfo()");
+					if (!retVal) {
+						cout << "\tSession " << extraSessions[i] << " :: "
+							 << (sessionInfo.state == CKS_RW_USER_FUNCTIONS ? "logged in" : "not logged in") << endl;
+					}
+				}
+			}
+			for (size_t i = 0; i < extraSessions.size(); ++i) {
+				// C_Logout() is not called while the connected session holds a reference
+				application_login().release(funclistPtr, slotID, extraSessions[i]);
+				check_operation(funclistPtr->C_CloseSession(extraSessions[i]), "C_CloseSession()");
+			}
+			cout << "\t" << application_login().references(funclistPtr, slotID)
+				 << " sessions share the login state after releasing the extra sessions\n";
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,131 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot, which builds the mechanism cache of its token
+ *      3. Look up the mechanism cache of the connected session, and print
+ *          i.      whether the mechanisms of this demonstration are supported, with their key sizes
+ *          ii.     the preferred signature mechanism selected among several
+ *      4. Disconnect from a connect slot, which forgets the mechanism cache
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_MechCache
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_MechCache
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_MechCache
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_mechanism_cache.cpp ../source/mechanism_cache.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_MechCache -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_mechanism_cache.cpp ..\source\mechanism_cache.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_MechCache.exe -I../include -DWIND
+ *
+ * To see the mechanisms of a token with their flags, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --list-mechanisms <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\mechanism_cache.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/mechanism_cache.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The mechanisms of this demonstration, with their names
+*/
+struct named_mechanism
+{
+	CK_MECHANISM_TYPE mechType;
+	const char* name;
+};
+
+const named_mechanism DEMO_MECHANISMS[] = {
+	{CKM_AES_KEY_GEN, "CKM_AES_KEY_GEN"},
+	{CKM_AES_CBC_PAD, "CKM_AES_CBC_PAD"},
+	{CKM_AES_GCM, "CKM_AES_GCM"},
+	{CKM_RSA_PKCS_KEY_PAIR_GEN, "CKM_RSA_PKCS_KEY_PAIR_GEN"},
+	{CKM_RSA_PKCS_OAEP, "CKM_RSA_PKCS_OAEP"},
+	{CKM_EC_KEY_PAIR_GEN, "CKM_EC_KEY_PAIR_GEN"},
+	{CKM_ECDSA, "CKM_ECDSA"},
+	{CKM_ECDH1_DERIVE, "CKM_ECDH1_DERIVE"},
+	{CKM_SHA256_HMAC, "CKM_SHA256_HMAC"},
+	{CKM_SHA256, "CKM_SHA256"}
+};
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_MECHANISM_INFO mechInfo;
+	const std::vector<CK_MECHANISM_TYPE> sigPreferred = {CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS, CKM_ECDSA};
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			// The cache was built by connect_slot(), so the token is not asked again
+			std::shared_ptr<const mechanism_cache> cache = application_mechanisms().lookup_session(funclistPtr, hSession);
+			if (!cache) {
+				cout << "Error, no mechanism cache for the connected slot\n";
+				retVal = 1;
+			}
+			else {
+				cout << "\tThe token supports " << cache->size() << " mechanisms\n";
+				for (size_t i = 0; i < sizeof(DEMO_MECHANISMS) / sizeof(DEMO_MECHANISMS[0]); ++i) {
+					cout << "\t" << DEMO_MECHANISMS[i].name << " :: ";
+					if (cache->info(DEMO_MECHANISMS[i].mechType, mechInfo)) {
+						cout << "supported, key size " << mechInfo.ulMinKeySize << " to " << mechInfo.ulMaxKeySize << endl;
+					}
+					else {
+						cout << "not supported\n";
+					}
+				}
+				CK_MECHANISM_TYPE sigMech = cache->select(sigPreferred, CKF_SIGN);
+				if (sigMech == CK_UNAVAILABLE_INFORMATION) {
+					cout << "\tNone of the preferred signature mechanisms is supported\n";
+				}
+				else {
+					cout << "\tPreferred signature mechanism selected :: 0x" << std::hex << sigMech << std::dec << endl;
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
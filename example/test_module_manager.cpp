@@ -0,0 +1,90 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load several HSM libraries (modules) listed in given configuration file, or otherwise in
+ *      the environment variable SOFTHSM2_LIBS, where the paths are separated by colon
+ *      2. Print the unified slot namespace i.e., every slot of every module
+ *      3. If a key label is given, add every slot holding that secret key to the slot dispatcher
+ *      4. Finalize and unload all libraries
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_ModMngr
+ *
+ * If Makefile was used to build, then to execute the program, run the following commands
+ *      ./test_ModMngr [configuration file] [key label]
+ *      export SOFTHSM2_LIBS=/opt/softhsm2-a/lib/libsofthsm2.so:/opt/softhsm2-b/lib/libsofthsm2.so
+ *      ./test_ModMngr
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_ModMngr
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_module_manager.cpp ../source/module_manager.cpp ../source/slot_dispatcher.cpp ../source/async_operation.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_ModMngr -I../include -pthread
+ *
+ * The configuration file has one library per line followed by optional environment variables
+ *      /opt/softhsm2-a/lib/libsofthsm2.so  SOFTHSM2_CONF=/disk1/softhsm2.conf
+ *      /opt/softhsm2-b/lib/libsofthsm2.so  SOFTHSM2_CONF=/disk2/softhsm2.conf
+ *
+ * To generate an AES key on a token, one can run test_AESKeys, where the label is e.g., "AES 256-bit key"
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\module_manager.hpp"
+#else
+	#include "../header/module_manager.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+using std::cin;
+
+
+
+int main(int argc, char* argv[])
+{
+	int retVal = 0;
+	module_manager manager;
+	std::string usrPIN;
+
+	if (argc > 1) {
+		retVal = manager.load_config(argv[1]);
+	}
+	else {
+		retVal = manager.load_env("SOFTHSM2_LIBS");
+	}
+	if (!retVal) {
+		cout << manager.module_count() << " HSM PKCS #11 libraries loaded successfully\n";
+		for (size_t i = 0; i < manager.slot_count(); ++i) {
+			const unified_slot& slot = manager.slot(i);
+			cout << "\tUnified slot " << i << " :: " << manager.module(slot.moduleIndex).libPath
+				 << ", slot ID " << slot.slotID << endl;
+		}
+
+		if (argc > 2) {
+			slot_dispatcher dispatcher;
+			key_selector selector;
+			selector.label = argv[2];
+			selector.keyClass = CKO_SECRET_KEY;
+
+			cout << "\tPlease enter the User PIN: ";
+			cin >> usrPIN;
+			retVal = add_module_slots(manager, dispatcher, selector, usrPIN, 1);
+			if (!retVal) {
+				cout << "\t" << dispatcher.slot_count() << " slots hold the secret key \"" << selector.label << "\"\n";
+			}
+			dispatcher.stop();
+		}
+	}
+	manager.unload_all();
+	usrPIN.clear();
+
+	return retVal;
+}
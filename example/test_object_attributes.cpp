@@ -0,0 +1,139 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Find every object visible to the session
+ *      4. Read CKA_CLASS, CKA_LABEL and CKA_ID of all objects in batches from one arena, and print them
+ *      5. Disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_ObjAttr
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_ObjAttr
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_ObjAttr
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_object_attributes.cpp ../source/object_attributes.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_ObjAttr -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_object_attributes.cpp ..\source\object_attributes.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_ObjAttr.exe -I../include -DWIND
+ *
+ * To generate objects on token, one can run test_AESKeys or test_RSAKeypair
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\object_attributes.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/object_attributes.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function finds the handles of every object visible to given session
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int find_all_objects(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						std::vector<CK_OBJECT_HANDLE>& hObjects)
+{
+	CK_OBJECT_HANDLE found[64];
+	CK_ULONG foundCount = 0;
+	int retVal = 0;
+
+	// An empty template matches every object
+	if (check_operation(funclistPtr->C_FindObjectsInit(hSession, NULL_PTR, 0), "C_FindObjectsInit()")) {
+		return 1;
+	}
+	do {
+		retVal = check_operation(funclistPtr->C_FindObjects(hSession, found, sizeof(found) / sizeof(CK_OBJECT_HANDLE),
+															&foundCount), "C_FindObjects()");
+		if (!retVal) {
+			hObjects.insert(hObjects.end(), found, found + foundCount);
+		}
+	} while (!retVal && foundCount);
+	check_operation(funclistPtr->C_FindObjectsFinal(hSession), "C_FindObjectsFinal()");
+	return retVal;
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	std::vector<CK_OBJECT_HANDLE> hObjects;
+	const std::vector<CK_ATTRIBUTE_TYPE> types = {CKA_CLASS, CKA_LABEL, CKA_ID};
+	std::vector<object_attributes> results;
+	attribute_arena arena;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = find_all_objects(funclistPtr, hSession, hObjects);
+			if (!retVal) {
+				cout << "\t" << hObjects.size() << " objects found\n";
+				retVal = read_attributes(funclistPtr, hSession, hObjects, types, arena, results);
+			}
+			if (!retVal) {
+				for (size_t i = 0; i < results.size(); ++i) {
+					if (!results[i].valid) {
+						cout << "\tObject " << results[i].hObject << " :: not readable\n";
+						continue;
+					}
+					const CK_ATTRIBUTE* classAttrb = results[i].find(CKA_CLASS);
+					const CK_ATTRIBUTE* labelAttrb = results[i].find(CKA_LABEL);
+					cout << "\tObject " << results[i].hObject << " :: class ";
+					if (classAttrb && classAttrb->ulValueLen == sizeof(CK_OBJECT_CLASS)) {
+						cout << *static_cast<CK_OBJECT_CLASS*>(classAttrb->pValue);
+					}
+					cout << ", label ";
+					if (labelAttrb && labelAttrb->ulValueLen != CK_UNAVAILABLE_INFORMATION) {
+						cout << std::string(static_cast<const char*>(labelAttrb->pValue), labelAttrb->ulValueLen);
+					}
+					cout << endl;
+				}
+				cout << "\t" << arena.used() << " bytes of the arena used\n";
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
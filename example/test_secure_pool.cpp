@@ -0,0 +1,261 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Allocate a block of every size class, check that it is zeroed and that a released block
+ *      is zeroized before it is given again
+ *      2. Allocate blocks on one thread and release them on another thread, in both directions, so
+ *      the blocks go back to the pool through the cache of another thread
+ *      3. Allocate and release a buffer larger than the size classes, which is mapped on its own,
+ *      and release it a second time, which should be rejected without changing the statistics
+ *      4. Hold data in secure_bytes and secure_string, and zeroize the string by secure_wipe()
+ *      5. Check the statistics of the pool after every step
+ *
+ * The HSM library is not used in this program.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_SecurePool
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_SecurePool
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_SecurePool
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_secure_pool.cpp ../source/secure_pool.cpp -o test_SecurePool -I../include -pthread
+ *
+ * Note that locking may be limited by RLIMIT_MEMLOCK, which can be seen by running the following command
+ *      ulimit -l
+ *
+*/
+
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\secure_pool.hpp"
+#else
+	#include "../header/secure_pool.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function checks whether given memory is all zero
+*/
+bool is_zeroed(const void* ptr, const size_t len)
+{
+	const CK_BYTE* bytePtr = static_cast<const CK_BYTE*>(ptr);
+
+	for (size_t i = 0; i < len; ++i) {
+		if (bytePtr[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+/**
+ * The function allocates a block of every size class, fills it, releases it and allocates it again
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int size_classes(secure_pool& pool)
+{
+	for (size_t i = 0; i < SECURE_CLASS_COUNT; ++i) {
+		const size_t len = SECURE_SIZE_CLASSES[i];
+		void* ptr = pool.allocate(len);
+		if (!ptr || !is_zeroed(ptr, len)) {
+			cout << "Error, block of " << len << " bytes is not allocated zeroed\n";
+			return 1;
+		}
+		std::fill_n(static_cast<CK_BYTE_PTR>(ptr), len, 0xA5);
+		pool.deallocate(ptr, len);
+		// The block released last is the first one given by the cache of the thread
+		ptr = pool.allocate(len);
+		if (!ptr || !is_zeroed(ptr, len)) {
+			cout << "Error, block of " << len << " bytes is not zeroized on release\n";
+			return 1;
+		}
+		pool.deallocate(ptr, len);
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function allocates blocks on one thread and releases them on another thread, in both directions.
+ * More blocks than two batches are released, so the cache of the releasing thread gives a batch back
+ * to the pool, and the rest when the thread ends.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int cross_thread(secure_pool& pool)
+{
+	const size_t len = 64;
+	const size_t blockCount = 3 * SECURE_CACHE_BATCH;
+	std::vector<void*> blocks(blockCount, NULL_PTR);
+	int retVal = 0;
+
+	for (size_t i = 0; i < blockCount; ++i) {
+		blocks[i] = pool.allocate(len);
+		if (!blocks[i]) {
+			cout << "Error, block " << i << " is not allocated\n";
+			retVal = 1;
+		}
+	}
+	std::thread releaser([&]() {
+		for (size_t i = 0; i < blockCount; ++i) {
+			pool.deallocate(blocks[i], len);
+		}
+	});
+	releaser.join();
+
+	std::thread allocator([&]() {
+		for (size_t i = 0; i < blockCount; ++i) {
+			blocks[i] = pool.allocate(len);
+			if (!blocks[i] || !is_zeroed(blocks[i], len)) {
+				cout << "Error, block " << i << " is not allocated zeroed on another thread\n";
+				retVal = 1;
+			}
+		}
+	});
+	allocator.join();
+	for (size_t i = 0; i < blockCount; ++i) {
+		pool.deallocate(blocks[i], len);
+	}
+	return retVal;
+}
+
+
+
+/**
+ * The function allocates and releases a buffer larger than the size classes, then releases it again
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int large_block(secure_pool& pool)
+{
+	const size_t pageSz = sysconf(_SC_PAGESIZE);
+	const size_t len = SECURE_SIZE_CLASSES[SECURE_CLASS_COUNT - 1] + 1;
+	const size_t mappedLen = (len + pageSz - 1) / pageSz * pageSz;
+	secure_pool_stats before = pool.stats();
+	secure_pool_stats after;
+
+	void* ptr = pool.allocate(len);
+	if (!ptr || !is_zeroed(ptr, len)) {
+		cout << "Error, large block of " << len << " bytes is not allocated zeroed\n";
+		return 1;
+	}
+	after = pool.stats();
+	if (after.largeCount != before.largeCount + 1 || after.largeBytes != before.largeBytes + mappedLen) {
+		cout << "Error, large block is not counted in the statistics\n";
+		return 1;
+	}
+
+	pool.deallocate(ptr, len);
+	after = pool.stats();
+	if (after.largeCount != before.largeCount || after.largeBytes != before.largeBytes
+		|| after.lockedBytes != before.lockedBytes) {
+		cout << "Error, released large block is still counted in the statistics\n";
+		return 1;
+	}
+
+	cout << "\tReleasing the large block again, an error is expected\n";
+	pool.deallocate(ptr, len);
+	after = pool.stats();
+	if (after.largeCount != before.largeCount || after.largeBytes != before.largeBytes
+		|| after.lockedBytes != before.lockedBytes) {
+		cout << "Error, large block released twice changed the statistics\n";
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function holds data in the containers of the pool and zeroizes the string
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int containers()
+{
+	secure_bytes key(32, 0x5A);
+	secure_string pin("a PIN longer than the short-string buffer of std::string");
+
+	key.resize(300);
+	pin += pin;
+	secure_wipe(pin);
+	if (!pin.empty() || !is_zeroed(pin.data(), pin.capacity())) {
+		cout << "Error, secure_wipe() did not zeroize the string\n";
+		return 1;
+	}
+	return key.size() == 300 && key[0] == 0x5A ? 0 : 1;
+}
+
+
+
+/**
+ * The function prints the statistics of the pool
+*/
+void print_stats(secure_pool& pool)
+{
+	secure_pool_stats stats = pool.stats();
+
+	cout << "\t\tslabs: " << stats.slabCount << " (" << stats.slabBytes << " bytes), large: " << stats.largeCount
+		 << " (" << stats.largeBytes << " bytes), locked: " << stats.lockedBytes << " bytes, refills: "
+		 << stats.refillCount << endl;
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	secure_pool& pool = application_secure_pool();
+	secure_pool_stats stats;
+
+	if (!(retVal = size_classes(pool))) {
+		cout << "\tBlocks of " << SECURE_CLASS_COUNT << " size classes are allocated zeroed and zeroized on release\n";
+		print_stats(pool);
+		stats = pool.stats();
+		if (stats.slabCount < SECURE_CLASS_COUNT || stats.slabBytes != stats.slabCount * SECURE_SLAB_SIZE
+			|| !stats.refillCount) {
+			cout << "Error, statistics do not count a slab of every size class\n";
+			retVal = 1;
+		}
+	}
+	if (!retVal && !(retVal = cross_thread(pool))) {
+		cout << "\tBlocks are released and allocated on threads other than their own\n";
+		print_stats(pool);
+	}
+	if (!retVal && !(retVal = large_block(pool))) {
+		cout << "\tLarge block is mapped on its own and unmapped once\n";
+		print_stats(pool);
+	}
+	if (!retVal && !(retVal = containers())) {
+		cout << "\tsecure_bytes and secure_string are held in the pool\n";
+		print_stats(pool);
+	}
+	stats = pool.stats();
+	if (!retVal && stats.lockedBytes > stats.slabBytes + stats.largeBytes) {
+		cout << "Error, more bytes are locked than mapped\n";
+		retVal = 1;
+	}
+
+	return retVal;
+}
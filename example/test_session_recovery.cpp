@@ -0,0 +1,117 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Open a recoverable session on the same slot, which logs in with the cached User PIN
+ *      4. Perform operations on the recoverable session, where
+ *          i.      generating random bytes is idempotent, so it is retried if the session is lost
+ *          ii.     generating an AES 256-bit key (token object) is not idempotent, so it is not retried
+ *      5. Close the recoverable session and disconnect from a connect slot
+ *
+ * To see a recovery, the token can be reset e.g., by restarting the HSM while the operations are performed.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_SessRecv
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_SessRecv
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_SessRecv
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_session_recovery.cpp ../source/session_recovery.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_SessRecv -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_session_recovery.cpp ..\source\session_recovery.cpp ..\source\gen_AES_keys.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_SessRecv.exe -I../include -DWIND
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_AES_keys.hpp"
+	#include "..\header\session_recovery.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_AES_keys.hpp"
+	#include "../header/session_recovery.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_SESSION_INFO sessionInfo;
+	CK_ULONG keyLen = 32;       // byte-length
+	CK_OBJECT_HANDLE hKey = 0;
+	CK_BYTE randBytes[16];
+	const std::string keyLabel("AES 256-bit key (recoverable session)");
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()");
+			if (!retVal) {
+				// The User PIN already entered is the credential, it is cached by the session for re-login
+				recoverable_session session(funclistPtr, sessionInfo.slotID, [&usrPIN](std::string& pin) {
+					pin = usrPIN;
+					return 0;
+				}, 3);
+				retVal = session.open();
+				if (!retVal) {
+					cout << "\tRecoverable session opened successfully\n";
+					retVal = session.run([funclistPtr, &randBytes](CK_SESSION_HANDLE& hRecoverable) {
+						return check_operation(funclistPtr->C_GenerateRandom(hRecoverable, randBytes, sizeof(randBytes)),
+											   "C_GenerateRandom()");
+					}, true);
+				}
+				if (!retVal) {
+					cout << "\t" << sizeof(randBytes) << " random bytes successfully generated\n";
+					retVal = run_recoverable(session, funclistPtr, false, gen_AES_key, &hKey, keyLen, keyLabel);
+				}
+				if (!retVal) {
+					cout << "\t" << keyLabel << " successfully generated\n";
+				}
+				session.close();
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,140 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Select the Edwards curve i.e., Ed25519 or Ed448, from the mechanism cache of the token
+ *      4. Generate an EdDSA key pair, sign a message and verify the signature
+ *      5. Verify a tampered signature, which should fail
+ *      6. Sign and verify 32 messages across the worker sessions of an asynchronous executor
+ *      7. Stop the executor and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_EdDSA
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_EdDSA
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_EdDSA
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_sign_verify_EdDSA.cpp ../source/sign_verify_EdDSA.cpp ../source/async_operation.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_EdDSA -I../include -pthread
+ *
+ * Note that SoftHSM supports EdDSA (CKM_EDDSA) only if it was built with OpenSSL 1.1.1 or later
+ *
+ * To delete the generated key pair, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\sign_verify_EdDSA.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/sign_verify_EdDSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	edwards_curve curve = ED25519;
+	CK_OBJECT_HANDLE hPublic = 0;   // Public key handle
+	CK_OBJECT_HANDLE hPrivate = 0;  // Private key handle
+	std::string message("This is to test EdDSA");
+	std::string signature;
+	const size_t batchCount = 32;
+	std::vector<std::string> messages(batchCount, message);
+	std::vector<std::string> signatures;
+	std::vector<int> results;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			std::shared_ptr<const mechanism_cache> cache = application_mechanisms().lookup_session(funclistPtr, hSession);
+			if (!cache) {
+				cout << "Error, no mechanism cache for the connected slot\n";
+				retVal = 1;
+			}
+			else {
+				retVal = select_EdDSA_curve(*cache, curve);
+			}
+			if (!retVal) {
+				cout << "\t" << (curve == ED25519 ? "Ed25519" : "Ed448") << " selected, signature of "
+					 << EdDSA_signature_length(curve) << " bytes\n";
+				retVal = gen_EdDSA_keypair(funclistPtr, hSession, curve, hPublic, hPrivate);
+			}
+			if (!retVal) {
+				retVal = sign_EdDSA(funclistPtr, hSession, hPrivate, curve, message, signature);
+			}
+			if (!retVal) {
+				retVal = verify_EdDSA(funclistPtr, hSession, hPublic, message, signature);
+			}
+			if (!retVal) {
+				cout << "\tSignature correctly verified\n";
+				// Changing one byte of signature only
+				signature[0] ^= 0xFF;
+				if (verify_EdDSA(funclistPtr, hSession, hPublic, message, signature)) {
+					cout << "\tTampered signature rejected\n";
+				}
+				else {
+					cout << "Error, tampered signature verified\n";
+					retVal = 1;
+				}
+			}
+			if (!retVal) {
+				async_executor executor;
+				retVal = executor.start(funclistPtr, hSession, 4);
+				if (!retVal) {
+					for (size_t i = 0; i < batchCount; ++i) {
+						messages[i] += " #" + std::to_string(i);
+					}
+					retVal = sign_EdDSA_batch(executor, hPrivate, curve, messages, signatures);
+					if (!retVal) {
+						retVal = verify_EdDSA_batch(executor, hPublic, messages, signatures, results);
+					}
+					if (!retVal) {
+						cout << "\t" << batchCount << " signatures produced and verified across "
+							 << executor.worker_count() << " worker sessions\n";
+					}
+					executor.stop();
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
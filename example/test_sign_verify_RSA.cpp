@@ -0,0 +1,163 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an RSA 2048-bit key pair on the token
+ *      4. Sign and verify a message with
+ *          i.      CKM_SHA256_RSA_PKCS_PSS in a single part
+ *          ii.     CKM_SHA256_RSA_PKCS in multiple parts
+ *          iii.    CKM_RSA_PKCS_PSS on the SHA-256 digest computed on the host (OpenSSL)
+ *      5. Sign and verify 32 messages across the worker sessions of an asynchronous executor
+ *      6. Stop the executor and disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_RSASign
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_RSASign
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_RSASign
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_sign_verify_RSA.cpp ../source/sign_verify_RSA.cpp ../source/gen_RSA_keypair.cpp ../source/async_operation.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_RSASign -I../include -lcrypto -pthread
+ *
+ * To delete the generated key pair, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <openssl/evp.h>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_RSA_keypair.hpp"
+	#include "..\header\sign_verify_RSA.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_RSA_keypair.hpp"
+	#include "../header/sign_verify_RSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+
+	CK_OBJECT_HANDLE hPublic = 0;   // Public key handle
+	CK_OBJECT_HANDLE hPrivate = 0;  // Private key handle
+	const CK_ULONG modBitLen = 2048;
+	const CK_ULONG modulusLen = modBitLen / 8;
+	CK_BYTE pubExpn[] = {0x01, 0x00, 0x01};  // value = 65537;
+	std::string message("This is to test RSA signatures, with PSS and PKCS #1 v1.5");
+	std::string signature;
+	std::string digest(EVP_MAX_MD_SIZE, '\0');
+	unsigned int digestLen = 0;
+	const size_t partLen = 16;
+	const size_t batchCount = 32;
+	std::vector<std::string> messages(batchCount, message);
+	std::vector<std::string> signatures;
+	std::vector<int> results;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_RSA_keypair(funclistPtr, hSession, modBitLen, pubExpn, sizeof(pubExpn), &hPublic, &hPrivate);
+			if (!retVal) {
+				retVal = sign_RSA(funclistPtr, hSession, hPrivate, CKM_SHA256_RSA_PKCS_PSS, modulusLen, message, signature);
+			}
+			if (!retVal) {
+				retVal = verify_RSA(funclistPtr, hSession, hPublic, CKM_SHA256_RSA_PKCS_PSS, message, signature);
+			}
+			if (!retVal) {
+				cout << "\tRSA-PSS signature correctly verified\n";
+				retVal = sign_RSA_init(funclistPtr, hSession, hPrivate, CKM_SHA256_RSA_PKCS);
+				for (size_t offset = 0; !retVal && offset < message.length(); offset += partLen) {
+					size_t len = message.length() - offset < partLen ? message.length() - offset : partLen;
+					retVal = sign_RSA_update(funclistPtr, hSession, reinterpret_cast<CK_BYTE_PTR>(&message[offset]), len);
+				}
+				if (!retVal) {
+					retVal = sign_RSA_final(funclistPtr, hSession, modulusLen, signature);
+				}
+			}
+			if (!retVal) {
+				retVal = verify_RSA_init(funclistPtr, hSession, hPublic, CKM_SHA256_RSA_PKCS);
+				for (size_t offset = 0; !retVal && offset < message.length(); offset += partLen) {
+					size_t len = message.length() - offset < partLen ? message.length() - offset : partLen;
+					retVal = verify_RSA_update(funclistPtr, hSession, reinterpret_cast<CK_BYTE_PTR>(&message[offset]), len);
+				}
+				if (!retVal) {
+					retVal = verify_RSA_final(funclistPtr, hSession, signature);
+				}
+			}
+			if (!retVal) {
+				cout << "\tPKCS #1 v1.5 signature of multiple parts correctly verified\n";
+				// Only the digest goes to the token
+				if (EVP_Digest(message.data(), message.length(), reinterpret_cast<unsigned char*>(&digest[0]),
+								&digestLen, EVP_sha256(), NULL_PTR) != 1) {
+					cout << "Error, EVP_Digest() failed\n";
+					retVal = 1;
+				}
+				else {
+					digest.resize(digestLen);
+					retVal = sign_RSA_digest(funclistPtr, hSession, hPrivate, CKM_RSA_PKCS_PSS, CKM_SHA256,
+												modulusLen, digest, signature);
+				}
+			}
+			if (!retVal) {
+				retVal = verify_RSA_digest(funclistPtr, hSession, hPublic, CKM_RSA_PKCS_PSS, CKM_SHA256, digest, signature);
+			}
+			if (!retVal) {
+				cout << "\tRSA-PSS signature of the host digest correctly verified\n";
+				async_executor executor;
+				retVal = executor.start(funclistPtr, hSession, 4);
+				if (!retVal) {
+					for (size_t i = 0; i < batchCount; ++i) {
+						messages[i] += " #" + std::to_string(i);
+					}
+					retVal = sign_RSA_batch(executor, hPrivate, CKM_SHA256_RSA_PKCS_PSS, modulusLen, messages, signatures);
+					if (!retVal) {
+						retVal = verify_RSA_batch(executor, hPublic, CKM_SHA256_RSA_PKCS_PSS, messages, signatures, results);
+					}
+					if (!retVal) {
+						cout << "\t" << batchCount << " signatures produced and verified across "
+							 << executor.worker_count() << " worker sessions\n";
+					}
+					executor.stop();
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
@@ -0,0 +1,176 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Generate an AES 256-bit key (token object)
+ *      4. Start the slot dispatcher on every slot holding a key of the same label
+ *      5. Dispatch encryptions to the least-loaded slot, each under a random IV of its own, and wait
+ *      for their results
+ *      6. Stop the dispatcher and disconnect from a connect slot
+ *
+ * The same key can be put on several tokens e.g., by wrapping and unwrapping it, so the dispatcher
+ * spreads the encryptions across them. Otherwise, all of them go to the connected slot.
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_SlotDisp
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_SlotDisp
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_SlotDisp
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_slot_dispatcher.cpp ../source/slot_dispatcher.cpp ../source/async_operation.cpp ../source/gen_AES_keys.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/common_basic_operation.cpp ../source/basic_operation.cpp -o test_SlotDisp -I../include -pthread
+ *
+ * To see the list of slots, run the following command
+ *      softhsm2-util --show-slots
+ *
+ * If a slot has not initialized, then to initialize a token slot, one can run the following commands
+ * 		softhsm2-util --init-token --free --so-pin <so_pin> --pin <user_pin> --label <token_label>
+ * OR
+ *      softhsm2-util --init-token --slot <slot_number> --label <text>
+ *
+ * To delete the generated key, run the following command
+ * 		p11tool --provider </full/path/to/libsofthsm2.so> --delete <TOKEN-URL>
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\gen_AES_keys.hpp"
+	#include "..\header\slot_dispatcher.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/gen_AES_keys.hpp"
+	#include "../header/slot_dispatcher.hpp"
+#endif
+
+// AES uses 128-bit (16-byte) block, which is also the byte-length of the IV
+#define BYTE_LEN 16
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The function encrypts given plaintext using AES CBC i.e., CKM_AES_CBC_PAD, under a random IV of its own,
+ * generated on the session of the slot chosen by the dispatcher. The mechanism of init_Mech() of
+ * AES_enc_dec.hpp is global, so it would give every concurrent encryption the same IV.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hKey is an alias of secret key handle
+ * plaintext is an alias of constant plaintext (source) to be encrypted
+ * IV is an alias of the IV to be returned, which is needed to decrypt the ciphertext
+ * ciphertext is an alias of ciphertext (destination) to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int encrypt_CBC(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hKey,
+				const std::string& plaintext, std::string& IV, std::string& ciphertext)
+{
+	CK_MECHANISM encMech = {CKM_AES_CBC_PAD, NULL_PTR, BYTE_LEN};
+	CK_ULONG ctLen = plaintext.length() + BYTE_LEN;
+
+	IV.assign(BYTE_LEN, '\0');
+	encMech.pParameter = &IV[0];
+	if (check_operation(funclistPtr->C_GenerateRandom(hSession, reinterpret_cast<CK_BYTE_PTR>(&IV[0]), BYTE_LEN),
+						"C_GenerateRandom()")) {
+		return 1;
+	}
+	if (check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hKey), "C_EncryptInit()")) {
+		return 1;
+	}
+	ciphertext.resize(ctLen);
+	if (check_operation(funclistPtr->C_Encrypt(hSession, reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(plaintext.data())),
+												plaintext.length(), reinterpret_cast<CK_BYTE_PTR>(&ciphertext[0]), &ctLen),
+						"C_Encrypt()")) {
+		ciphertext.clear();
+		return 1;
+	}
+	ciphertext.resize(ctLen);
+	return 0;
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+    CK_ULONG keyLen = 32;       // byte-length
+    CK_OBJECT_HANDLE hKey = 0;
+    key_selector selector;
+    const size_t messageCount = 8;
+    std::string plaintext("This is to test the slot dispatcher, message #0");
+    std::vector<std::string> IVs(messageCount);
+    std::vector<std::string> ciphertexts(messageCount);
+
+    selector.label = "AES 256-bit key (dispatcher)";
+    selector.keyClass = CKO_SECRET_KEY;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			retVal = gen_AES_key(funclistPtr, hSession, &hKey, keyLen, selector.label);
+            if (!retVal) {
+                cout << "\t" << selector.label << " successfully generated\n";
+            }
+            if (!retVal) {
+                slot_dispatcher dispatcher;
+                retVal = dispatcher.start(funclistPtr, selector, usrPIN, 2);
+                if (!retVal) {
+                    cout << "\tDispatcher started on " << dispatcher.slot_count() << " slots\n";
+                    std::vector<std::future<int> > results;
+                    for (size_t i = 0; i < messageCount; ++i) {
+                        // The key handle of the slot chosen is passed by the dispatcher
+                        plaintext[plaintext.length() - 1] = '0' + i;
+                        results.push_back(dispatch_operation(dispatcher, encrypt_CBC, plaintext,
+                                                                std::ref(IVs[i]), std::ref(ciphertexts[i])));
+                    }
+                    for (size_t i = 0; i < results.size(); ++i) {
+                        if (results[i].get()) {
+                            retVal = 1;
+                        }
+                    }
+                    if (!retVal) {
+                        cout << "\t" << messageCount << " messages successfully encrypted, each under its own IV\n";
+                    }
+                    dispatcher.stop();
+                }
+            }
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+    keyLen = 0;
+	usrPIN.clear();
+
+	return retVal;
+}
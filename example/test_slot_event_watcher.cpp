@@ -0,0 +1,108 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Start watching the slot events in a background thread, where every event is
+ *          i.      printed by a subscriber
+ *          ii.     applied to a slot inventory i.e., watch_inventory()
+ *      4. Stop watching once Enter is pressed, and print the inventory
+ *      5. Disconnect from a connect slot
+ *
+ * While watching, a token can be added from another terminal to see an event, for example
+ * 		softhsm2-util --init-token --free --so-pin <so_pin> --pin <user_pin> --label <token_label>
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_SlotEvnt
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_SlotEvnt
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_SlotEvnt
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_slot_event_watcher.cpp ../source/slot_event_watcher.cpp ../source/slots_token_list.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_SlotEvnt -I../include -pthread
+ *
+*/
+
+
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\slot_event_watcher.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/slot_event_watcher.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+using std::cin;
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			slot_inventory inventory(funclistPtr, std::chrono::milliseconds(60000));
+			slot_event_watcher watcher(funclistPtr, std::chrono::milliseconds(500));
+
+			// The subscribers are called on the watcher thread
+			watcher.subscribe([](const slot_event& event) {
+				cout << "\tSlot ID " << event.slotID << " :: token "
+					 << (event.tokenPresent ? "inserted" : "removed") << endl;
+			});
+			watch_inventory(watcher, inventory);
+			retVal = inventory.refresh();
+			if (!retVal) {
+				retVal = watcher.start();
+			}
+			if (!retVal) {
+				cout << "\tWatching slot events, press Enter to stop\n";
+				cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+				cin.get();
+				cout << "\tSlot events were watched " << (watcher.is_polling() ? "by polling" : "by C_WaitForSlotEvent()")
+					 << endl;
+				watcher.stop();
+
+				std::vector<slot_token_info> slots = inventory.snapshot();
+				for (size_t i = 0; i < slots.size(); ++i) {
+					cout << "\tSlot ID " << slots[i].slotID << " :: "
+						 << (slots[i].tokenPresent ? "token present" : "no token") << endl;
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
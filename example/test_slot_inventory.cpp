@@ -0,0 +1,120 @@
+/**
+ * This program was built and executed on Ubuntu 22.04.4 LTS. The following operations are perfromed
+ * in this program.
+ *
+ * 		1. Load the HSM library by setting an environment variable SOFTHSM2_LIB
+ *      in order to use PKCS #11 functions
+ *      2. Connect to valid slot
+ *      3. Keep an inventory of the slots and tokens cached for 5 seconds, and print
+ *          i.      a snapshot of every slot and token
+ *          ii.     the token of the connected slot, looked up from the cache
+ *      4. Disconnect from a connect slot
+ *
+ * To use the Makefile, make sure you're in the same directory of Makefile
+ * To build the program using Makefile, run the following command
+ * 		make test_SlotInv
+ *
+ * If Makefile was used to build, then to execute the program, run the following command
+ *      ./test_SlotInv
+ *
+ * If Makefile was used to build, then run to following command to remove the binary and object files
+ *      make clean_test_SlotInv
+ *
+ * To build the program in the example directory, one can run the following command
+ * On Linux
+ *      g++ -Wall -Werror test_slot_inventory.cpp ../source/slots_token_list.cpp ../source/conn_dis_token.cpp ../source/login_manager.cpp ../source/mechanism_cache.cpp ../source/basic_operation.cpp ../source/common_basic_operation.cpp -o test_SlotInv -I../include
+ *
+ * On Windows
+ * 		g++ -Wall -Werror test_slot_inventory.cpp ..\source\slots_token_list.cpp ..\source\conn_dis_token.cpp ..\source\login_manager.cpp ..\source\mechanism_cache.cpp ..\source\win_basic_operation.cpp ..\source\common_basic_operation.cpp -o test_SlotInv.exe -I../include -DWIND
+ *
+ * To see the list of slots, run the following command
+ *      softhsm2-util --show-slots
+ *
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\slots_token_list.hpp"
+#else
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/conn_dis_token.hpp"
+	#include "../header/slots_token_list.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function prints given slot and token information, where the strings are padded with blanks
+*/
+inline void print_slot_token(const slot_token_info& info)
+{
+	cout << "\tSlot ID " << info.slotID << " :: "
+		 << std::string(reinterpret_cast<const char*>(info.slotInfo.slotDescription),
+						sizeof(info.slotInfo.slotDescription)) << endl;
+	if (!info.tokenPresent) {
+		cout << "\t\tNo token present\n";
+		return;
+	}
+	cout << "\t\tToken label :: "
+		 << std::string(reinterpret_cast<const char*>(info.tokenInfo.label), sizeof(info.tokenInfo.label)) << endl
+		 << "\t\tInitialized :: " << ((info.tokenInfo.flags & CKF_TOKEN_INITIALIZED) ? "yes" : "no")
+		 << ", sessions :: " << info.tokenInfo.ulSessionCount << endl;
+}
+
+
+
+int main()
+{
+	int retVal = 0;
+	#ifdef WIND
+		HINSTANCE libHandle = 0;
+	#else
+		void *libHandle = nullptr;
+	#endif
+
+	CK_FUNCTION_LIST_PTR funclistPtr = NULL_PTR;
+	CK_SESSION_HANDLE hSession = 0;
+	std::string usrPIN;
+	CK_SESSION_INFO sessionInfo;
+	slot_token_info info;
+
+	if (!(retVal = load_library_HSM(libHandle, funclistPtr))) {
+		cout << "HSM PKCS #11 library loaded successfully\n";
+		if (!(retVal = connect_slot(funclistPtr, hSession, usrPIN))) {
+			cout << "Connected to token successfully\n";
+			slot_inventory inventory(funclistPtr, std::chrono::milliseconds(5000));
+			retVal = inventory.refresh();
+			if (!retVal) {
+				std::vector<slot_token_info> slots = inventory.snapshot();
+				cout << slots.size() << " slots in the inventory\n";
+				for (size_t i = 0; i < slots.size(); ++i) {
+					print_slot_token(slots[i]);
+				}
+				// Answered from the cache, the token is not asked again within the time-to-live
+				retVal = check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()");
+				if (!retVal && inventory.lookup(sessionInfo.slotID, info)) {
+					cout << "Connected slot, from the cache\n";
+					print_slot_token(info);
+				}
+			}
+			if (!(retVal = disconnect_slot(funclistPtr, hSession))) {
+				cout << "Disconnected from token successfully\n";
+			}
+		}
+	}
+	free_resource(libHandle, funclistPtr);
+	usrPIN.clear();
+
+	return retVal;
+}
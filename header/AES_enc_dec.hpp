@@ -9,6 +9,9 @@
  *      2. Decrypt given ciphertext/data using
  *          i.      C_DecryptInit() 
  *          ii.     C_Decrypt()     // For now
+ *      3. Encrypt and decrypt data given as byte spans in place, or as scatter-gather lists of struct iovec
+ *      using C_EncryptUpdate() and C_DecryptUpdate() segment by segment, so the data is not copied into
+ *      a std::string first
  *         
  *  
 */
@@ -19,6 +22,11 @@
 
 #include <string>
 #include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+#ifdef WIND
+	#include "..\header\byte_span.hpp"
+#else
+	#include "../header/byte_span.hpp"
+#endif
 
 int init_Mech(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
                 CK_BYTE_PTR const ptrIV, const size_t lenIV);
@@ -32,4 +40,26 @@ int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE
                         const CK_OBJECT_HANDLE& hSecretkey,
                         const std::string& ciphertext, std::string& decryptext);
 
+
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const const_byte_span& plaintext, byte_span& ciphertext);
+
+
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const const_byte_span& ciphertext, byte_span& decryptext);
+
+
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const struct iovec* ptIov, const size_t ptCnt,
+                        const struct iovec* ctIov, const size_t ctCnt, size_t& ctLen);
+
+
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const struct iovec* ctIov, const size_t ctCnt,
+                        const struct iovec* dtIov, const size_t dtCnt, size_t& dtLen);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ * This program is an attempt to authenticate messages using HMAC with SHA-2 i.e., CKM_SHA256_HMAC,
+ * CKM_SHA384_HMAC and CKM_SHA512_HMAC. The following operations are performed
+ *
+ * 		1. Generate HMAC key (generic secret key) by invoking
+ *          i.      C_GenerateKey()
+ *      2. Compute the MAC of given message in a single part using
+ *          i.      C_SignInit()
+ *          ii.     C_Sign()
+ *      3. Compute the MAC of a message stream in multiple parts using
+ *          i.      C_SignInit()
+ *          ii.     C_SignUpdate()
+ *          iii.    C_SignFinal()
+ *      4. Verify given MAC by computing the MAC and comparing both in constant time
+ *      5. Compute or verify the MACs of many messages across the worker sessions of an async_executor
+ *
+ * Note that the MAC is compared on the host in constant time, therefore, the time of verification
+ * does not tell how many leading bytes of a forged MAC are correct.
+ *
+*/
+
+
+#ifndef HMAC_SIGN_VERIFY_HPP
+#define HMAC_SIGN_VERIFY_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+int gen_HMAC_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_ULONG keyLen, const std::string& keyLabel, CK_OBJECT_HANDLE& hKey);
+
+int sign_HMAC(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+				const std::string& message, std::string& mac);
+
+int verify_HMAC(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+				const std::string& message, const std::string& mac);
+
+int sign_HMAC_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech);
+
+int sign_HMAC_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						CK_BYTE_PTR const partPtr, const CK_ULONG partLen);
+
+int sign_HMAC_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_MECHANISM_TYPE macMech, std::string& mac);
+
+int verify_HMAC_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_MECHANISM_TYPE macMech, const std::string& mac);
+
+int sign_HMAC_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+					const std::vector<std::string>& messages, std::vector<std::string>& macs);
+
+int verify_HMAC_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+						const std::vector<std::string>& messages, const std::vector<std::string>& macs,
+						std::vector<int>& results);
+
+bool constant_time_equal(const std::string& lhs, const std::string& rhs);
+
+
+#endif
@@ -9,6 +9,8 @@
  *      2. Decrypt given ciphertext/data using
  *          i.      C_DecryptInit() 
  *          ii.     C_Decrypt()     // For now
+ *      3. Encrypt and decrypt data given as byte spans in place, or as scatter-gather lists of struct iovec,
+ *      so the data is not copied into a std::string first
  * 		
  *  
 */
@@ -19,6 +21,11 @@
 
 #include <string>
 #include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+#ifdef WIND
+	#include "..\header\byte_span.hpp"
+#else
+	#include "../header/byte_span.hpp"
+#endif
 
 int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
                     const CK_OBJECT_HANDLE& hPub, const std::string& plaintext,
@@ -29,4 +36,24 @@ int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE
                         const CK_OBJECT_HANDLE& hPrv, const std::string& ciphertext,
                         std::string& plaintext);
 
+
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hPub, const const_byte_span& plaintext,
+                    byte_span& ciphertext);
+
+
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hPrv, const const_byte_span& ciphertext,
+                        byte_span& plaintext);
+
+
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hPub, const struct iovec* ptIov, const size_t ptCnt,
+                    const struct iovec* ctIov, const size_t ctCnt, size_t& ctLen);
+
+
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hPrv, const struct iovec* ctIov, const size_t ctCnt,
+                        const struct iovec* ptIov, const size_t ptCnt, size_t& ptLen);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,199 @@
+/**
+ * This program is an attempt to perform the PKCS #11 operations of this demonstration
+ * asynchronously. A pool of worker threads is created where each worker owns its own
+ * session on the token, so the calling thread never blocks on the token.
+ * The following operations are performed
+ *
+ * 		1. Open one session per worker thread on the slot of a connected session using
+ *          i.      C_GetSessionInfo()
+ *          ii.     C_OpenSession()
+ *      2. Queue an operation (e.g., encrypt_plaintext(), sign_data_no_hashing(), gen_AES_key())
+ *      and return its result through
+ *          i.      std::future
+ *          ii.     completion callback
+ *      3. Split a batch of items (e.g., messages to be signed) in chunks across the worker threads,
+ *      and perform one operation per item
+ *      4. Close the sessions of worker threads using
+ *          i.      C_CloseSession()
+ *
+ * Note that all the sessions an application has with a token share the same login state,
+ * therefore, the worker sessions are already logged in when the connected session is.
+ *
+*/
+
+
+#ifndef ASYNC_OPERATION_HPP
+#define ASYNC_OPERATION_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+#endif
+
+
+/**
+ * An operation to be performed on the session owned by a worker thread.
+ * It returns integer 0 on success. Otherwise, non-zero integer is returned.
+*/
+typedef std::function<int(CK_SESSION_HANDLE&)> token_operation;
+
+/**
+ * A callback invoked on the worker thread with the value returned by the operation
+*/
+typedef std::function<void(int)> completion_callback;
+
+
+class async_executor
+{
+public:
+	async_executor();
+	~async_executor();
+
+	int start(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+				const size_t workerCount);
+
+	int start_slot(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+					const size_t workerCount);
+
+	void stop();
+
+	std::future<int> submit(token_operation operation);
+
+	void submit(token_operation operation, completion_callback callback);
+
+	CK_FUNCTION_LIST_PTR function_list() const { return funclistPtr; }
+
+	size_t worker_count() const { return workers.size(); }
+
+private:
+	async_executor(const async_executor&);
+	async_executor& operator=(const async_executor&);
+
+	int enqueue(std::function<void(CK_SESSION_HANDLE&)> task);
+
+	void run_worker(CK_SESSION_HANDLE hWorker);
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	std::vector<std::thread> workers;
+	std::vector<CK_SESSION_HANDLE> sessions;
+	std::deque<std::function<void(CK_SESSION_HANDLE&)> > tasks;
+	std::mutex tasksMutex;
+	std::condition_variable tasksReady;
+	bool stopping;
+};
+
+
+/**
+ * The function queues one of the existing operations e.g., encrypt_plaintext(), gen_AES_key(),
+ * sign_data_no_hashing(), etc., where the first two parameters i.e., funclistPtr and hSession
+ * are supplied by the executor. The remaining arguments are copied, therefore, output
+ * parameters should be passed using std::ref().
+ *
+ * executor is an alias of started async_executor
+ * function is the operation to be performed
+ * args are the remaining arguments of the function
+ *
+ * The std::future holding the value returned by function is returned.
+*/
+template <typename Function, typename... Args>
+std::future<int> async_operation(async_executor& executor, Function function, Args... args)
+{
+	return executor.submit(std::bind(function, executor.function_list(), std::placeholders::_1, args...));
+}
+
+
+/**
+ * The function is similar to async_operation() except that the callback is invoked
+ * on the worker thread once function returns.
+ *
+ * executor is an alias of started async_executor
+ * callback is the completion callback
+ * function is the operation to be performed
+ * args are the remaining arguments of the function
+ *
+ * The function does not return anything.
+*/
+template <typename Function, typename... Args>
+void async_operation_callback(async_executor& executor, completion_callback callback,
+								Function function, Args... args)
+{
+	executor.submit(std::bind(function, executor.function_list(), std::placeholders::_1, args...),
+					callback);
+}
+
+
+
+/**
+ * The function performs an operation on every item of a batch across the worker sessions of given
+ * executor. The items are queued in chunks of consecutive indexes, so one task performs many items
+ * and the queue is not contended per item. It waits for all chunks.
+ *
+ * executor is an alias of started async_executor
+ * itemCount represents the number of items
+ * itemsPerChunk represents the number of items performed by one task, which must not be zero
+ * function is the operation on one item, called as function(funclistPtr, hSession, index) on a worker
+ * thread, which returns integer 0 on success. Otherwise, non-zero integer is returned. Items are
+ * performed concurrently, so it should only write to the element of its own index.
+ * results is a pointer to the values returned for every item i.e., results[index], or NULL_PTR
+ *
+ * On success i.e., all items succeeded, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+template <typename ItemFunction>
+int async_batch(async_executor& executor, const size_t itemCount, const size_t itemsPerChunk,
+				ItemFunction function, int* results)
+{
+	int retVal = 0;
+	std::vector<std::future<int> > chunks;
+	const CK_FUNCTION_LIST_PTR funclistPtr = executor.function_list();
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 1;
+	}
+	if (!executor.worker_count()) {
+		std::cout << "Error, executor is not started\n";
+		return 1;
+	}
+	if (!itemsPerChunk) {
+		std::cout << "Error, no item is requested per chunk\n";
+		return 1;
+	}
+
+	chunks.reserve(itemCount / itemsPerChunk + 1);
+	for (size_t begin = 0; begin < itemCount; begin += itemsPerChunk) {
+		size_t end = begin + itemsPerChunk < itemCount ? begin + itemsPerChunk : itemCount;
+		// function is shared by reference, since all chunks are done before returning
+		chunks.push_back(executor.submit([&function, funclistPtr, results, begin, end](CK_SESSION_HANDLE& hSession) {
+			int chunkVal = 0;
+			for (size_t i = begin; i < end; ++i) {
+				int itemVal = function(funclistPtr, hSession, i);
+				if (results) {
+					results[i] = itemVal;
+				}
+				if (itemVal) {
+					chunkVal = 1;
+				}
+			}
+			return chunkVal;
+		}));
+	}
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		if (chunks[i].get()) {
+			retVal = 1;
+		}
+	}
+	return retVal;
+}
+
+
+#endif
@@ -0,0 +1,206 @@
+/**
+ * This program is an attempt to build the attribute templates (i.e., CK_ATTRIBUTE arrays)
+ * of key generation at compile time and in a type-safe way. The following is performed
+ *
+ * 		1. Every attribute is typed by attribute_traits e.g., CKA_MODULUS_BITS is CK_ULONG,
+ *      CKA_TOKEN is CK_BBOOL and CKA_LABEL is a byte array, so a value of another type
+ *      (e.g., int for CKA_MODULUS_BITS) does not compile. Note that size_t is the same type as
+ *      CK_ULONG on LP64 e.g., Linux, so it is only rejected where they differ e.g., 64-bit Windows
+ *      2. The static part of a template i.e., fixed_attribute<CKA_TOKEN, CK_TRUE>, is laid out
+ *      at compile time, and its value has static storage
+ *      3. Only the variable part i.e., variable_attribute<CKA_LABEL>, is patched per call,
+ *      so the per-call setup is copying the layout and setting a few pointers
+ *
+ * An example of the template of an AES key is
+ *
+ * 		attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+ * 							variable_attribute<CKA_VALUE_LEN>,
+ * 							variable_attribute<CKA_LABEL> > keyAttrb;
+ * 		keyAttrb.set<CKA_VALUE_LEN>(keyLen);			// keyLen must be CK_ULONG
+ * 		keyAttrb.set_bytes<CKA_LABEL>(label, labelLen);
+ * 		funclistPtr->C_GenerateKey(hSession, &mech, keyAttrb.data(), keyAttrb.size(), &hKey);
+ *
+ * Note that the variable values are referenced, not copied, therefore, they should be alive
+ * until the template is used.
+ *
+*/
+
+
+#ifndef ATTRIBUTE_TEMPLATE_HPP
+#define ATTRIBUTE_TEMPLATE_HPP
+
+#include <cstring>
+#include <type_traits>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * The type of the value of an attribute. An attribute without traits cannot be used in
+ * a template, so every new attribute should be typed here first.
+*/
+template <CK_ATTRIBUTE_TYPE Type>
+struct attribute_traits;
+
+struct bool_attribute { typedef CK_BBOOL value_type; static const bool is_bytes = false; };
+struct ulong_attribute { typedef CK_ULONG value_type; static const bool is_bytes = false; };
+struct bytes_attribute { typedef CK_BYTE value_type; static const bool is_bytes = true; };
+
+template <> struct attribute_traits<CKA_TOKEN> : bool_attribute {};
+template <> struct attribute_traits<CKA_PRIVATE> : bool_attribute {};
+template <> struct attribute_traits<CKA_MODIFIABLE> : bool_attribute {};
+template <> struct attribute_traits<CKA_SENSITIVE> : bool_attribute {};
+template <> struct attribute_traits<CKA_EXTRACTABLE> : bool_attribute {};
+template <> struct attribute_traits<CKA_ENCRYPT> : bool_attribute {};
+template <> struct attribute_traits<CKA_DECRYPT> : bool_attribute {};
+template <> struct attribute_traits<CKA_WRAP> : bool_attribute {};
+template <> struct attribute_traits<CKA_UNWRAP> : bool_attribute {};
+template <> struct attribute_traits<CKA_SIGN> : bool_attribute {};
+template <> struct attribute_traits<CKA_VERIFY> : bool_attribute {};
+template <> struct attribute_traits<CKA_DERIVE> : bool_attribute {};
+template <> struct attribute_traits<CKA_CLASS> : ulong_attribute {};
+template <> struct attribute_traits<CKA_KEY_TYPE> : ulong_attribute {};
+template <> struct attribute_traits<CKA_VALUE_LEN> : ulong_attribute {};
+template <> struct attribute_traits<CKA_MODULUS_BITS> : ulong_attribute {};
+template <> struct attribute_traits<CKA_LABEL> : bytes_attribute {};
+template <> struct attribute_traits<CKA_ID> : bytes_attribute {};
+template <> struct attribute_traits<CKA_VALUE> : bytes_attribute {};
+template <> struct attribute_traits<CKA_PUBLIC_EXPONENT> : bytes_attribute {};
+template <> struct attribute_traits<CKA_EC_PARAMS> : bytes_attribute {};
+
+
+
+/**
+ * An attribute whose value is known at compile time e.g., fixed_attribute<CKA_TOKEN, CK_TRUE>
+*/
+template <CK_ATTRIBUTE_TYPE Type, typename attribute_traits<Type>::value_type Value>
+struct fixed_attribute
+{
+	static_assert(!attribute_traits<Type>::is_bytes, "Byte array attribute should be variable_attribute");
+
+	typedef typename attribute_traits<Type>::value_type value_type;
+	static const CK_ATTRIBUTE_TYPE type = Type;
+	static const bool is_variable = false;
+
+	// The storage of the value, never modified since the templates are only read by the token
+	static value_type value;
+
+	static constexpr CK_ATTRIBUTE attribute() { return {Type, &value, sizeof(value_type)}; }
+};
+
+template <CK_ATTRIBUTE_TYPE Type, typename attribute_traits<Type>::value_type Value>
+typename attribute_traits<Type>::value_type fixed_attribute<Type, Value>::value = Value;
+
+
+/**
+ * An attribute whose value is set per call e.g., variable_attribute<CKA_LABEL>
+*/
+template <CK_ATTRIBUTE_TYPE Type>
+struct variable_attribute
+{
+	typedef typename attribute_traits<Type>::value_type value_type;
+	static const CK_ATTRIBUTE_TYPE type = Type;
+	static const bool is_variable = true;
+
+	static constexpr CK_ATTRIBUTE attribute() { return {Type, nullptr, 0}; }
+};
+
+
+
+/**
+ * The function finds the position of given attribute in the fields of a template at compile time.
+ * If the attribute is not in the fields, the number of fields is returned.
+*/
+template <CK_ATTRIBUTE_TYPE Type>
+constexpr size_t attribute_index()
+{
+	return 0;
+}
+
+template <CK_ATTRIBUTE_TYPE Type, typename Field, typename... Fields>
+constexpr size_t attribute_index()
+{
+	return Field::type == Type ? 0 : 1 + attribute_index<Type, Fields...>();
+}
+
+
+/**
+ * The function checks at compile time whether the field at given position is variable
+*/
+template <size_t Index>
+constexpr bool attribute_is_variable()
+{
+	return false;
+}
+
+template <size_t Index, typename Field, typename... Fields>
+constexpr bool attribute_is_variable()
+{
+	return Index ? attribute_is_variable<Index - 1, Fields...>() : Field::is_variable;
+}
+
+
+
+template <typename... Fields>
+class attribute_template
+{
+public:
+	attribute_template()
+	{
+		memcpy(attributes, layout, sizeof(layout));
+	}
+
+	/**
+	 * The function sets the value of a variable scalar attribute. The type of value should be
+	 * exactly the type of the attribute e.g., CK_ULONG for CKA_MODULUS_BITS.
+	 *
+	 * value is an alias of the value, referenced by the template
+	*/
+	template <CK_ATTRIBUTE_TYPE Type, typename T>
+	void set(T& value)
+	{
+		static_assert(!attribute_traits<Type>::is_bytes, "Byte array attribute should be set by set_bytes()");
+		static_assert(std::is_same<typename std::remove_const<T>::type,
+									typename attribute_traits<Type>::value_type>::value,
+						"Value does not have the type of the attribute");
+		patch<Type>(const_cast<typename std::remove_const<T>::type*>(&value), sizeof(T));
+	}
+
+	/**
+	 * The function sets the value of a variable byte array attribute e.g., CKA_LABEL
+	 *
+	 * value is a constant pointer to the value, referenced by the template
+	 * valueLen represents the byte-length of the value
+	*/
+	template <CK_ATTRIBUTE_TYPE Type>
+	void set_bytes(const void* value, const CK_ULONG valueLen)
+	{
+		static_assert(attribute_traits<Type>::is_bytes, "Scalar attribute should be set by set()");
+		patch<Type>(const_cast<void*>(value), valueLen);
+	}
+
+	CK_ATTRIBUTE_PTR data() { return attributes; }
+
+	CK_ULONG size() const { return sizeof...(Fields); }
+
+private:
+	template <CK_ATTRIBUTE_TYPE Type>
+	void patch(CK_VOID_PTR value, const CK_ULONG valueLen)
+	{
+		static_assert(attribute_index<Type, Fields...>() < sizeof...(Fields), "Attribute is not in the template");
+		static_assert(attribute_is_variable<attribute_index<Type, Fields...>(), Fields...>(),
+						"Attribute is fixed in the template");
+		attributes[attribute_index<Type, Fields...>()].pValue = value;
+		attributes[attribute_index<Type, Fields...>()].ulValueLen = valueLen;
+	}
+
+	// The layout laid out at compile time, and copied by every template
+	static constexpr CK_ATTRIBUTE layout[sizeof...(Fields)] = {Fields::attribute()...};
+
+	CK_ATTRIBUTE attributes[sizeof...(Fields)];
+};
+
+template <typename... Fields>
+constexpr CK_ATTRIBUTE attribute_template<Fields...>::layout[sizeof...(Fields)];
+
+
+#endif
@@ -3,6 +3,7 @@
  * programs in this PKCS #11 demonstration
  * 
  *      1. Load the HSM library by setting an environment variable SOFTHSM2_LIB in order to use PKCS #11 functions
+ *      or from a given library path
  *      2. Check the PKCS #11 operation status i.e., CKR_OK
  *      3. Free the resources/memory
  *      4. Check to ensure null pointer is not used to call
@@ -19,6 +20,8 @@
 
 int load_library_HSM(void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr);
 
+int load_library_path(const char* libPath, void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr);
+
 void free_resource(void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr);
 
 
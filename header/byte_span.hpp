@@ -0,0 +1,140 @@
+/**
+ * This program is an attempt to pass data to and from the crypto functions without copying it into a
+ * std::string first, so data held in network buffers, mmap regions etc. is used in place. The following
+ * are provided
+ *
+ * 		1. const_byte_span, a read-only contiguous byte range owned by the caller (input)
+ *      2. byte_span, a writable contiguous byte range owned by the caller (output), whose size is the
+ *      capacity on input and the byte-length written on return
+ *      3. iovec_writer, a cursor writing across a scatter list of struct iovec (output)
+ *
+ * A scatter-gather list is given as a pointer to struct iovec and the number of its entries, as
+ * readv() and writev() take it.
+ *
+*/
+
+
+#ifndef BYTE_SPAN_HPP
+#define BYTE_SPAN_HPP
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/uio.h>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+struct const_byte_span
+{
+	const_byte_span() : data(NULL_PTR), size(0) {}
+
+	const_byte_span(const void* ptr, const size_t len) : data(static_cast<const CK_BYTE*>(ptr)), size(len) {}
+
+	explicit const_byte_span(const std::string& str)
+		: data(reinterpret_cast<const CK_BYTE*>(str.data())), size(str.length()) {}
+
+	/**
+	 * Cryptoki takes the input as CK_BYTE_PTR, though it does not modify it
+	*/
+	CK_BYTE_PTR ptr() const { return const_cast<CK_BYTE_PTR>(data); }
+
+	const CK_BYTE* data;
+	size_t size;
+};
+
+
+struct byte_span
+{
+	byte_span() : data(NULL_PTR), size(0) {}
+
+	byte_span(void* ptr, const size_t len) : data(static_cast<CK_BYTE_PTR>(ptr)), size(len) {}
+
+	CK_BYTE_PTR data;
+	size_t size;
+};
+
+
+/**
+ * The function gets the total byte-length of given scatter-gather list
+*/
+inline size_t iovec_length(const struct iovec* iov, const size_t iovCnt)
+{
+	size_t len = 0;
+
+	for (size_t i = 0; i < iovCnt; ++i) {
+		len += iov[i].iov_len;
+	}
+	return len;
+}
+
+
+/**
+ * A cursor over a scatter list, where the output is either written into current() directly and the cursor
+ * advanced, or copied by write() across the entries
+*/
+class iovec_writer
+{
+public:
+	iovec_writer(const struct iovec* iov, const size_t iovCnt) : iov(iov), iovCnt(iovCnt), index(0), offset(0), total(0)
+	{
+		skip_full();
+	}
+
+	/**
+	 * The byte-length left in the current entry, which is 0 once the list is full
+	*/
+	size_t room() const { return index < iovCnt ? iov[index].iov_len - offset : 0; }
+
+	CK_BYTE_PTR current() const { return static_cast<CK_BYTE_PTR>(iov[index].iov_base) + offset; }
+
+	void advance(const size_t len)
+	{
+		offset += len;
+		total += len;
+		skip_full();
+	}
+
+	/**
+	 * The function copies given bytes at the cursor, across the entries
+	 *
+	 * On success, integer 0 is returned. Otherwise, non-zero integer is returned i.e., the list is full.
+	*/
+	int write(const CK_BYTE* src, size_t len)
+	{
+		while (len) {
+			size_t part = room() < len ? room() : len;
+			if (!part) {
+				std::cout << "Error, output buffers are too small\n";
+				return 1;
+			}
+			std::memcpy(current(), src, part);
+			src += part;
+			len -= part;
+			advance(part);
+		}
+		return 0;
+	}
+
+	/**
+	 * The byte-length written so far
+	*/
+	size_t written() const { return total; }
+
+private:
+	void skip_full()
+	{
+		while (index < iovCnt && offset == iov[index].iov_len) {
+			++index;
+			offset = 0;
+		}
+	}
+
+	const struct iovec* iov;
+	size_t iovCnt;
+	size_t index;
+	size_t offset;
+	size_t total;
+};
+
+
+#endif
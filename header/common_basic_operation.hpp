@@ -4,6 +4,7 @@
  * 
  *      1. Check the PKCS #11 operation status i.e., CKR_OK
  *      2. Check to ensure null pointer is not used to call
+ *      3. Get the CK_RV value an operation actually failed with
  * 
 */
 
@@ -21,6 +22,32 @@
 int check_operation(const CK_RV rv, const char* message);
 
 
+/**
+ * The CK_RV value a function actually failed with i.e., the first failure checked by check_operation()
+ * on the calling thread while the scope is alive. Later failures e.g., of clean-up operations, do not
+ * overwrite it, and a failure before the scope is not reported. Scopes can be nested, where the failure
+ * is also given to the outer scope.
+ * 
+ */
+class operation_rv_scope
+{
+public:
+	operation_rv_scope();
+	~operation_rv_scope();
+
+	CK_RV failed_rv() const { return failedRV; }
+
+private:
+	operation_rv_scope(const operation_rv_scope&);
+	operation_rv_scope& operator=(const operation_rv_scope&);
+
+	friend int check_operation(const CK_RV rv, const char* message);
+
+	CK_RV failedRV;
+	operation_rv_scope* outer;
+};
+
+
 /**
  * This function checks whether a given pointer is null or not.
  * 
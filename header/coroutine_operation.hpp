@@ -0,0 +1,216 @@
+/**
+ * This program is an attempt to perform the PKCS #11 operations of this demonstration
+ * using C++20 coroutines on top of async_executor. A coroutine suspends on co_await
+ * while the operation is performed by a worker thread owning a session, therefore,
+ * no thread is blocked per in-flight request. The following are provided
+ *
+ * 		1. Awaitable versions of the existing operations
+ *          i.      co_encrypt()        i.e., encrypt_plaintext()
+ *          ii.     co_decrypt()        i.e., decrypt_ciphertext()
+ *          iii.    co_sign()           i.e., sign_data_no_hashing()
+ *          iv.     co_verify()         i.e., verify_data_no_hashing()
+ *          v.      co_generate_key()   i.e., gen_AES_key()
+ *          vi.     co_generate_random() i.e., C_GenerateRandom()
+ *      2. token_task, a lazily started coroutine type returning integer which resumes
+ *      its awaiting coroutine using symmetric transfer
+ *      3. spawn_task() to start a token_task without awaiting it
+ *
+ * Note that encrypt_plaintext() and decrypt_ciphertext() are resolved by the linked
+ * program i.e., AES_enc_dec.cpp or RSA_OAEP_enc_dec.cpp
+ *
+ * It requires -std=c++20
+*/
+
+
+#ifndef COROUTINE_OPERATION_HPP
+#define COROUTINE_OPERATION_HPP
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <string>
+#include <utility>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\async_operation.hpp"
+	#include "..\header\gen_AES_keys.hpp"
+	#include "..\header\AES_enc_dec.hpp"
+	#include "..\header\sign_verify_ECDSA.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/async_operation.hpp"
+	#include "../header/gen_AES_keys.hpp"
+	#include "../header/AES_enc_dec.hpp"
+	#include "../header/sign_verify_ECDSA.hpp"
+#endif
+
+
+/**
+ * The scheduler of the caller's executor e.g., an event loop. It is given the suspended
+ * coroutine to be resumed on that executor. If it is empty, then the coroutine is resumed
+ * on the worker thread which has performed the operation.
+*/
+typedef std::function<void(std::coroutine_handle<>)> resume_scheduler;
+
+
+class token_awaitable
+{
+public:
+	token_awaitable(async_executor& executor, token_operation operation)
+		: executor(executor), operation(std::move(operation)), retVal(0) {}
+
+	/**
+	 * The function sets the scheduler used to resume the awaiting coroutine
+	*/
+	token_awaitable& resume_on(resume_scheduler scheduler)
+	{
+		this->scheduler = std::move(scheduler);
+		return *this;
+	}
+
+	bool await_ready() const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> hCaller)
+	{
+		// The awaitable may be destroyed as soon as the coroutine is resumed,
+		// therefore, the scheduler is copied and nothing is accessed after submit()
+		resume_scheduler scheduler = this->scheduler;
+		executor.submit(operation, [this, hCaller, scheduler](int result) {
+			retVal = result;
+			if (scheduler) {
+				scheduler(hCaller);
+			}
+			else {
+				hCaller.resume();
+			}
+		});
+	}
+
+	int await_resume() const noexcept { return retVal; }
+
+private:
+	async_executor& executor;
+	token_operation operation;
+	resume_scheduler scheduler;
+	int retVal;
+};
+
+
+class token_task
+{
+public:
+	struct promise_type
+	{
+		int retVal = 0;
+		std::coroutine_handle<> hContinuation;
+
+		token_task get_return_object();
+		std::suspend_always initial_suspend() noexcept { return {}; }
+
+		struct final_awaiter
+		{
+			bool await_ready() const noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> hTask) noexcept;
+			void await_resume() const noexcept {}
+		};
+		final_awaiter final_suspend() noexcept { return {}; }
+
+		void return_value(int value) { retVal = value; }
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	token_task(token_task&& other) noexcept;
+	token_task& operator=(token_task&& other) noexcept;
+	~token_task();
+
+	bool await_ready() const noexcept { return !hTask || hTask.done(); }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> hCaller) noexcept;
+	int await_resume() const noexcept { return hTask.promise().retVal; }
+
+private:
+	explicit token_task(std::coroutine_handle<promise_type> hTask) : hTask(hTask) {}
+	token_task(const token_task&) = delete;
+	token_task& operator=(const token_task&) = delete;
+
+	std::coroutine_handle<promise_type> hTask;
+};
+
+
+void spawn_task(token_task task, completion_callback callback = completion_callback());
+
+
+
+/**
+ * The function returns an awaitable of one of the existing operations where the first
+ * two parameters i.e., funclistPtr and hSession are supplied by the executor.
+ * Similar to async_operation(), the output parameters should be passed using std::ref().
+ *
+ * executor is an alias of started async_executor
+ * function is the operation to be performed
+ * args are the remaining arguments of the function
+ *
+ * The token_awaitable of function is returned, co_await gives the returned integer.
+*/
+template <typename Function, typename... Args>
+token_awaitable co_operation(async_executor& executor, Function function, Args... args)
+{
+	return token_awaitable(executor,
+							std::bind(function, executor.function_list(), std::placeholders::_1, args...));
+}
+
+
+/**
+ * The std::string overload of encrypt_plaintext() and decrypt_ciphertext(), the ones taken by the coroutines
+*/
+typedef int (*string_crypt_function)(const CK_FUNCTION_LIST_PTR, CK_SESSION_HANDLE&, const CK_OBJECT_HANDLE&,
+										const std::string&, std::string&);
+
+
+inline token_awaitable co_encrypt(async_executor& executor, const CK_OBJECT_HANDLE hKey,
+									const std::string& plaintext, std::string& ciphertext)
+{
+	return co_operation(executor, static_cast<string_crypt_function>(encrypt_plaintext), hKey, std::cref(plaintext), std::ref(ciphertext));
+}
+
+
+inline token_awaitable co_decrypt(async_executor& executor, const CK_OBJECT_HANDLE hKey,
+									const std::string& ciphertext, std::string& plaintext)
+{
+	return co_operation(executor, static_cast<string_crypt_function>(decrypt_ciphertext), hKey, std::cref(ciphertext), std::ref(plaintext));
+}
+
+
+inline token_awaitable co_sign(async_executor& executor, const CK_OBJECT_HANDLE hPrv,
+								CK_BYTE_PTR dataPtr, const CK_ULONG dataLen,
+								CK_BYTE_PTR sigPtr, const CK_ULONG sigLen)
+{
+	return co_operation(executor, sign_data_no_hashing, hPrv, dataPtr, dataLen, sigPtr, sigLen);
+}
+
+
+inline token_awaitable co_verify(async_executor& executor, const CK_OBJECT_HANDLE hPub,
+									CK_BYTE_PTR dataPtr, const CK_ULONG dataLen,
+									CK_BYTE_PTR sigPtr, const CK_ULONG sigLen)
+{
+	return co_operation(executor, verify_data_no_hashing, hPub, dataPtr, dataLen, sigPtr, sigLen);
+}
+
+
+inline token_awaitable co_generate_key(async_executor& executor, CK_OBJECT_HANDLE_PTR hkeyPtr,
+										CK_ULONG& keyLen, const std::string& keyLabel)
+{
+	return co_operation(executor, gen_AES_key, hkeyPtr, std::ref(keyLen), std::cref(keyLabel));
+}
+
+
+inline token_awaitable co_generate_random(async_executor& executor, CK_BYTE_PTR randPtr,
+											const CK_ULONG randLen)
+{
+	CK_FUNCTION_LIST_PTR funclistPtr = executor.function_list();
+	return token_awaitable(executor, [funclistPtr, randPtr, randLen](CK_SESSION_HANDLE& hWorker) {
+		return check_operation(funclistPtr->C_GenerateRandom(hWorker, randPtr, randLen), "C_GenerateRandom()");
+	});
+}
+
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * This program is an attempt to store a file in a seekable encrypted container, so a byte range can be read
+ * by decrypting the chunks covering it only. The container is laid out as follows, all integers being
+ * little-endian
+ *
+ * 		header			magic "P11CTNR1", mechanism (8 bytes), chunk size (8 bytes), plaintext size (8 bytes),
+ * 						IV seed (8 bytes), key ID length (4 bytes), key ID (CKA_ID of the key)
+ * 		chunk 0..n-1	ciphertext || tag (16 bytes) of each chunk of the plaintext, where every chunk but
+ * 						the last has chunk size bytes of plaintext
+ * 		index			chunk count (8 bytes), then the offset and byte-length (8 bytes each) of every chunk
+ * 		footer			offset of the index (8 bytes), magic "P11CIDX1"
+ *
+ * Every chunk is encrypted on its own with AES-GCM i.e., CKM_AES_GCM, where the IV is the IV seed followed
+ * by the big-endian chunk number and the header is the additional authenticated data. Therefore, a chunk
+ * cannot be modified, moved to another position or another container, and the header cannot be modified,
+ * without failing the authentication. The following operations are performed
+ *
+ * 		1. Write the container, encrypting the chunks across the worker sessions of an async_executor using
+ *          i.      C_GenerateRandom()      // IV seed
+ *          ii.     C_EncryptInit()
+ *          iii.    C_Encrypt()
+ *      2. Read a byte range of the container, decrypting the chunks covering it using
+ *          i.      C_DecryptInit()
+ *          ii.     C_Decrypt()
+ *
+*/
+
+
+#ifndef CRYPT_CONTAINER_HPP
+#define CRYPT_CONTAINER_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * The default byte-length of the plaintext of a chunk i.e., 1 MiB
+*/
+const size_t CONTAINER_CHUNK_SIZE = 1 << 20;
+
+
+/**
+ * The header of a container
+*/
+struct container_header
+{
+	CK_MECHANISM_TYPE mechanism;
+	unsigned long long chunkSize;
+	unsigned long long plainSize;
+	CK_BYTE ivSeed[8];
+	std::string keyId;
+};
+
+
+/**
+ * A chunk of the index of a container i.e., the offset and byte-length of its ciphertext and tag
+*/
+struct container_chunk
+{
+	unsigned long long offset;
+	unsigned long long length;
+};
+
+
+int write_container(async_executor& executor, const CK_OBJECT_HANDLE& hSecretkey, const std::string& keyId,
+					const std::string& inPath, const std::string& outPath,
+					const size_t chunkSz = CONTAINER_CHUNK_SIZE);
+
+
+class container_reader
+{
+public:
+	container_reader();
+	~container_reader();
+
+	int open(const std::string& path);
+
+	void close();
+
+	int read(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hSecretkey, const unsigned long long offset, const size_t length,
+				std::string& plaintext);
+
+	const container_header& header() const { return hdr; }
+
+	unsigned long long size() const { return hdr.plainSize; }
+
+private:
+	container_reader(const container_reader&);
+	container_reader& operator=(const container_reader&);
+
+	int decrypt_chunk(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hSecretkey, const size_t chunkNo, std::string& plainChunk);
+
+	int fd;
+	container_header hdr;
+	std::string headerBytes;
+	std::vector<container_chunk> chunks;
+};
+
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * This program is an attempt to overlap the file reads, the token calls and the file writes of streaming
+ * operations in a three-stage pipeline, so the time of the slower of the disk and the token is paid only.
+ * The following stages are run at the same time
+ *
+ * 		1. The reader thread reads the input file chunk by chunk into free buffers
+ *      2. The crypto stage transforms the chunks on the token e.g.,
+ *          i.      C_EncryptUpdate() or C_DecryptUpdate()
+ *          ii.     C_DigestUpdate()
+ *          iii.    C_SignUpdate()
+ *      either in order on one session (chained operations) or across the worker sessions of an async_executor
+ *      (independent chunks)
+ *      3. The writer thread writes the output of the chunks in order and gives the buffers back to the reader
+ *
+ * The stages are connected by bounded rings and only depth chunk buffers exist, therefore, the memory
+ * is bounded by depth chunks whatever the size of the file. The read and write calls are POSIX.
+ *
+*/
+
+
+#ifndef CRYPTO_PIPELINE_HPP
+#define CRYPTO_PIPELINE_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * The configuration of the pipeline i.e., the byte-length of the chunks and the number of chunk buffers
+*/
+struct pipeline_config
+{
+	size_t chunkSize;
+	size_t depth;
+};
+
+/**
+ * The default configuration i.e., 4 MiB chunks, 4 buffers
+*/
+const pipeline_config DEFAULT_PIPELINE_CONFIG = {4 << 20, 4};
+
+
+/**
+ * A chunk of the pipeline, where seq is its position in the file. The crypto stage fills out and outLen,
+ * where out is kept with the buffer, so it is allocated once per buffer.
+*/
+struct pipeline_chunk
+{
+	unsigned long long seq;
+	std::vector<CK_BYTE> in;
+	size_t inLen;
+	std::vector<CK_BYTE> out;
+	size_t outLen;
+};
+
+
+/**
+ * The statistics of the pipeline i.e., the byte-lengths, the number of chunks, the wall time, the busy time
+ * of every stage and the throughput (of the input) in MiB/s. When the I/O is hidden behind the token,
+ * seconds is close to cryptoSeconds.
+*/
+struct pipeline_stats
+{
+	unsigned long long bytesIn;
+	unsigned long long bytesOut;
+	unsigned long long chunkCount;
+	double seconds;
+	double readSeconds;
+	double cryptoSeconds;
+	double writeSeconds;
+	double MiBps;
+};
+
+
+/**
+ * The transformation of a chunk by the crypto stage on given session.
+ * It returns integer 0 on success. Otherwise, non-zero integer is returned.
+*/
+typedef std::function<int(CK_SESSION_HANDLE&, pipeline_chunk&)> chunk_transform;
+
+
+int run_pipeline(const int inFd, const int outFd, const pipeline_config& config, const chunk_transform& transform,
+					CK_SESSION_HANDLE& hSession, async_executor* executor, pipeline_stats& stats);
+
+int encrypt_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+							pipeline_stats& stats, const pipeline_config& config = DEFAULT_PIPELINE_CONFIG);
+
+int decrypt_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+							pipeline_stats& stats, const pipeline_config& config = DEFAULT_PIPELINE_CONFIG);
+
+int digest_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_MECHANISM_TYPE digestMech, const std::string& inPath, std::string& digest,
+							pipeline_stats& stats, const pipeline_config& config = DEFAULT_PIPELINE_CONFIG);
+
+int sign_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPrv, CK_MECHANISM& signMech, const std::string& inPath,
+						std::string& signature, pipeline_stats& stats,
+						const pipeline_config& config = DEFAULT_PIPELINE_CONFIG);
+
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * This program is an attempt to perform Elliptic Curve Diffie-Hellman (ECDH) key agreement
+ * i.e., derive an AES session key from an EC private key and the public point of a peer.
+ * The following operations are performed
+ *
+ * 		1. Derive the AES secret key from the shared secret using
+ *          i.      C_DeriveKey() with CKM_ECDH1_DERIVE
+ *      2. Derive many AES secret keys across the worker sessions of an async_executor e.g.,
+ *      for the key agreements of many handshakes
+ *
+ * Note that the EC private key should have CKA_DERIVE set (see gen_EC_keypair()).
+ * The derived keys are session objects, therefore, they are destroyed when the session which
+ * derived them is closed e.g., by async_executor::stop() for the batched form.
+ *
+*/
+
+
+#ifndef DERIVE_ECDH_HPP
+#define DERIVE_ECDH_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * A key agreement of the batched form i.e., the EC private key and the public point of the peer
+ * (the uncompressed point i.e., 0x04 || x || y)
+*/
+struct ecdh_request
+{
+	CK_OBJECT_HANDLE hPrv;
+	std::string peerPoint;
+};
+
+
+int derive_ECDH_AES_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPrv, CK_BYTE_PTR const peerPoint, const CK_ULONG peerPointLen,
+						const CK_ULONG kdf, const CK_ULONG keyLen, CK_OBJECT_HANDLE& hKey);
+
+int derive_ECDH_AES_keys_batch(async_executor& executor, const std::vector<ecdh_request>& requests,
+								const CK_ULONG kdf, const CK_ULONG keyLen, std::vector<CK_OBJECT_HANDLE>& hKeys);
+
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * This program is an attempt to compute message digests on the token with SHA-2 i.e., CKM_SHA256,
+ * CKM_SHA384 and CKM_SHA512. The following operations are performed
+ *
+ * 		1. Digest given message in a single part using
+ *          i.      C_DigestInit()
+ *          ii.     C_Digest()
+ *      2. Digest a message stream, which may include the value of a secret key, in multiple parts using
+ *          i.      C_DigestInit()
+ *          ii.     C_DigestUpdate()
+ *          iii.    C_DigestKey()
+ *          iv.     C_DigestFinal()
+ *      3. Digest a file in constant memory by streaming it through one large aligned read buffer
+ *      4. Digest the same file on the host (OpenSSL) and on the token and compare the throughput
+ *
+ * Note that the host-side path is linked with libcrypto i.e., $(LIBCRYPTO) in the Makefile.
+ *
+*/
+
+
+#ifndef DIGEST_TOKEN_HPP
+#define DIGEST_TOKEN_HPP
+
+#include <cstddef>
+#include <string>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * The default byte-length of the read buffer used to stream a file i.e., 1 MiB
+*/
+const size_t DIGEST_BUFFER_SIZE = 1 << 20;
+
+
+/**
+ * The result of digest_file_benchmark() i.e., the digests and the throughput in MiB/s of both paths
+*/
+struct digest_benchmark
+{
+	unsigned long long fileSize;
+	std::string tokenDigest;
+	std::string hostDigest;
+	double tokenMiBps;
+	double hostMiBps;
+};
+
+
+int digest_data(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech, const std::string& message, std::string& digest);
+
+int digest_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech);
+
+int digest_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					CK_BYTE_PTR const partPtr, const CK_ULONG partLen);
+
+int digest_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey);
+
+int digest_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_MECHANISM_TYPE digestMech, std::string& digest);
+
+int digest_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech, const std::string& filePath, std::string& digest,
+				const size_t bufferSz = DIGEST_BUFFER_SIZE);
+
+int digest_file_host(const CK_MECHANISM_TYPE digestMech, const std::string& filePath, std::string& digest,
+						const size_t bufferSz = DIGEST_BUFFER_SIZE);
+
+int digest_file_benchmark(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_MECHANISM_TYPE digestMech, const std::string& filePath,
+							digest_benchmark& result, const size_t bufferSz = DIGEST_BUFFER_SIZE);
+
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * This program is an attempt to encrypt and decrypt files of any size using Advanced Encryption Standard (AES)
+ * with Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD, in bounded memory. The following operations are performed
+ *
+ * 		1. Memory-map the input file and preallocate and memory-map the output file
+ *      2. Encrypt the input file in large page-aligned chunks, straight from the input mapping to the
+ *      output mapping, using
+ *          i.      C_GenerateRandom()      // IV, the first block of the output file
+ *          ii.     C_EncryptInit()
+ *          iii.    C_EncryptUpdate()
+ *          iv.     C_EncryptFinal()
+ *      3. Decrypt the output of step 2 in the same way, where the IV is taken apart with a shorter first
+ *      chunk, so the next chunks of the input are page-aligned too, using
+ *          i.      C_DecryptInit()
+ *          ii.     C_DecryptUpdate()
+ *          iii.    C_DecryptFinal()
+ *
+ * Note that the pages of both files are released behind the processed chunk, therefore, only about
+ * one chunk of each file is resident at a time and files larger than RAM can be processed.
+ * The memory mapping is POSIX, therefore, this program is not built on Windows.
+ *
+*/
+
+
+#ifndef FILE_CRYPT_HPP
+#define FILE_CRYPT_HPP
+
+#include <cstddef>
+#include <string>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * The default byte-length of the chunks given to C_EncryptUpdate() and C_DecryptUpdate() i.e., 8 MiB
+*/
+const size_t FILE_CRYPT_CHUNK_SIZE = 8 << 20;
+
+
+/**
+ * The statistics of encrypt_file() and decrypt_file() i.e., the byte-lengths of both files,
+ * the number of chunks and the time and throughput (of the input) in MiB/s
+*/
+struct file_crypt_stats
+{
+	unsigned long long bytesIn;
+	unsigned long long bytesOut;
+	unsigned long long chunkCount;
+	double seconds;
+	double MiBps;
+};
+
+
+int encrypt_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					file_crypt_stats& stats, const size_t chunkSz = FILE_CRYPT_CHUNK_SIZE);
+
+int decrypt_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					file_crypt_stats& stats, const size_t chunkSz = FILE_CRYPT_CHUNK_SIZE);
+
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * This program is an attempt to provision a large number of Advanced Encryption Standard (AES)
+ * keys e.g., tenant keys, across the pooled sessions of an async_executor.
+ * The following operations are performed
+ *
+ * 		1. Build the key template once and name every key by a label/ID pattern
+ *      i.e., prefix followed by the zero-padded index of the key
+ *      2. Split the keys into chunks, where every chunk is generated on one worker session
+ *      by reusing a copy of the template, and only CKA_LABEL and CKA_ID are updated per key using
+ *          i.      C_GenerateKey()
+ *      3. Report the progress on the calling thread and return the handles of the keys in a
+ *      contiguous array, ordered by index
+ *
+ * Note that the provisioning time scales down with the number of worker sessions as long as
+ * the token generates keys in parallel.
+ *
+*/
+
+
+#ifndef AES_KEYS_BULK_HPP
+#define AES_KEYS_BULK_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * The pattern of labels and IDs of the keys e.g., labelPrefix "tenant-" and width 6
+ * gives the labels "tenant-000000", "tenant-000001", ...
+ * An empty idPrefix means the keys do not have CKA_ID.
+*/
+struct key_name_pattern
+{
+	std::string labelPrefix;
+	std::string idPrefix;
+	size_t width;			// Minimum number of digits of the index
+};
+
+/**
+ * A callback invoked on the calling thread with the number of generated keys so far
+ * and the total number of keys
+*/
+typedef std::function<void(size_t, size_t)> bulk_progress;
+
+
+std::string key_name(const std::string& prefix, const size_t width, const size_t index);
+
+int gen_AES_keys_bulk(async_executor& executor, const CK_ULONG keyLen, const key_name_pattern& pattern,
+						const size_t keyCount, std::vector<CK_OBJECT_HANDLE>& hKeys,
+						bulk_progress progress);
+
+
+#endif
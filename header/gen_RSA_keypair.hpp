@@ -16,7 +16,7 @@
 
 
 int gen_RSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
-					size_t modBitSz, CK_BYTE_PTR const pubExpn, const size_t pubExpnSz,
+					const CK_ULONG modBitSz, CK_BYTE_PTR const pubExpn, const size_t pubExpnSz,
 					CK_OBJECT_HANDLE_PTR hPubPtr, CK_OBJECT_HANDLE_PTR hPrvPtr);
 
 
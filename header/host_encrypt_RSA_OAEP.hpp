@@ -0,0 +1,75 @@
+/**
+ * This program is an attempt to perform RSA-OAEP encryption on the host (CPU) using OpenSSL,
+ * since encryption only needs the public key, so encrypting to many recipients scales with
+ * CPU cores instead of the token. Decryption stays on the token i.e., decrypt_ciphertext().
+ * The following operations are performed
+ *
+ * 		1. Read the public key of a handle once using
+ *          i.      C_GetAttributeValue() i.e., CKA_MODULUS and CKA_PUBLIC_EXPONENT
+ *      2. Cache the host key per public key handle
+ *      3. Encrypt on the host with the same hash, MGF and encoding parameter (label) as
+ *      CKM_RSA_PKCS_OAEP using
+ *          i.      EVP_PKEY_encrypt()
+ *      4. If the host key cannot be built, then encrypt on the token using
+ *          i.      C_EncryptInit()
+ *          ii.     C_Encrypt()
+ *
+ * Note that the object handles are only valid within the application, therefore, a cache should
+ * be invalidated when a key is destroyed, and it should not outlive C_Finalize().
+ * Link with -lcrypto.
+ *
+*/
+
+
+#ifndef HOST_ENCRYPT_RSA_OAEP_HPP
+#define HOST_ENCRYPT_RSA_OAEP_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <openssl/evp.h>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+class host_rsa_encryptor
+{
+public:
+	host_rsa_encryptor(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_RSA_PKCS_OAEP_PARAMS& paramOAEP);
+
+	int encrypt(CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+				const std::string& plaintext, std::string& ciphertext);
+
+	void invalidate(const CK_OBJECT_HANDLE& hPub);
+
+	void clear();
+
+private:
+	host_rsa_encryptor(const host_rsa_encryptor&);
+	host_rsa_encryptor& operator=(const host_rsa_encryptor&);
+
+	typedef std::shared_ptr<EVP_PKEY> host_key;
+
+	host_key lookup(const CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub);
+
+	int encrypt_token(CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+						const std::string& plaintext, std::string& ciphertext);
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	CK_RSA_PKCS_OAEP_PARAMS paramOAEP;
+	std::string label;				// Copy of the encoding parameter of paramOAEP
+	std::mutex cacheMutex;
+	std::unordered_map<CK_OBJECT_HANDLE, host_key> keys;	// An empty key means the token should be used
+};
+
+
+CK_RSA_PKCS_OAEP_PARAMS default_OAEP_params();
+
+int load_host_RSA_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, EVP_PKEY*& hostKey);
+
+int encrypt_host_RSA_OAEP(EVP_PKEY* hostKey, const CK_RSA_PKCS_OAEP_PARAMS& paramOAEP,
+							const std::string& plaintext, std::string& ciphertext);
+
+
+#endif
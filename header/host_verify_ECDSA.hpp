@@ -0,0 +1,65 @@
+/**
+ * This program is an attempt to verify ECDSA signatures on the host (CPU) using OpenSSL,
+ * since verification only needs public data and the token is the bottleneck.
+ * The following operations are performed
+ *
+ * 		1. Read the public key of a handle once using
+ *          i.      C_GetAttributeValue() i.e., CKA_EC_PARAMS and CKA_EC_POINT
+ *      2. Parse and cache the host key per public key handle
+ *      3. Verify the signature (r || s as produced by CKM_ECDSA) on the host using
+ *          i.      EVP_PKEY_verify()
+ *      4. If the host key cannot be built e.g., the curve is not supported by OpenSSL, then verify
+ *      on the token using
+ *          i.      verify_data_no_hashing()
+ *
+ * Note that the object handles are only valid within the application, therefore, a cache should
+ * be invalidated when a key is destroyed, and it should not outlive C_Finalize().
+ * Link with -lcrypto.
+ *
+*/
+
+
+#ifndef HOST_VERIFY_ECDSA_HPP
+#define HOST_VERIFY_ECDSA_HPP
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <openssl/evp.h>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+class host_ecdsa_verifier
+{
+public:
+	explicit host_ecdsa_verifier(const CK_FUNCTION_LIST_PTR funclistPtr);
+
+	int verify(const CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+				CK_BYTE_PTR dataPtr, const CK_ULONG dataLen, CK_BYTE_PTR sigPtr, const CK_ULONG sigLen);
+
+	void invalidate(const CK_OBJECT_HANDLE& hPub);
+
+	void clear();
+
+private:
+	host_ecdsa_verifier(const host_ecdsa_verifier&);
+	host_ecdsa_verifier& operator=(const host_ecdsa_verifier&);
+
+	typedef std::shared_ptr<EVP_PKEY> host_key;
+
+	host_key lookup(const CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub);
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	std::mutex cacheMutex;
+	std::unordered_map<CK_OBJECT_HANDLE, host_key> keys;	// An empty key means the token should be used
+};
+
+
+int load_host_EC_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, EVP_PKEY*& hostKey);
+
+int verify_host_ECDSA(EVP_PKEY* hostKey, CK_BYTE_PTR dataPtr, const CK_ULONG dataLen,
+						CK_BYTE_PTR sigPtr, const CK_ULONG sigLen);
+
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * This program is an attempt to provide the file I/O of the streaming paths through a backend, so the
+ * per-chunk system calls can be cut down where the kernel supports io_uring. The following backends exist
+ *
+ * 		1. pread/pwrite backend, available everywhere (POSIX), where every queued operation is one system call
+ *      2. io_uring backend (Linux 5.1 and later), where
+ *          i.      the chunk buffers are registered once i.e., IORING_REGISTER_BUFFERS, so they are not
+ *                  mapped by the kernel for every operation (IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED)
+ *          ii.     the queued operations are submitted in batches by one io_uring_enter() call
+ *          iii.    a write can be linked to the next queued operation i.e., IOSQE_IO_LINK, so e.g. the read
+ *                  refilling a buffer starts after the write of that buffer has completed
+ *
+ * Note that io_uring is used through its system calls, therefore, liburing is not needed. It can be left out
+ * at build time by defining NO_IO_URING, and make_io_backend() falls back to pread/pwrite when io_uring
+ * cannot be set up at run time e.g., an old kernel or a container which blocks it.
+ *
+ * The streaming encryption and decryption of files (CKM_AES_CBC_PAD, the format of file_crypt.hpp) run on
+ * a backend as follows, where depth chunks are in flight
+ *
+ * 		1. The reads of the first depth chunks are queued
+ *      2. For every chunk in order, once its read has completed
+ *          i.      C_EncryptUpdate() or C_DecryptUpdate()
+ *          ii.     the write of its output is queued, linked to the read of the chunk depth ahead into the
+ *                  same buffers, so that read completing means the output buffer is free again
+ *      where a read which completes short before the end of the file is followed by a read of the rest of
+ *      the chunk into the same buffer, so only a read of 0 bytes tells the end of the file
+ *      3. The queued operations are submitted only when the next chunk is still being read, so one
+ *      submission carries the operations of all the chunks transformed meanwhile
+ *
+*/
+
+
+#ifndef IO_BACKEND_HPP
+#define IO_BACKEND_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * The backends of file I/O
+*/
+enum io_backend_type
+{
+	IO_BACKEND_PREAD,
+	IO_BACKEND_URING
+};
+
+
+/**
+ * The completion of a queued operation i.e., its tag and the byte-length transferred, or -errno on failure
+*/
+struct io_completion
+{
+	unsigned long long tag;
+	long long result;
+};
+
+
+class io_backend
+{
+public:
+	virtual ~io_backend() {}
+
+	virtual io_backend_type type() const = 0;
+
+	virtual const char* name() const = 0;
+
+	virtual int register_buffers(const std::vector<struct iovec>& buffers) = 0;
+
+	virtual int queue_read(const int fd, const size_t bufIndex, const size_t bufOffset, const size_t len,
+							const unsigned long long offset, const unsigned long long tag) = 0;
+
+	virtual int queue_write(const int fd, const size_t bufIndex, const size_t len, const unsigned long long offset,
+							const unsigned long long tag, const bool linkNext) = 0;
+
+	virtual int submit() = 0;
+
+	virtual size_t unsubmitted() const = 0;
+
+	virtual int wait(io_completion& completion) = 0;
+};
+
+
+std::unique_ptr<io_backend> make_io_backend(const io_backend_type type, const unsigned queueDepth);
+
+
+/**
+ * The default byte-length of the chunks and number of chunks in flight of the streaming operations
+ * i.e., 1 MiB, 8 chunks
+*/
+const size_t IO_CHUNK_SIZE = 1 << 20;
+const unsigned IO_QUEUE_DEPTH = 8;
+
+
+/**
+ * The statistics of a streaming operation i.e., the backend actually used, the byte-lengths, the number of
+ * chunks and of submissions, the wall time and the throughput (of the input) in MiB/s
+*/
+struct io_stream_stats
+{
+	const char* backend;
+	unsigned long long bytesIn;
+	unsigned long long bytesOut;
+	unsigned long long chunkCount;
+	unsigned long long submitCount;
+	double seconds;
+	double MiBps;
+};
+
+
+int encrypt_file_io(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					const io_backend_type type, io_stream_stats& stats, const size_t chunkSz = IO_CHUNK_SIZE,
+					const unsigned depth = IO_QUEUE_DEPTH);
+
+int decrypt_file_io(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					const io_backend_type type, io_stream_stats& stats, const size_t chunkSz = IO_CHUNK_SIZE,
+					const unsigned depth = IO_QUEUE_DEPTH);
+
+int benchmark_io_backends(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath,
+							const std::vector<size_t>& chunkSizes, const unsigned depth = IO_QUEUE_DEPTH);
+
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * This program is an attempt to manage the login state of an application on every token.
+ * The login state is shared by all sessions of an application with a token, therefore,
+ * logging in on every new session costs a round trip and logging out from one session
+ * logs out every other session too. The following operations are performed
+ *
+ * 		1. Login once per token on the first acquire using
+ *          i.      C_Login()
+ *          CKR_USER_ALREADY_LOGGED_IN is treated as success e.g., another part of the
+ *          application has logged in without the login manager
+ *      2. Count the references of every token, so the next acquires do not call the token
+ *      3. Logout when the last reference is released using
+ *          i.      C_Logout()
+ *
+ * Note that the tokens are identified by the pair of function list and slot ID, so tokens
+ * of different PKCS #11 libraries (modules) are kept apart.
+ *
+*/
+
+
+#ifndef LOGIN_MANAGER_HPP
+#define LOGIN_MANAGER_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+class login_manager
+{
+public:
+	login_manager();
+
+	int acquire(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+				const CK_SESSION_HANDLE& hSession, const std::string& usrPIN);
+
+	int ensure(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+				const std::string& usrPIN);
+
+	int release(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+				const CK_SESSION_HANDLE& hSession);
+
+	void forget(const CK_FUNCTION_LIST_PTR funclistPtr);
+
+	size_t references(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID);
+
+private:
+	login_manager(const login_manager&);
+	login_manager& operator=(const login_manager&);
+
+	typedef std::pair<CK_FUNCTION_LIST_PTR, CK_SLOT_ID> token_key;
+
+	std::mutex loginMutex;
+	std::map<token_key, size_t> tokens;		// Number of references of every logged in token
+};
+
+
+login_manager& application_login();
+
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * This program is an attempt to cache the mechanisms supported by the token of a slot,
+ * built once e.g., right after connect_slot(), so callers can pick a supported mechanism
+ * up front and fail fast without a round trip to the token. The following operations are performed
+ *
+ * 		1. Get the list of supported mechanisms using
+ *          i.      C_GetMechanismList()
+ *      2. Get the minimum and maximum key sizes and flags (e.g., CKF_HW, CKF_ENCRYPT, CKF_SIGN)
+ *      of every mechanism using
+ *          i.      C_GetMechanismInfo()
+ *      3. Check whether a mechanism is supported, or select the first supported mechanism
+ *      from a list ordered by preference e.g., fastest first
+ *      4. Keep the cache of every connected slot in the application mechanism registry, which
+ *      connect_slot() and slot_dispatcher fill once at connect time
+ *
+ * Note that the unit of key sizes depends on the mechanism e.g., bits for RSA and EC,
+ * bytes for AES, as reported by C_GetMechanismInfo().
+ *
+*/
+
+
+#ifndef MECHANISM_CACHE_HPP
+#define MECHANISM_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+class mechanism_cache
+{
+public:
+	mechanism_cache();
+
+	int build(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID);
+
+	int build_session(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession);
+
+	bool supports(const CK_MECHANISM_TYPE mechType, const CK_FLAGS requiredFlags = 0,
+					const CK_ULONG keySize = 0) const;
+
+	bool info(const CK_MECHANISM_TYPE mechType, CK_MECHANISM_INFO& mechInfo) const;
+
+	CK_MECHANISM_TYPE select(const std::vector<CK_MECHANISM_TYPE>& preferred,
+								const CK_FLAGS requiredFlags = 0, const CK_ULONG keySize = 0) const;
+
+	CK_SLOT_ID slot() const { return slotID; }
+
+	size_t size() const { return mechanisms.size(); }
+
+private:
+	CK_SLOT_ID slotID;
+	std::unordered_map<CK_MECHANISM_TYPE, CK_MECHANISM_INFO> mechanisms;
+};
+
+
+class mechanism_registry
+{
+public:
+	mechanism_registry();
+
+	int build(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID);
+
+	std::shared_ptr<const mechanism_cache> lookup(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID);
+
+	std::shared_ptr<const mechanism_cache> lookup_session(const CK_FUNCTION_LIST_PTR funclistPtr,
+															const CK_SESSION_HANDLE& hSession);
+
+	void forget(const CK_FUNCTION_LIST_PTR funclistPtr);
+
+private:
+	mechanism_registry(const mechanism_registry&);
+	mechanism_registry& operator=(const mechanism_registry&);
+
+	typedef std::pair<CK_FUNCTION_LIST_PTR, CK_SLOT_ID> token_key;
+
+	std::mutex registryMutex;
+	std::map<token_key, std::shared_ptr<const mechanism_cache> > caches;
+};
+
+
+mechanism_registry& application_mechanisms();
+
+
+int check_mechanism(const mechanism_cache& cache, const CK_MECHANISM_TYPE mechType,
+					const CK_FLAGS requiredFlags, const CK_ULONG keySize, const char* message);
+
+
+#endif
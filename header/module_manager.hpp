@@ -0,0 +1,100 @@
+/**
+ * This program is an attempt to load several PKCS #11 libraries (modules) at once e.g., several
+ * SoftHSM instances with separate token stores. Each module keeps its own CK_FUNCTION_LIST_PTR
+ * and slots, while all the slots are exposed as one unified slot namespace.
+ * The following operations are performed
+ *
+ *      1. Read the list of libraries from a configuration file or from an environment variable
+ *      e.g., SOFTHSM2_LIBS
+ *      2. Load every library and initialize it using
+ *          i.      C_GetFunctionList()
+ *          ii.     C_Initialize()
+ *      3. Build the unified slot namespace using
+ *          i.      C_GetSlotList()
+ *      4. Add the slots of all modules to slot_dispatcher
+ *      5. Finalize and unload all libraries using
+ *          i.      C_Finalize()
+ *
+ * The configuration file has one library per line followed by optional environment variables
+ * set before C_Initialize() of that library. Empty lines and lines starting with # are ignored
+ *      /opt/softhsm2-a/lib/libsofthsm2.so  SOFTHSM2_CONF=/disk1/softhsm2.conf
+ *      /opt/softhsm2-b/lib/libsofthsm2.so  SOFTHSM2_CONF=/disk2/softhsm2.conf
+ *
+ * Note that dlopen() returns the same handle for the same library path, therefore, every
+ * instance of the same library should be loaded from its own copy.
+ *
+*/
+
+
+#ifndef MODULE_MANAGER_HPP
+#define MODULE_MANAGER_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\slot_dispatcher.hpp"
+#else
+	#include "../header/slot_dispatcher.hpp"
+#endif
+
+
+struct pkcs11_module
+{
+	std::string libPath;
+	void* libHandle;
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	bool finalize;					// C_Initialize() was performed by the manager
+	std::vector<CK_SLOT_ID> slots;
+};
+
+
+/**
+ * A slot of the unified namespace i.e., the slot ID of given module
+*/
+struct unified_slot
+{
+	size_t moduleIndex;
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	CK_SLOT_ID slotID;
+};
+
+
+class module_manager
+{
+public:
+	module_manager();
+	~module_manager();
+
+	int load_config(const std::string& configPath);
+
+	int load_env(const char* envName);
+
+	int load_module(const std::string& libPath, const std::vector<std::string>& envAssign);
+
+	int refresh_slots();
+
+	void unload_all();
+
+	size_t module_count() const { return modules.size(); }
+
+	const pkcs11_module& module(const size_t moduleIndex) const { return modules[moduleIndex]; }
+
+	size_t slot_count() const { return unifiedSlots.size(); }
+
+	const unified_slot& slot(const size_t unifiedID) const { return unifiedSlots[unifiedID]; }
+
+private:
+	module_manager(const module_manager&);
+	module_manager& operator=(const module_manager&);
+
+	std::vector<pkcs11_module> modules;
+	std::vector<unified_slot> unifiedSlots;
+};
+
+
+int add_module_slots(const module_manager& manager, slot_dispatcher& dispatcher,
+						const key_selector& selector, const std::string& usrPIN,
+						const size_t workersPerSlot);
+
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * This program is an attempt to read the attributes (e.g., CKA_LABEL, CKA_MODULUS, CKA_EC_POINT)
+ * of one or many objects in batches. The following operations are performed
+ *
+ * 		1. Get the byte-lengths of all requested attributes of an object at once using
+ *          i.      C_GetAttributeValue() with NULL_PTR values
+ *      2. Allocate the values of all attributes from one bump-allocated arena
+ *      3. Get the values of all requested attributes of the object at once using
+ *          i.      C_GetAttributeValue()
+ *
+ * Therefore, an object needs at most two calls whatever the number of attributes, and reading
+ * tens of thousands of objects does not allocate per attribute.
+ *
+ * Note that a sensitive attribute (CKR_ATTRIBUTE_SENSITIVE) or an attribute not held by the
+ * object (CKR_ATTRIBUTE_TYPE_INVALID) is not an error, its ulValueLen is CK_UNAVAILABLE_INFORMATION.
+ *
+*/
+
+
+#ifndef OBJECT_ATTRIBUTES_HPP
+#define OBJECT_ATTRIBUTES_HPP
+
+#include <memory>
+#include <vector>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * A bump allocator, memory is only released all at once by reset() or destruction
+*/
+class attribute_arena
+{
+public:
+	explicit attribute_arena(const size_t blockSize = 64 * 1024);
+
+	CK_BYTE_PTR allocate(const size_t size);
+
+	void reset();
+
+	size_t used() const;
+
+private:
+	attribute_arena(const attribute_arena&);
+	attribute_arena& operator=(const attribute_arena&);
+
+	struct arena_block
+	{
+		std::unique_ptr<CK_BYTE[]> memory;
+		size_t size;
+	};
+
+	size_t blockSize;
+	std::vector<arena_block> blocks;
+	size_t current;		// Index of the block being allocated from
+	size_t offset;		// Offset of the next allocation in the current block
+};
+
+
+/**
+ * The attributes of an object, stored in an attribute_arena
+*/
+struct object_attributes
+{
+	CK_OBJECT_HANDLE hObject;
+	CK_ATTRIBUTE_PTR attributes;		// In the order of the requested attribute types
+	CK_ULONG count;
+	bool valid;							// false if the object could not be read
+
+	const CK_ATTRIBUTE* find(const CK_ATTRIBUTE_TYPE type) const;
+};
+
+
+int read_object_attributes(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE hObject, const std::vector<CK_ATTRIBUTE_TYPE>& types,
+							attribute_arena& arena, object_attributes& result);
+
+int read_attributes(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+					const std::vector<CK_OBJECT_HANDLE>& hObjects, const std::vector<CK_ATTRIBUTE_TYPE>& types,
+					attribute_arena& arena, std::vector<object_attributes>& results);
+
+
+#endif
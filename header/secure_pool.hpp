@@ -0,0 +1,161 @@
+/**
+ * This program is an attempt to keep sensitive data e.g., PINs, plaintext and key material, out of swap and
+ * core dumps, and to zeroize it when it is released. The following are provided
+ *
+ * 		1. A pool of slabs which are
+ *          i.      locked in memory i.e., mlock(), so they are never swapped out
+ *          ii.     left out of core dumps i.e., madvise(MADV_DONTDUMP)
+ *      and carved into blocks of size classes fitting typical buffers i.e., 16 (AES block, IV),
+ *      32 (AES-256 key, SHA-256), 64 (PIN, SHA-512, P-256 signature), 128, 256 (RSA-2048, P-521 signature),
+ *      512 (RSA-4096), 1024 (RSA-8192) and 4096 bytes. Larger buffers are mapped and locked on their own.
+ *      2. A cache of free blocks per thread, so most allocations and releases take no lock
+ *      3. Zeroization of every block on release, which the compiler cannot remove
+ *      4. secure_allocator, to hold the data of standard containers in the pool e.g., secure_bytes and
+ *      secure_string, and secure_wipe() to zeroize a string, including its short-string buffer
+ *
+ * Note that locking may be limited by RLIMIT_MEMLOCK (ulimit -l). If a slab cannot be locked, it is used
+ * anyway, and the failure is reported once.
+ *
+*/
+
+
+#ifndef SECURE_POOL_HPP
+#define SECURE_POOL_HPP
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+#include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
+
+
+/**
+ * The byte-lengths of the size classes and of the slabs, and the number of blocks moved at once between
+ * the cache of a thread and the pool
+*/
+const size_t SECURE_SIZE_CLASSES[] = {16, 32, 64, 128, 256, 512, 1024, 4096};
+const size_t SECURE_CLASS_COUNT = sizeof(SECURE_SIZE_CLASSES) / sizeof(SECURE_SIZE_CLASSES[0]);
+const size_t SECURE_SLAB_SIZE = 64 << 10;
+const size_t SECURE_CACHE_BATCH = 16;
+
+
+/**
+ * The statistics of the pool i.e., the slabs and the large buffers mapped, how much of them is locked,
+ * and the number of times the cache of a thread has been refilled from the pool
+*/
+struct secure_pool_stats
+{
+	size_t slabCount;
+	size_t slabBytes;
+	size_t largeCount;
+	size_t largeBytes;
+	size_t lockedBytes;
+	unsigned long long refillCount;
+};
+
+
+/**
+ * A free block, linked through its first bytes
+*/
+struct secure_block
+{
+	secure_block* next;
+};
+
+
+class secure_pool
+{
+public:
+	void* allocate(const size_t len);
+
+	void deallocate(void* ptr, const size_t len);
+
+	secure_pool_stats stats();
+
+	size_t refill(const size_t classIndex, secure_block*& head, const size_t count);
+
+	void release(const size_t classIndex, secure_block* head);
+
+private:
+	// The caches of the threads belong to the application pool, so it is the only one
+	friend secure_pool& application_secure_pool();
+
+	secure_pool();
+	secure_pool(const secure_pool&);
+	secure_pool& operator=(const secure_pool&);
+
+	int add_slab(const size_t classIndex);
+
+	void* map_locked(const size_t len);
+
+	std::mutex poolMutex;
+	secure_block* freeLists[SECURE_CLASS_COUNT];
+	std::map<void*, bool> largeBlocks;		// The buffers mapped on their own, and whether they are locked
+	secure_pool_stats poolStats;
+	bool lockFailed;
+};
+
+
+secure_pool& application_secure_pool();
+
+void secure_zero(void* ptr, const size_t len);
+
+
+/**
+ * An allocator of standard containers in the secure pool
+*/
+template <typename T>
+class secure_allocator
+{
+public:
+	typedef T value_type;
+
+	secure_allocator() {}
+
+	template <typename U>
+	secure_allocator(const secure_allocator<U>&) {}
+
+	T* allocate(const size_t n)
+	{
+		void* ptr = application_secure_pool().allocate(n * sizeof(T));
+		if (!ptr) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(ptr);
+	}
+
+	void deallocate(T* ptr, const size_t n)
+	{
+		application_secure_pool().deallocate(ptr, n * sizeof(T));
+	}
+};
+
+template <typename T, typename U>
+bool operator==(const secure_allocator<T>&, const secure_allocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const secure_allocator<T>&, const secure_allocator<U>&) { return false; }
+
+
+typedef std::vector<CK_BYTE, secure_allocator<CK_BYTE> > secure_bytes;
+
+typedef std::basic_string<char, std::char_traits<char>, secure_allocator<char> > secure_string;
+
+
+/**
+ * The function zeroizes the whole buffer of given string and clears it. A short string may be held
+ * in the string itself instead of the allocator, so this is needed before a secure_string is destroyed
+ * too, and clear() alone zeroizes nothing.
+*/
+template <typename Traits, typename Alloc>
+void secure_wipe(std::basic_string<char, Traits, Alloc>& str)
+{
+	str.resize(str.capacity());
+	secure_zero(&str[0], str.length());
+	str.clear();
+}
+
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * This program is an attempt to keep a session usable when it dies e.g., token reset,
+ * CKR_SESSION_CLOSED or CKR_DEVICE_REMOVED, without asking the user to reconnect.
+ * The following operations are performed
+ *
+ * 		1. Open a session and login with a cached credential using
+ *          i.      C_OpenSession()
+ *          ii.     C_Login() once per token, see login_manager
+ *      2. Perform an operation, and if it fails with a retryable CK_RV (see is_retryable_rv())
+ *          i.      Close the dead session i.e., C_CloseSession()
+ *          ii.     Re-open the session and re-login
+ *          iii.    Perform the operation again, which re-creates its operation context
+ *                  e.g., C_EncryptInit() in encrypt_plaintext()
+ *      3. Only idempotent operations are retried and within a bounded retry budget, though the
+ *      session is recovered after any operation losing it
+ *
+ * Note that a multi-part operation (e.g., C_EncryptUpdate()) cannot be resumed on a new
+ * session, therefore, it should be run as non-idempotent.
+ *
+*/
+
+
+#ifndef SESSION_RECOVERY_HPP
+#define SESSION_RECOVERY_HPP
+
+#include <functional>
+#include <string>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * The source of the user PIN e.g., reading it from the user or from a secret store.
+ * It returns integer 0 on success. Otherwise, non-zero integer is returned.
+ * It is called once and the credential is cached for re-login.
+*/
+typedef std::function<int(std::string&)> credential_source;
+
+
+class recoverable_session
+{
+public:
+	recoverable_session(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+						credential_source credentials, const unsigned retryBudget);
+	~recoverable_session();
+
+	int open();
+
+	int recover();
+
+	void close();
+
+	int run(token_operation operation, const bool idempotent);
+
+	CK_SESSION_HANDLE& handle() { return hSession; }
+
+private:
+	recoverable_session(const recoverable_session&);
+	recoverable_session& operator=(const recoverable_session&);
+
+	int login();
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	CK_SLOT_ID slotID;
+	CK_SESSION_HANDLE hSession;
+	bool opened;
+	bool holdsLogin;		// Whether a reference of the application login state is held
+	credential_source credentials;
+	std::string usrPIN;
+	bool pinCached;
+	unsigned retryBudget;
+};
+
+
+bool is_retryable_rv(const CK_RV rv);
+
+
+/**
+ * The function performs one of the existing operations e.g., encrypt_plaintext(),
+ * sign_data_no_hashing(), gen_AES_key(), etc. on a recoverable session where the first
+ * two parameters i.e., funclistPtr and hSession are supplied by the session.
+ *
+ * session is an alias of opened recoverable_session
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * idempotent tells whether the operation can be safely performed again
+ * function is the operation to be performed
+ * args are the remaining arguments of the function
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+template <typename Function, typename... Args>
+int run_recoverable(recoverable_session& session, const CK_FUNCTION_LIST_PTR funclistPtr,
+					const bool idempotent, Function function, Args&&... args)
+{
+	return session.run([&](CK_SESSION_HANDLE& hSession) {
+		return function(funclistPtr, hSession, args...);
+	}, idempotent);
+}
+
+
+#endif
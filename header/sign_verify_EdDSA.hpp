@@ -0,0 +1,70 @@
+/**
+ * This program is an attempt to sign and verify with the Edwards-curve Digital Signature Algorithm
+ * (EdDSA) i.e., Ed25519 and Ed448, where the token supports them. The following operations are performed
+ *
+ * 		1. Select the fastest Edwards curve supported by the token from the mechanism_cache of the slot,
+ * 		built at connect time (see application_mechanisms()) i.e., CKM_EC_EDWARDS_KEY_PAIR_GEN and CKM_EDDSA
+ * 		2. Generate EdDSA keypair (Public and Private keys) by invoking
+ *          i.		C_GenerateKeyPair()
+ * 		3. Sign data using private key of EdDSA by invoking
+ *          i.		C_SignInit()
+ *          ii.		C_Sign()
+ * 		4. Verify given signature on data using public key of EdDSA by invoking
+ *          i.      C_VerifyInit()
+ *          ii.     C_Verify()
+ *      5. Sign or verify many messages across the worker sessions of an async_executor
+ *
+ * Note that EdDSA hashes the data itself (PureEdDSA), therefore, the whole message is given to C_Sign()
+ * and not its digest as with CKM_ECDSA. If no Edwards curve is supported, the caller keeps using ECDSA
+ * (see sign_verify_ECDSA.hpp).
+ *
+*/
+
+
+#ifndef SIGN_VERIFY_EDDSA_HPP
+#define SIGN_VERIFY_EDDSA_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+	#include "..\header\mechanism_cache.hpp"
+#else
+	#include "../header/async_operation.hpp"
+	#include "../header/mechanism_cache.hpp"
+#endif
+
+
+/**
+ * The Edwards curves of EdDSA, ordered by preference i.e., fastest first
+*/
+enum edwards_curve
+{
+	ED25519,
+	ED448
+};
+
+
+int select_EdDSA_curve(const mechanism_cache& cache, edwards_curve& curve);
+
+CK_ULONG EdDSA_signature_length(const edwards_curve curve);
+
+int gen_EdDSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const edwards_curve curve, CK_OBJECT_HANDLE& hPub, CK_OBJECT_HANDLE& hPrv);
+
+int sign_EdDSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPrv, const edwards_curve curve,
+				const std::string& message, std::string& signature);
+
+int verify_EdDSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPub, const std::string& message, const std::string& signature);
+
+int sign_EdDSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPrv, const edwards_curve curve,
+						const std::vector<std::string>& messages, std::vector<std::string>& signatures);
+
+int verify_EdDSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPub,
+						const std::vector<std::string>& messages, const std::vector<std::string>& signatures,
+						std::vector<int>& results);
+
+
+#endif
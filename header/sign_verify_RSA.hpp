@@ -0,0 +1,80 @@
+/**
+ * This program is an attempt to sign and verify with the RSA keys of gen_RSA_keypair() using
+ * RSA-PSS and PKCS #1 v1.5. The following operations are performed
+ *
+ * 		1. Sign (verify) given message in a single part, where the token hashes the message
+ * 		e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS, using
+ *          i.		C_SignInit() (C_VerifyInit())
+ *          ii.		C_Sign() (C_Verify())
+ * 		2. Sign (verify) a message stream in multiple parts using
+ *          i.		C_SignInit() (C_VerifyInit())
+ *          ii.		C_SignUpdate() (C_VerifyUpdate())
+ *          iii.	C_SignFinal() (C_VerifyFinal())
+ * 		3. Sign (verify) the digest computed on the host i.e., CKM_RSA_PKCS_PSS and CKM_RSA_PKCS,
+ * 		so the message never goes to the token
+ *      4. Sign or verify many messages across the worker sessions of an async_executor
+ *
+ * Note that the PSS parameters are derived from the hash i.e., MGF1 with the same hash and
+ * the salt as long as the digest. The signature is as long as the modulus, therefore, the functions
+ * take the byte-length of the modulus (modBitLen / 8 of gen_RSA_keypair()) to skip asking the
+ * token for it, or 0 to ask.
+ *
+*/
+
+
+#ifndef SIGN_VERIFY_RSA_HPP
+#define SIGN_VERIFY_RSA_HPP
+
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+int sign_RSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech, const CK_ULONG modulusLen,
+				const std::string& message, std::string& signature);
+
+int verify_RSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech,
+				const std::string& message, const std::string& signature);
+
+int sign_RSA_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech);
+
+int sign_RSA_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					CK_BYTE_PTR const partPtr, const CK_ULONG partLen);
+
+int sign_RSA_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_ULONG modulusLen, std::string& signature);
+
+int verify_RSA_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech);
+
+int verify_RSA_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						CK_BYTE_PTR const partPtr, const CK_ULONG partLen);
+
+int verify_RSA_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const std::string& signature);
+
+int sign_RSA_digest(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE rawMech, const CK_MECHANISM_TYPE hashAlg,
+					const CK_ULONG modulusLen, const std::string& digest, std::string& signature);
+
+int verify_RSA_digest(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE rawMech, const CK_MECHANISM_TYPE hashAlg,
+						const std::string& digest, const std::string& signature);
+
+int sign_RSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech,
+					const CK_ULONG modulusLen, const std::vector<std::string>& messages,
+					std::vector<std::string>& signatures);
+
+int verify_RSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech,
+						const std::vector<std::string>& messages, const std::vector<std::string>& signatures,
+						std::vector<int>& results);
+
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * This program is an attempt to spread the PKCS #11 operations of this demonstration
+ * across all the slots (tokens) which hold the required key. The following operations
+ * are performed
+ *
+ * 		1. Get the list of slots with a token present using
+ *          i.      C_GetSlotList()
+ *      2. For every slot, login and find the required key (matched by CKA_LABEL and/or CKA_ID) using
+ *          i.      C_OpenSession()
+ *          ii.     C_Login()
+ *          iii.    C_FindObjectsInit(), C_FindObjects() and C_FindObjectsFinal()
+ *      3. Start an async_executor on every eligible slot
+ *      4. Route each operation to the least-loaded slot, i.e., the slot with the lowest
+ *      (queued operations + 1) * exponentially weighted moving average (EWMA) latency
+ *
+ * Note that Cryptoki library should be initialized before using the dispatcher.
+ *
+*/
+
+
+#ifndef SLOT_DISPATCHER_HPP
+#define SLOT_DISPATCHER_HPP
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef WIND
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/async_operation.hpp"
+#endif
+
+
+/**
+ * The attributes used to find the required key on every slot.
+ * An empty label or ID is not matched, and keyClass is not matched if it is
+ * CK_UNAVAILABLE_INFORMATION.
+*/
+struct key_selector
+{
+	std::string label;
+	std::string id;
+	CK_OBJECT_CLASS keyClass;
+};
+
+
+/**
+ * An operation to be performed with the key found on the chosen slot.
+ * It returns integer 0 on success. Otherwise, non-zero integer is returned.
+*/
+typedef std::function<int(CK_FUNCTION_LIST_PTR, CK_SESSION_HANDLE&, CK_OBJECT_HANDLE)> keyed_operation;
+
+
+class slot_dispatcher
+{
+public:
+	slot_dispatcher();
+	~slot_dispatcher();
+
+	int start(const CK_FUNCTION_LIST_PTR funclistPtr, const key_selector& selector,
+				const std::string& usrPIN, const size_t workersPerSlot);
+
+	int add_slot(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+					const key_selector& selector, const std::string& usrPIN,
+					const size_t workersPerSlot);
+
+	void stop();
+
+	std::future<int> submit(keyed_operation operation);
+
+	size_t slot_count() const { return slots.size(); }
+
+private:
+	struct dispatch_slot
+	{
+		CK_FUNCTION_LIST_PTR funclistPtr;
+		CK_SLOT_ID slotID;
+		CK_SESSION_HANDLE hControl;		// Session kept open to hold the login state
+		CK_OBJECT_HANDLE hKey;
+		async_executor executor;
+		std::atomic<size_t> pending;
+		std::atomic<double> ewmaMicros;
+	};
+
+	slot_dispatcher(const slot_dispatcher&);
+	slot_dispatcher& operator=(const slot_dispatcher&);
+
+	dispatch_slot* least_loaded();
+
+	std::vector<std::unique_ptr<dispatch_slot> > slots;
+};
+
+
+int find_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+				const key_selector& selector, CK_OBJECT_HANDLE& hKey);
+
+
+/**
+ * The function queues one of the existing operations e.g., encrypt_plaintext(),
+ * sign_data_no_hashing(), etc., on the least-loaded slot. The first three parameters
+ * i.e., funclistPtr, hSession and key handle are supplied by the dispatcher. The remaining
+ * arguments are copied, therefore, output parameters should be passed using std::ref().
+ *
+ * dispatcher is an alias of started slot_dispatcher
+ * function is the operation to be performed
+ * args are the remaining arguments of the function
+ *
+ * The std::future holding the value returned by function is returned.
+*/
+template <typename Function, typename... Args>
+std::future<int> dispatch_operation(slot_dispatcher& dispatcher, Function function, Args... args)
+{
+	return dispatcher.submit(std::bind(function, std::placeholders::_1, std::placeholders::_2,
+										std::placeholders::_3, args...));
+}
+
+
+#endif
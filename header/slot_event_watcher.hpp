@@ -0,0 +1,96 @@
+/**
+ * This program is an attempt to watch for token insertion and removal in a background thread
+ * and push the slot events to subscribers e.g., slot_inventory, session pools, dispatchers.
+ * The following operations are performed
+ *
+ * 		1. Wait for slot events using
+ *          i.      C_WaitForSlotEvent()
+ *      2. If the library does not support C_WaitForSlotEvent() i.e., CKR_FUNCTION_NOT_SUPPORTED,
+ *      then poll the token present flag of every slot using
+ *          i.      C_GetSlotList()
+ *          ii.     C_GetSlotInfo()
+ *      3. Push the event of the changed slot only, so subscribers update incrementally
+ *
+ * Note that the blocking form of C_WaitForSlotEvent() only returns when C_Finalize() is called,
+ * therefore, the watcher uses the non-blocking form i.e., CKF_DONT_BLOCK and sleeps between
+ * calls so stop() returns without finalizing the library.
+ *
+*/
+
+
+#ifndef SLOT_EVENT_WATCHER_HPP
+#define SLOT_EVENT_WATCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#ifdef WIND
+	#include "..\header\slots_token_list.hpp"
+#else
+	#include "../header/slots_token_list.hpp"
+#endif
+
+
+struct slot_event
+{
+	CK_SLOT_ID slotID;
+	bool tokenPresent;		// false also if the slot does not exist anymore
+};
+
+/**
+ * A callback invoked on the watcher thread for every slot event
+*/
+typedef std::function<void(const slot_event&)> slot_event_callback;
+
+
+class slot_event_watcher
+{
+public:
+	slot_event_watcher(const CK_FUNCTION_LIST_PTR funclistPtr, const std::chrono::milliseconds interval);
+	~slot_event_watcher();
+
+	size_t subscribe(slot_event_callback callback);
+
+	void unsubscribe(const size_t subscriberID);
+
+	int start();
+
+	void stop();
+
+	bool is_polling() const { return polling; }
+
+private:
+	slot_event_watcher(const slot_event_watcher&);
+	slot_event_watcher& operator=(const slot_event_watcher&);
+
+	void run();
+
+	int read_slot_states(std::map<CK_SLOT_ID, bool>& states);
+
+	void poll_slots();
+
+	void publish(const slot_event& event);
+
+	bool sleep_interval();
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	std::chrono::milliseconds interval;
+	std::map<CK_SLOT_ID, bool> knownSlots;		// Last known token present state of every slot
+	std::map<size_t, slot_event_callback> subscribers;
+	size_t nextSubscriberID;
+	std::mutex watcherMutex;
+	std::condition_variable stopRequested;
+	std::thread watcher;
+	bool stopping;
+	std::atomic<bool> polling;
+};
+
+
+void watch_inventory(slot_event_watcher& watcher, slot_inventory& inventory);
+
+
+#endif
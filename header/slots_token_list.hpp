@@ -6,6 +6,8 @@
  *      2. Display some slot and token information using 
  *          i.  C_GetSlotInfo() 
  *          ii. C_GetTokenInfo()
+ *      3. Keep an inventory of slot and token information which is cached for a given
+ *      time-to-live (TTL), so it can be queried without calling C_GetTokenInfo() every time
  * 
 */
 
@@ -13,8 +15,56 @@
 #ifndef SLOTS_TOKEN_LIST_HPP
 #define SLOTS_TOKEN_LIST_HPP
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <cryptoki.h>   // exist in include directory in the same program directory with gcc use -I/path/to/include
 
+
+/**
+ * The slot information and, if a token is present, the token information e.g., flags,
+ * session counts, free memory, etc.
+*/
+struct slot_token_info
+{
+	CK_SLOT_ID slotID;
+	CK_SLOT_INFO slotInfo;
+	bool tokenPresent;
+	CK_TOKEN_INFO tokenInfo;
+};
+
+
+class slot_inventory
+{
+public:
+	slot_inventory(const CK_FUNCTION_LIST_PTR funclistPtr, const std::chrono::milliseconds ttl);
+
+	int refresh();
+
+	int refresh_slot(const CK_SLOT_ID slotID);
+
+	bool lookup(const CK_SLOT_ID slotID, slot_token_info& info);
+
+	std::vector<slot_token_info> snapshot();
+
+private:
+	int refresh_locked();
+
+	bool is_stale() const;
+
+	CK_FUNCTION_LIST_PTR funclistPtr;
+	std::chrono::milliseconds ttl;
+	std::chrono::steady_clock::time_point refreshedAt;
+	bool refreshed;
+	std::unordered_map<CK_SLOT_ID, slot_token_info> slots;
+	std::mutex slotsMutex;
+};
+
+
+int get_slot_token_info(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+						slot_token_info& info);
+
 int display_all_slot_token(const CK_FUNCTION_LIST_PTR funclistPtr);
 
 #endif
\ No newline at end of file
@@ -1,19 +1,27 @@
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #ifdef WIND
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\gen_AES_keys.hpp"
     #include "..\header\AES_enc_dec.hpp"
+	#include "..\header\secure_pool.hpp"
 #else
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/gen_AES_keys.hpp"
     #include "../header/AES_enc_dec.hpp"
+	#include "../header/secure_pool.hpp"
 #endif
 
 
 using std::cout; 
 
 
+/**
+ * AES uses 128-bit (16-byte) block
+*/
+const size_t AES_BLOCK_LEN = 16;
+
 
 
 
@@ -109,13 +117,115 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
                         const std::string& plaintext, std::string& ciphertext)
 {
     int retVal = 0;
-    CK_BYTE_PTR ctPtr = NULL_PTR;
-    size_t ctLen = 0;
+
+    // The padding adds one block at most, so the ciphertext is encrypted into the string directly
+    ciphertext.resize(plaintext.length() + AES_BLOCK_LEN);
+    byte_span ctSpan(&ciphertext[0], ciphertext.length());
+    retVal = encrypt_plaintext(funclistPtr, hSession, hSecretkey, const_byte_span(plaintext), ctSpan);
+    ciphertext.resize(retVal ? 0 : ctSpan.size);
+
+	return retVal;
+}
+
+
+/**
+ * The function decrypts given ciphertext using Advanced Encryption Standard (AES) with 
+ * Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of secret key handle
+ * ciphertext is an alias of ciphertext (source) to be decrypted
+ * plaintext is an alias plaintext (destination) to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const std::string& ciphertext, std::string& decryptext)
+{
+	int retVal = 0;
+
+    // The plaintext is never longer than the ciphertext, so it is decrypted into the string directly
+    decryptext.resize(ciphertext.length());
+    byte_span dtSpan(&decryptext[0], decryptext.length());
+    retVal = decrypt_ciphertext(funclistPtr, hSession, hSecretkey, const_byte_span(ciphertext), dtSpan);
+    decryptext.resize(retVal ? 0 : dtSpan.size);
+
+	return retVal;
+}
+
+
+
+/**
+ * The function runs the single-part operation initialized i.e., C_Encrypt() or C_Decrypt(), writing into
+ * given output in place, which is not null. If the output is too small after all, the operation is finished
+ * into a scratch buffer, so the session can start another one, and the byte-length needed is returned in
+ * the size of output.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int single_part(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const bool encrypt,
+                        const const_byte_span& input, byte_span& output)
+{
+    int retVal = 0;
+    const char* opName = encrypt ? "C_Encrypt()" : "C_Decrypt()";
+    CK_ULONG outLen = output.size;
+    CK_RV rv = encrypt ? funclistPtr->C_Encrypt(hSession, input.ptr(), input.size, output.data, &outLen)
+                        : funclistPtr->C_Decrypt(hSession, input.ptr(), input.size, output.data, &outLen);
+
+    if (rv == CKR_BUFFER_TOO_SMALL) {
+        secure_bytes scratch(outLen);
+        cout << "Error, output of " << output.size << " bytes is too small, " << outLen << " bytes are needed\n";
+        output.size = outLen;
+        rv = encrypt ? funclistPtr->C_Encrypt(hSession, input.ptr(), input.size, scratch.data(), &outLen)
+                        : funclistPtr->C_Decrypt(hSession, input.ptr(), input.size, scratch.data(), &outLen);
+        check_operation(rv, opName);
+        return 1;
+    }
+    retVal = check_operation(rv, opName);
+    output.size = retVal ? 0 : outLen;
+    return retVal;
+}
+
+
+
+/**
+ * The function encrypts given data in place using Advanced Encryption Standard (AES) with 
+ * Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of secret key handle
+ * plaintext is an alias of constant span of the plaintext (source) to be encrypted
+ * ciphertext is an alias of span of the ciphertext (destination), whose size is its capacity on input,
+ * at least the byte-length of plaintext rounded up to the next whole block, and the byte-length of
+ * the ciphertext (or the byte-length needed, if too small) on return. If its data is null, only the
+ * byte-length needed is returned, and nothing is encrypted.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const const_byte_span& plaintext, byte_span& ciphertext)
+{
+    int retVal = 0;
 
     // Checking given pointers is null or not 
 	if (is_nullptr(funclistPtr)) {
 		return 4;
 	}
+    // The padding fills the last block, so the byte-length of the ciphertext is known before the operation
+    const size_t ctLen = (plaintext.size / AES_BLOCK_LEN + 1) * AES_BLOCK_LEN;
+    if (!ciphertext.data) {
+        ciphertext.size = ctLen;
+        return 0;
+    }
+    if (ciphertext.size < ctLen) {
+        cout << "Error, output of " << ciphertext.size << " bytes is too small, " << ctLen << " bytes are needed\n";
+        ciphertext.size = ctLen;
+        return 1;
+    }
 
     /**
      * CK_RV C_EncryptInit(CK_SESSION_HANDLE hSession,
@@ -137,25 +247,6 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
 	retVal = check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hSecretkey), "C_EncryptInit()");
     if (!retVal) {
         // The encryption operation successfully initialized
-        /**
-         * CK_RV C_EncryptUpdate(CK_SESSION_HANDLE hSession,
-         *                          CK_BYTE_PTR pPart,
-         *                          CK_ULONG ulPartLen,
-         *                          CK_BYTE_PTR pEncryptedPart,
-         *                          CK_ULONG_PTR pulEncryptedPartLen);
-         * 
-         * C_EncryptUpdate() continues a multiple-part encryption operation, processing another
-         * data part. 
-         * 
-         * hSession is the session’s handle; 
-         * pPart points to the data part; 
-         * ulPartLen is the length of the data part; 
-         * pEncryptedPart points to the location that receives the encrypted data part; 
-         * pulEncryptedPartLen points to the location that holds the length in bytes of the encrypted data part.
-         * 
-        */
-    //    retVal = check_operation(funclistPtr->C_EncryptUpdate(hSession, ptPtr, ptLen, ctPtr, &ctLen), "C_EncryptUpdate()");
-       
        /**
         * CK_RV C_Encrypt(CK_SESSION_HANDLE hSession,
         *                   CK_BYTE_PTR pData,
@@ -171,20 +262,7 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
         * pEncryptedData points to the location that receives the encrypted data; 
         * pulEncryptedDataLen points to the location that holds the length in bytes of the encrypted data.
        */
-      
-    //   cout << "Plaintext byte-length :: " << plaintext.length() << endl
-    //         << "Ciphertext byte-length :: " << ciphertext.length() << endl;
-
-      retVal = check_operation(funclistPtr->C_Encrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(plaintext.c_str())), 
-                                                        plaintext.length(), NULL_PTR, &ctLen), "C_Encrypt()");
-    //   cout << "Required ciphertext byte-length :: " << ctLen << endl;
-      ctPtr = new CK_BYTE[ctLen]; // Memory allocated
-
-      retVal = check_operation(funclistPtr->C_Encrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(plaintext.c_str())), 
-                                                        plaintext.length(), ctPtr, &ctLen), "C_Encrypt()");
-      ciphertext.assign(ctPtr, ctPtr + ctLen);
-
-      delete[] ctPtr;   // Memory de-allocated
+        retVal = single_part(funclistPtr, hSession, true, plaintext, ciphertext);
     }
 
 	return retVal;
@@ -192,29 +270,42 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
 
 
 /**
- * The function decrypts given ciphertext using Advanced Encryption Standard (AES) with 
+ * The function decrypts given ciphertext in place using Advanced Encryption Standard (AES) with 
  * Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD
  * 
  * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
  * hSession is an alias of session ID/handle
  * hSecretkey is an alias of secret key handle
- * ciphertext is an alias of ciphertext (source) to be decrypted
- * plaintext is an alias plaintext (destination) to be returned
+ * ciphertext is an alias of constant span of the ciphertext (source) to be decrypted
+ * decryptext is an alias of span of the plaintext (destination), whose size is its capacity on input,
+ * at most the byte-length of ciphertext is needed, and the byte-length of the plaintext (or the
+ * byte-length needed, if too small) on return. If its data is null, only the byte-length of ciphertext
+ * is returned, and nothing is decrypted.
  * 
  * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
 */
 int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
                         const CK_OBJECT_HANDLE& hSecretkey,
-                        const std::string& ciphertext, std::string& decryptext)
+                        const const_byte_span& ciphertext, byte_span& decryptext)
 {
 	int retVal = 0;
-    CK_BYTE_PTR dtPtr = NULL_PTR;
-    size_t dtLen = 0;
 
     // Checking given pointers is null or not 
 	if (is_nullptr(funclistPtr)) {
 		return 5;
 	}
+    // The plaintext is the ciphertext without the padding of 1 to 16 bytes, so at most its byte-length is
+    // needed, and less than one block short of it is too small
+    if (!decryptext.data) {
+        decryptext.size = ciphertext.size;
+        return 0;
+    }
+    if (decryptext.size + AES_BLOCK_LEN < ciphertext.size) {
+        cout << "Error, output of " << decryptext.size << " bytes is too small, " << ciphertext.size
+                << " bytes are needed\n";
+        decryptext.size = ciphertext.size;
+        return 1;
+    }
     /**
      * CK_RV C_DecryptInit(CK_SESSION_HANDLE hSession,
      *                      CK_MECHANISM_PTR pMechanism,
@@ -250,20 +341,157 @@ int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE
          * 
          * 
         */
-        // cout << "Ciphertext byte-length :: " << ciphertext.length() << endl
-        //      << "Decryptedtext byte-length :: " << decryptext.length() << endl;
-
-        retVal = check_operation(funclistPtr->C_Decrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(ciphertext.c_str())), 
-                                                        ciphertext.length(), NULL_PTR, &dtLen), "C_Decrypt()");
-                                                        
-        // cout << "Required decryptedtext byte-length :: " << dtLen << endl;
-        dtPtr = new CK_BYTE[dtLen]; // Memory allocated
-        
-        retVal = check_operation(funclistPtr->C_Decrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(ciphertext.c_str())), 
-                                                        ciphertext.length(), dtPtr, &dtLen), "C_Decrypt()");
-                                                        
-        decryptext.assign(dtPtr, dtPtr + dtLen);
-        delete[] dtPtr;   // Memory de-allocated
+        retVal = single_part(funclistPtr, hSession, false, ciphertext, decryptext);
+    }
+	return retVal;
+}
+
+
+
+/**
+ * The function runs the multi-part operation initialized i.e., C_EncryptUpdate() or C_DecryptUpdate()
+ * over every segment of the input, then C_EncryptFinal() or C_DecryptFinal(), writing into the output
+ * in place. An update outputs at most its input and the block held back before, so it is written into
+ * the output directly while the current segment has room, otherwise through a block-sized bounce buffer,
+ * which is zeroized at the end.
+ * The operation is finished also after a failure, so the session can start another one.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int multi_part(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const bool encrypt,
+                        const struct iovec* inIov, const size_t inCnt, iovec_writer& output)
+{
+    int retVal = 0;
+    CK_BYTE bounce[2 * AES_BLOCK_LEN];
+    auto update = [&](CK_BYTE_PTR partPtr, const size_t partLen, CK_BYTE_PTR outPtr, CK_ULONG& outLen) {
+        return check_operation(encrypt ? funclistPtr->C_EncryptUpdate(hSession, partPtr, partLen, outPtr, &outLen)
+                                        : funclistPtr->C_DecryptUpdate(hSession, partPtr, partLen, outPtr, &outLen),
+                                encrypt ? "C_EncryptUpdate()" : "C_DecryptUpdate()");
+    };
+
+    for (size_t i = 0; i < inCnt && !retVal; ++i) {
+        CK_BYTE_PTR partPtr = static_cast<CK_BYTE_PTR>(inIov[i].iov_base);
+        size_t leftLen = inIov[i].iov_len;
+        while (leftLen && !retVal) {
+            size_t partLen = 0;
+            CK_ULONG outLen = 0;
+            if (output.room() >= 2 * AES_BLOCK_LEN) {
+                partLen = std::min(leftLen, output.room() - AES_BLOCK_LEN);
+                outLen = output.room();
+                retVal = update(partPtr, partLen, output.current(), outLen);
+                if (!retVal) {
+                    output.advance(outLen);
+                }
+            }
+            else {
+                partLen = std::min(leftLen, AES_BLOCK_LEN);
+                outLen = sizeof(bounce);
+                retVal = update(partPtr, partLen, bounce, outLen);
+                if (!retVal) {
+                    retVal = output.write(bounce, outLen);
+                }
+            }
+            partPtr += partLen;
+            leftLen -= partLen;
+        }
+    }
+
+    CK_ULONG lastLen = sizeof(bounce);
+    CK_RV rv = encrypt ? funclistPtr->C_EncryptFinal(hSession, bounce, &lastLen)
+                        : funclistPtr->C_DecryptFinal(hSession, bounce, &lastLen);
+    if (!retVal) {
+        retVal = check_operation(rv, encrypt ? "C_EncryptFinal()" : "C_DecryptFinal()");
+    }
+    if (!retVal) {
+        retVal = output.write(bounce, lastLen);
+    }
+    // The bounce buffer held plaintext
+    secure_zero(bounce, sizeof(bounce));
+    return retVal;
+}
+
+
+
+/**
+ * The function encrypts given scatter-gather list in place using Advanced Encryption Standard (AES) with 
+ * Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of secret key handle
+ * ptIov is a pointer to the segments of the plaintext (source) to be encrypted, in order
+ * ptCnt is the number of segments of the plaintext
+ * ctIov is a pointer to the segments of the ciphertext (destination), in order, whose total byte-length is
+ * at least the byte-length of the plaintext rounded up to the next whole block
+ * ctCnt is the number of segments of the ciphertext
+ * ctLen is an alias of the byte-length of the ciphertext to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const struct iovec* ptIov, const size_t ptCnt,
+                        const struct iovec* ctIov, const size_t ctCnt, size_t& ctLen)
+{
+    int retVal = 0;
+    size_t ptLen = iovec_length(ptIov, ptCnt);
+    iovec_writer ctWriter(ctIov, ctCnt);
+
+    ctLen = 0;
+    // Checking given pointers is null or not 
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+    // Checking the room before starting, so the operation is not left with a partial ciphertext
+    if (iovec_length(ctIov, ctCnt) < (ptLen / AES_BLOCK_LEN + 1) * AES_BLOCK_LEN) {
+        cout << "Error, output of " << iovec_length(ctIov, ctCnt) << " bytes is too small, "
+                << (ptLen / AES_BLOCK_LEN + 1) * AES_BLOCK_LEN << " bytes are needed\n";
+        return 4;
+    }
+
+	retVal = check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hSecretkey), "C_EncryptInit()");
+    if (!retVal) {
+        retVal = multi_part(funclistPtr, hSession, true, ptIov, ptCnt, ctWriter);
+        ctLen = retVal ? 0 : ctWriter.written();
     }
 	return retVal;
-}
\ No newline at end of file
+}
+
+
+/**
+ * The function decrypts given scatter-gather list in place using Advanced Encryption Standard (AES) with 
+ * Cipher block chaining (CBC) mode i.e., CKM_AES_CBC_PAD
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of secret key handle
+ * ctIov is a pointer to the segments of the ciphertext (source) to be decrypted, in order
+ * ctCnt is the number of segments of the ciphertext
+ * dtIov is a pointer to the segments of the plaintext (destination), in order, whose total byte-length is
+ * at most the byte-length of the ciphertext
+ * dtCnt is the number of segments of the plaintext
+ * dtLen is an alias of the byte-length of the plaintext to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hSecretkey,
+                        const struct iovec* ctIov, const size_t ctCnt,
+                        const struct iovec* dtIov, const size_t dtCnt, size_t& dtLen)
+{
+    int retVal = 0;
+    iovec_writer dtWriter(dtIov, dtCnt);
+
+    dtLen = 0;
+    // Checking given pointers is null or not 
+	if (is_nullptr(funclistPtr)) {
+		return 5;
+	}
+
+	retVal = check_operation(funclistPtr->C_DecryptInit(hSession, &encMech, hSecretkey), "C_DecryptInit()");
+    if (!retVal) {
+        retVal = multi_part(funclistPtr, hSession, false, ctIov, ctCnt, dtWriter);
+        dtLen = retVal ? 0 : dtWriter.written();
+    }
+	return retVal;
+}
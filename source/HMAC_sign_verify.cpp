@@ -0,0 +1,366 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\attribute_template.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\HMAC_sign_verify.hpp"
+#else
+	#include "../header/attribute_template.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/HMAC_sign_verify.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The number of messages authenticated by one queued operation of the batch mode
+*/
+const size_t MESSAGES_PER_CHUNK = 64;
+
+
+/**
+ * The attributes template of HMAC keys i.e., generic secret keys used for signing and verifying only
+*/
+typedef attribute_template<fixed_attribute<CKA_CLASS, CKO_SECRET_KEY>,
+							fixed_attribute<CKA_KEY_TYPE, CKK_GENERIC_SECRET>,
+							fixed_attribute<CKA_TOKEN, CK_TRUE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							fixed_attribute<CKA_EXTRACTABLE, CK_FALSE>,
+							fixed_attribute<CKA_SIGN, CK_TRUE>,
+							fixed_attribute<CKA_VERIFY, CK_TRUE>,
+							variable_attribute<CKA_LABEL>,
+							variable_attribute<CKA_VALUE_LEN> > HMAC_key_template;
+
+
+
+/**
+ * The function gets the byte-length of the MAC of given mechanism, so the MAC is computed
+ * without asking the token for its length first.
+ *
+ * The byte-length is returned, or 0 if it is not known.
+*/
+static CK_ULONG mac_length(const CK_MECHANISM_TYPE macMech)
+{
+	switch (macMech) {
+	case CKM_SHA224_HMAC:	return 28;
+	case CKM_SHA256_HMAC:	return 32;
+	case CKM_SHA384_HMAC:	return 48;
+	case CKM_SHA512_HMAC:	return 64;
+	default:				return 0;
+	}
+}
+
+
+
+/**
+ * The function compares two byte strings in constant time i.e., the time does not depend on
+ * the position of the first different byte. Only the lengths, which are public, are compared first.
+ *
+ * If the byte strings are equal, true is returned. Otherwise, false is returned.
+*/
+bool constant_time_equal(const std::string& lhs, const std::string& rhs)
+{
+	volatile unsigned char diff = 0;
+
+	if (lhs.length() != rhs.length()) {
+		return false;
+	}
+	for (size_t i = 0; i < lhs.length(); ++i) {
+		diff |= static_cast<unsigned char>(lhs[i] ^ rhs[i]);
+	}
+	return !diff;
+}
+
+
+
+/**
+ * The function generates HMAC secret key i.e., CKK_GENERIC_SECRET
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * keyLen represents the length of the key in bytes, at least the output length of the hash
+ * e.g., 32 for CKM_SHA256_HMAC
+ * keyLabel is an alias of constant label of the key
+ * hKey is an alias of the HMAC key handle to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int gen_HMAC_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_ULONG keyLen, const std::string& keyLabel, CK_OBJECT_HANDLE& hKey)
+{
+	CK_MECHANISM keyMech = {CKM_GENERIC_SECRET_KEY_GEN};
+	HMAC_key_template keyAttrb;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	keyAttrb.set_bytes<CKA_LABEL>(keyLabel.c_str(), keyLabel.length());
+	keyAttrb.set<CKA_VALUE_LEN>(keyLen);
+
+	return check_operation(funclistPtr->C_GenerateKey(hSession, &keyMech, keyAttrb.data(), keyAttrb.size(), &hKey),
+							"C_GenerateKey()");
+}
+
+
+
+/**
+ * The function initializes a multi-part MAC computation
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hKey is an alias of constant HMAC key handle
+ * macMech is the HMAC mechanism e.g., CKM_SHA256_HMAC
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_HMAC_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech)
+{
+	// The HMAC mechanisms do not have a parameter
+	CK_MECHANISM mech = {macMech, NULL_PTR, 0};
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	return check_operation(funclistPtr->C_SignInit(hSession, &mech, hKey), "C_SignInit()");
+}
+
+
+
+/**
+ * The function continues a multi-part MAC computation with the next part of the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * partPtr is a constant pointer to the part of the message
+ * partLen represents the byte-length of the part
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_HMAC_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						CK_BYTE_PTR const partPtr, const CK_ULONG partLen)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+
+	/**
+	 * CK_RV C_SignUpdate(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG ulPartLen);
+	 *
+	 * C_SignUpdate() continues a multiple-part signature (MAC) operation, processing another
+	 * data part. On failure, the operation is terminated.
+	*/
+	return check_operation(funclistPtr->C_SignUpdate(hSession, partPtr, partLen), "C_SignUpdate()");
+}
+
+
+
+/**
+ * The function finishes a multi-part MAC computation
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * macMech is the HMAC mechanism given to sign_HMAC_init()
+ * mac is an alias of the MAC to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_HMAC_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_MECHANISM_TYPE macMech, std::string& mac)
+{
+	CK_ULONG macLen = mac_length(macMech);
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 5;
+	}
+
+	/**
+	 * CK_RV C_SignFinal(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pSignature, CK_ULONG_PTR pulSignatureLen);
+	 *
+	 * C_SignFinal() finishes a multiple-part signature (MAC) operation. If pSignature is NULL_PTR,
+	 * then only the length is returned and the operation is not finished.
+	*/
+	if (!macLen && check_operation(funclistPtr->C_SignFinal(hSession, NULL_PTR, &macLen), "C_SignFinal()")) {
+		return 5;
+	}
+	mac.resize(macLen);
+	if (check_operation(funclistPtr->C_SignFinal(hSession, reinterpret_cast<CK_BYTE_PTR>(&mac[0]), &macLen),
+						"C_SignFinal()")) {
+		return 5;
+	}
+	mac.resize(macLen);
+	return 0;
+}
+
+
+
+/**
+ * The function finishes a multi-part MAC computation and compares the MAC with given MAC
+ * in constant time
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * macMech is the HMAC mechanism given to sign_HMAC_init()
+ * mac is an alias of constant MAC to be verified
+ *
+ * On success i.e., the MAC is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_HMAC_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_MECHANISM_TYPE macMech, const std::string& mac)
+{
+	std::string computed;
+
+	if (sign_HMAC_final(funclistPtr, hSession, macMech, computed)) {
+		return 6;
+	}
+	if (!constant_time_equal(computed, mac)) {
+		cout << "Error, MAC is not valid\n";
+		return 6;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function computes the MAC of given message in a single part
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hKey is an alias of constant HMAC key handle
+ * macMech is the HMAC mechanism e.g., CKM_SHA256_HMAC
+ * message is an alias of constant message to be authenticated
+ * mac is an alias of the MAC to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_HMAC(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+				const std::string& message, std::string& mac)
+{
+	CK_ULONG macLen = mac_length(macMech);
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+
+	if (sign_HMAC_init(funclistPtr, hSession, hKey, macMech)) {
+		return 7;
+	}
+	if (!macLen && check_operation(funclistPtr->C_Sign(hSession, msgPtr, message.length(), NULL_PTR, &macLen),
+									"C_Sign()")) {
+		return 7;
+	}
+	mac.resize(macLen);
+	if (check_operation(funclistPtr->C_Sign(hSession, msgPtr, message.length(),
+											reinterpret_cast<CK_BYTE_PTR>(&mac[0]), &macLen), "C_Sign()")) {
+		return 7;
+	}
+	mac.resize(macLen);
+	return 0;
+}
+
+
+
+/**
+ * The function verifies the MAC of given message by computing the MAC on the token and
+ * comparing both in constant time
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hKey is an alias of constant HMAC key handle
+ * macMech is the HMAC mechanism e.g., CKM_SHA256_HMAC
+ * message is an alias of constant message
+ * mac is an alias of constant MAC to be verified
+ *
+ * On success i.e., the MAC is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_HMAC(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+				const std::string& message, const std::string& mac)
+{
+	std::string computed;
+
+	if (sign_HMAC(funclistPtr, hSession, hKey, macMech, message, computed)) {
+		return 8;
+	}
+	if (!constant_time_equal(computed, mac)) {
+		cout << "Error, MAC is not valid\n";
+		return 8;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function computes (or verifies if macs is not NULL_PTR) the MACs of the messages in chunks
+ * across the worker sessions of given executor, see async_batch().
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int HMAC_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+						const std::vector<std::string>& messages, std::string* computedMacs,
+						const std::string* macs, std::vector<int>& results)
+{
+	results.assign(messages.size(), 0);
+	if (async_batch(executor, messages.size(), MESSAGES_PER_CHUNK,
+					[&](const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const size_t i) {
+						return macs ? verify_HMAC(funclistPtr, hSession, hKey, macMech, messages[i], macs[i])
+									: sign_HMAC(funclistPtr, hSession, hKey, macMech, messages[i], computedMacs[i]);
+					}, results.data())) {
+		return 9;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function computes the MACs of many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hKey is an alias of constant HMAC key handle
+ * macMech is the HMAC mechanism e.g., CKM_SHA256_HMAC
+ * messages is an alias of constant list of messages
+ * macs is an alias of the MACs to be returned, where macs[i] is the MAC of messages[i]
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_HMAC_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+					const std::vector<std::string>& messages, std::vector<std::string>& macs)
+{
+	std::vector<int> results;
+
+	macs.assign(messages.size(), std::string());
+	return HMAC_batch(executor, hKey, macMech, messages, macs.data(), NULL_PTR, results);
+}
+
+
+
+/**
+ * The function verifies the MACs of many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hKey is an alias of constant HMAC key handle
+ * macMech is the HMAC mechanism e.g., CKM_SHA256_HMAC
+ * messages is an alias of constant list of messages
+ * macs is an alias of constant list of MACs, where macs[i] is the MAC of messages[i]
+ * results is an alias of the results, where results[i] is 0 if macs[i] is valid
+ *
+ * On success i.e., all MACs are valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_HMAC_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE macMech,
+						const std::vector<std::string>& messages, const std::vector<std::string>& macs,
+						std::vector<int>& results)
+{
+	if (macs.size() != messages.size()) {
+		cout << "Error, number of MACs and messages are different\n";
+		return 10;
+	}
+	return HMAC_batch(executor, hKey, macMech, messages, NULL_PTR, macs.data(), results);
+}
@@ -1,13 +1,24 @@
+#include <cstring>
 #include <iostream>
 #ifdef WIND
 	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\mechanism_cache.hpp"
 	#include "..\header\RSA_OAEP_enc_dec.hpp"
+	#include "..\header\secure_pool.hpp"
 #else
 	#include "../header/common_basic_operation.hpp"
+	#include "../header/mechanism_cache.hpp"
 	#include "../header/RSA_OAEP_enc_dec.hpp"
+	#include "../header/secure_pool.hpp"
 #endif
 
 
+/**
+ * The byte-length of the largest modulus i.e., 8192-bit, which bounds the ciphertext
+*/
+const size_t RSA_MAX_MODULUS_LEN = 1024;
+
+
 /**
  * CK_RSA_PKCS_OAEP_PARAMS is a structure that provides the parameters to the
  * CKM_RSA_PKCS_OAEP mechanism. The structure is defined as follows:
@@ -32,28 +43,33 @@ CK_RSA_PKCS_OAEP_PARAMS paramOAEP;
 
 /**
  * The function initializes the Optimal Asymmetric Encryption Padding (OAEP)
- * parameters to be used in the CKM_RSA_PKCS_OAEP mechanism
+ * parameters to be used in the CKM_RSA_PKCS_OAEP mechanism, after checking in the mechanism
+ * cache of the slot that the token supports CKM_RSA_PKCS_OAEP for given operation, so an
+ * unsupported operation fails before C_EncryptInit() or C_DecryptInit().
  * 
- * The function does not return anything.
+ * The hash is SHA-1. C_GetMechanismList() reports the hashes the token supports as digests,
+ * not the hashes OAEP accepts e.g., softHSM2 version 2.6.1 supports CKM_SHA256, though it
+ * rejects an OAEP hash other than CKM_SHA_1 with CKR_ARGUMENTS_BAD, so the hash is not selected
+ * from the cache.
  * 
- * TODO: this function might be moved to main() for direct initialization
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * operationFlag is the flag of the operation i.e., CKF_ENCRYPT or CKF_DECRYPT
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
  */
-inline void init_OAEP()
+static int init_OAEP(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_FLAGS operationFlag)
 {
+    std::shared_ptr<const mechanism_cache> cache = application_mechanisms().lookup_session(funclistPtr, hSession);
+
+    // Without a cache i.e., the slot was not connected by connect_slot(), the token checks the mechanism
+    if (cache && check_mechanism(*cache, CKM_RSA_PKCS_OAEP, operationFlag, 0,
+                                    operationFlag == CKF_ENCRYPT ? "RSA-OAEP encryption" : "RSA-OAEP decryption")) {
+        return 1;
+    }
     paramOAEP.hashAlg = CKM_SHA_1;
     paramOAEP.mgf = CKG_MGF1_SHA1;
-    
-    // It seems the softHSM2 version 2.6.1 does not support SHA256
-    // paramOAEP.hashAlg = CKM_SHA256;
-    // paramOAEP.mgf = CKG_MGF1_SHA256;
-
-    // It seems the softHSM2 version 2.6.1 does not support SHA384
-    // paramOAEP.hashAlg = CKM_SHA384;
-    // paramOAEP.mgf = CKG_MGF1_SHA384;
-
-    // It seems the softHSM2 version 2.6.1 does not support SHA512
-    // paramOAEP.hashAlg = CKM_SHA512;
-    // paramOAEP.mgf = CKG_MGF1_SHA512;
     /**
      * CKZ_DATA_SPECIFIED is an array of CK_BYTE containing the value
      * of the encoding parameter. If the parameter is empty, 
@@ -62,7 +78,7 @@ inline void init_OAEP()
     paramOAEP.source = CKZ_DATA_SPECIFIED;
     paramOAEP.pSourceData = NULL;
     paramOAEP.ulSourceDataLen = 0;
-    
+    return 0;
 }
 
 
@@ -82,14 +98,140 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
                     std::string& ciphertext)
 {
     int retVal = 0;
-    CK_BYTE_PTR ctPtr = NULL_PTR;
-    size_t ctLen = 0;
+
+    // The ciphertext is as long as the modulus, so it is encrypted into the string directly
+    ciphertext.resize(RSA_MAX_MODULUS_LEN);
+    byte_span ctSpan(&ciphertext[0], ciphertext.length());
+    retVal = encrypt_plaintext(funclistPtr, hSession, hPub, const_byte_span(plaintext), ctSpan);
+    ciphertext.resize(retVal ? 0 : ctSpan.size);
+    return retVal;
+}
+
+
+
+/**
+ * The function encrypts given plaintext using RAS-OAEP
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of private key handle
+ * ciphertext is an alias ciphertext (source) to be decrypted
+ * plaintext is an alias of plaintext (destination) to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned. 
+ */
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hPrv, const std::string& ciphertext,
+                        std::string& plaintext)
+{
+    int retVal = 0;
+
+    // The plaintext is shorter than the ciphertext, so it is decrypted into the string directly
+    plaintext.resize(ciphertext.length());
+    byte_span dtSpan(&plaintext[0], plaintext.length());
+    retVal = decrypt_ciphertext(funclistPtr, hSession, hPrv, const_byte_span(ciphertext), dtSpan);
+    plaintext.resize(retVal ? 0 : dtSpan.size);
+    return retVal;
+}
+
+
+
+/**
+ * The function runs the single-part operation initialized i.e., C_Encrypt() or C_Decrypt(), writing into
+ * given output in place, which is not null. If the output is too small after all, the operation is finished
+ * into a scratch buffer, so the session can start another one, and the byte-length needed is returned in
+ * the size of output.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int single_part(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const bool encrypt,
+                        const const_byte_span& input, byte_span& output)
+{
+    int retVal = 0;
+    const char* opName = encrypt ? "C_Encrypt()" : "C_Decrypt()";
+    CK_ULONG outLen = output.size;
+    CK_RV rv = encrypt ? funclistPtr->C_Encrypt(hSession, input.ptr(), input.size, output.data, &outLen)
+                        : funclistPtr->C_Decrypt(hSession, input.ptr(), input.size, output.data, &outLen);
+
+    if (rv == CKR_BUFFER_TOO_SMALL) {
+        secure_bytes scratch(outLen);
+        std::cout << "Error, output of " << output.size << " bytes is too small, " << outLen << " bytes are needed\n";
+        output.size = outLen;
+        rv = encrypt ? funclistPtr->C_Encrypt(hSession, input.ptr(), input.size, scratch.data(), &outLen)
+                        : funclistPtr->C_Decrypt(hSession, input.ptr(), input.size, scratch.data(), &outLen);
+        check_operation(rv, opName);
+        return 1;
+    }
+    retVal = check_operation(rv, opName);
+    output.size = retVal ? 0 : outLen;
+    return retVal;
+}
+
+
+
+/**
+ * The function gets the byte-length of the modulus of given RSA key i.e., CKA_MODULUS_BITS rounded up
+ * to whole bytes, which is the byte-length of the ciphertext
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int modulus_length(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                            const CK_OBJECT_HANDLE& hKey, size_t& modLen)
+{
+    CK_ULONG modBits = 0;
+    CK_ATTRIBUTE attrb = {CKA_MODULUS_BITS, &modBits, sizeof(modBits)};
+    int retVal = check_operation(funclistPtr->C_GetAttributeValue(hSession, hKey, &attrb, 1), "C_GetAttributeValue()");
+
+    modLen = retVal ? 0 : (modBits + 7) / 8;
+    return retVal;
+}
+
+
+
+/**
+ * The function encrypts given plaintext in place using RAS-OAEP
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of public key handle
+ * plaintext is an alias of constant span of the plaintext (source) to be encrypted
+ * ciphertext is an alias of span of the ciphertext (destination), whose size is its capacity on input,
+ * at least the byte-length of the modulus, and the byte-length of the ciphertext (or the byte-length
+ * needed, if too small) on return. If its data is null, only the byte-length of the modulus is returned,
+ * and nothing is encrypted.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned. 
+ */
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hPub, const const_byte_span& plaintext,
+                    byte_span& ciphertext)
+{
+    int retVal = 0;
     
     // Checking given pointers is null or not 
 	if (is_nullptr(funclistPtr)) {
 		return 4;
 	}
-	init_OAEP();
+    // The ciphertext is as long as the modulus, which is read only when the output may not hold it
+    if (!ciphertext.data || ciphertext.size < RSA_MAX_MODULUS_LEN) {
+        size_t modLen = 0;
+        if (modulus_length(funclistPtr, hSession, hPub, modLen)) {
+            return 4;
+        }
+        if (!ciphertext.data) {
+            ciphertext.size = modLen;
+            return 0;
+        }
+        if (ciphertext.size < modLen) {
+            std::cout << "Error, output of " << ciphertext.size << " bytes is too small, " << modLen
+                        << " bytes are needed\n";
+            ciphertext.size = modLen;
+            return 1;
+        }
+    }
+	if (init_OAEP(funclistPtr, hSession, CKF_ENCRYPT)) {
+        return 4;
+    }
 	CK_MECHANISM encMech = {CKM_RSA_PKCS_OAEP, &paramOAEP, sizeof(paramOAEP)};
 
 	// For debugging purpose
@@ -101,15 +243,7 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
     
 	if (!retVal) {
         // The encryption operation successfully initialized
-        retVal = check_operation(funclistPtr->C_Encrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(plaintext.c_str())),
-                                            plaintext.length(), NULL_PTR, &ctLen), "C_Encrypt()");
-                                            
-        ctPtr = new CK_BYTE[ctLen];
-        retVal = check_operation(funclistPtr->C_Encrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(plaintext.c_str())),
-                                            plaintext.length(), ctPtr, &ctLen), "C_Encrypt()");
-
-        ciphertext.assign(ctPtr, ctPtr + ctLen);
-        delete[] ctPtr;   // Memory de-allocated
+        retVal = single_part(funclistPtr, hSession, true, plaintext, ciphertext);
     }
     return retVal;
 }
@@ -117,43 +251,160 @@ int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE&
 
 
 /**
- * The function encrypts given plaintext using RAS-OAEP
+ * The function decrypts given ciphertext in place using RAS-OAEP
  * 
  * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
  * hSession is an alias of session ID/handle
  * hPrv is an alias of private key handle
- * ciphertext is an alias ciphertext (source) to be decrypted
- * plaintext is an alias of plaintext (destination) to be returned
+ * ciphertext is an alias of constant span of the ciphertext (source) to be decrypted
+ * plaintext is an alias of span of the plaintext (destination), whose size is its capacity on input,
+ * at most the byte-length of ciphertext is needed, and the byte-length of the plaintext (or the
+ * byte-length needed, if too small) on return. If its data is null, only the byte-length of ciphertext
+ * is returned, and nothing is decrypted.
  * 
  * On success, integer 0 is returned. Otherwise, non-zero integer is returned. 
  */
 int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
-                        const CK_OBJECT_HANDLE& hPrv, const std::string& ciphertext,
-                        std::string& plaintext)
+                        const CK_OBJECT_HANDLE& hPrv, const const_byte_span& ciphertext,
+                        byte_span& plaintext)
 {
     int retVal = 0;
-    CK_BYTE_PTR dtPtr = NULL_PTR;
-    size_t dtLen = 0;
     
     // Checking given pointers is null or not 
 	if (is_nullptr(funclistPtr)) {
 		return 4;
 	}
+    // The plaintext is shorter than the ciphertext, whose byte-length bounds it
+    if (!plaintext.data) {
+        plaintext.size = ciphertext.size;
+        return 0;
+    }
+	if (init_OAEP(funclistPtr, hSession, CKF_DECRYPT)) {
+        return 4;
+    }
 	CK_MECHANISM encMech = {CKM_RSA_PKCS_OAEP, &paramOAEP, sizeof(paramOAEP)};
 	
     retVal = check_operation(funclistPtr->C_DecryptInit(hSession, &encMech, hPrv), "C_DecryptInit()");
     
 	if (!retVal) {
-        // The encryption operation successfully initialized
-        retVal = check_operation(funclistPtr->C_Decrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(ciphertext.c_str())),
-                                            ciphertext.length(), NULL_PTR, &dtLen), "C_Decrypt()");
-                                            
-        dtPtr = new CK_BYTE[dtLen];
-        retVal = check_operation(funclistPtr->C_Decrypt(hSession, reinterpret_cast<CK_CHAR_PTR>(const_cast<char*>(ciphertext.c_str())),
-                                            ciphertext.length(), dtPtr, &dtLen), "C_Decrypt()");
-
-        plaintext.assign(dtPtr, dtPtr + dtLen);
-        delete[] dtPtr;   // Memory de-allocated
+        // The decryption operation successfully initialized
+        retVal = single_part(funclistPtr, hSession, false, ciphertext, plaintext);
     }
     return retVal;
-}
\ No newline at end of file
+}
+
+
+
+/**
+ * The function gets the source of a single-part operation from given segments i.e., the segment itself
+ * if there is one, otherwise the segments gathered into given buffer of RSA_MAX_MODULUS_LEN bytes
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int gather_input(const struct iovec* iov, const size_t iovCnt, CK_BYTE_PTR bufPtr, const_byte_span& input)
+{
+    size_t len = iovec_length(iov, iovCnt);
+
+    if (iovCnt == 1) {
+        input = const_byte_span(iov[0].iov_base, len);
+        return 0;
+    }
+    if (len > RSA_MAX_MODULUS_LEN) {
+        std::cout << "Error, input of " << len << " bytes is longer than the modulus\n";
+        return 1;
+    }
+    for (size_t i = 0, offset = 0; i < iovCnt; offset += iov[i].iov_len, ++i) {
+        std::memcpy(bufPtr + offset, iov[i].iov_base, iov[i].iov_len);
+    }
+    input = const_byte_span(bufPtr, len);
+    return 0;
+}
+
+
+
+/**
+ * The function encrypts given scatter-gather list using RAS-OAEP. Since RSA-OAEP is single-part only,
+ * several segments are gathered and scattered through a buffer of the largest modulus, on the stack,
+ * which is zeroized at the end.
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of public key handle
+ * ptIov is a pointer to the segments of the plaintext (source) to be encrypted, in order
+ * ptCnt is the number of segments of the plaintext
+ * ctIov is a pointer to the segments of the ciphertext (destination), in order, whose total byte-length is
+ * at least the byte-length of the modulus
+ * ctCnt is the number of segments of the ciphertext
+ * ctLen is an alias of the byte-length of the ciphertext to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned. 
+ */
+int encrypt_plaintext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                    const CK_OBJECT_HANDLE& hPub, const struct iovec* ptIov, const size_t ptCnt,
+                    const struct iovec* ctIov, const size_t ctCnt, size_t& ctLen)
+{
+    int retVal = 0;
+    CK_BYTE gathered[RSA_MAX_MODULUS_LEN];
+    CK_BYTE scattered[RSA_MAX_MODULUS_LEN];
+    const_byte_span ptSpan;
+    byte_span ctSpan = ctCnt == 1 ? byte_span(ctIov[0].iov_base, ctIov[0].iov_len)
+                                    : byte_span(scattered, sizeof(scattered));
+
+    ctLen = 0;
+    retVal = gather_input(ptIov, ptCnt, gathered, ptSpan);
+    if (!retVal) {
+        retVal = encrypt_plaintext(funclistPtr, hSession, hPub, ptSpan, ctSpan);
+    }
+    if (!retVal && ctCnt != 1) {
+        iovec_writer ctWriter(ctIov, ctCnt);
+        retVal = ctWriter.write(ctSpan.data, ctSpan.size);
+    }
+    ctLen = retVal ? 0 : ctSpan.size;
+    secure_zero(gathered, sizeof(gathered));
+    secure_zero(scattered, sizeof(scattered));
+    return retVal;
+}
+
+
+
+/**
+ * The function decrypts given scatter-gather list using RAS-OAEP. Since RSA-OAEP is single-part only,
+ * several segments are gathered and scattered through a buffer of the largest modulus, on the stack,
+ * which is zeroized at the end.
+ * 
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of private key handle
+ * ctIov is a pointer to the segments of the ciphertext (source) to be decrypted, in order
+ * ctCnt is the number of segments of the ciphertext
+ * ptIov is a pointer to the segments of the plaintext (destination), in order
+ * ptCnt is the number of segments of the plaintext
+ * ptLen is an alias of the byte-length of the plaintext to be returned
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned. 
+ */
+int decrypt_ciphertext(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+                        const CK_OBJECT_HANDLE& hPrv, const struct iovec* ctIov, const size_t ctCnt,
+                        const struct iovec* ptIov, const size_t ptCnt, size_t& ptLen)
+{
+    int retVal = 0;
+    CK_BYTE gathered[RSA_MAX_MODULUS_LEN];
+    CK_BYTE scattered[RSA_MAX_MODULUS_LEN];
+    const_byte_span ctSpan;
+    byte_span ptSpan = ptCnt == 1 ? byte_span(ptIov[0].iov_base, ptIov[0].iov_len)
+                                    : byte_span(scattered, sizeof(scattered));
+
+    ptLen = 0;
+    retVal = gather_input(ctIov, ctCnt, gathered, ctSpan);
+    if (!retVal) {
+        retVal = decrypt_ciphertext(funclistPtr, hSession, hPrv, ctSpan, ptSpan);
+    }
+    if (!retVal && ptCnt != 1) {
+        iovec_writer ptWriter(ptIov, ptCnt);
+        retVal = ptWriter.write(ptSpan.data, ptSpan.size);
+    }
+    ptLen = retVal ? 0 : ptSpan.size;
+    secure_zero(gathered, sizeof(gathered));
+    secure_zero(scattered, sizeof(scattered));
+    return retVal;
+}
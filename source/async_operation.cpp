@@ -0,0 +1,236 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\async_operation.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/async_operation.hpp"
+#endif
+
+
+using std::cout;
+
+
+
+async_executor::async_executor() : funclistPtr(NULL_PTR), stopping(false)
+{
+}
+
+
+async_executor::~async_executor()
+{
+	stop();
+}
+
+
+
+/**
+ * The function starts the worker threads on the slot of a connected session
+ * e.g., the session opened by connect_slot().
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle which is already connected
+ * workerCount represents the number of worker threads (and sessions)
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int async_executor::start(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+							const size_t workerCount)
+{
+	CK_SESSION_INFO sessionInfo;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	/**
+	 * CK_RV C_GetSessionInfo(CK_SESSION_HANDLE hSession, CK_SESSION_INFO_PTR pInfo);
+	 *
+	 * C_GetSessionInfo() obtains information about a session.
+	 *
+	 * hSession is the session’s handle;
+	 * pInfo points to the location that receives the session information e.g., slot ID.
+	*/
+	if (check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()")) {
+		return 2;
+	}
+	return start_slot(funclistPtr, sessionInfo.slotID, workerCount);
+}
+
+
+
+/**
+ * The function opens one session per worker thread on given slot and starts the worker threads.
+ * Note that Cryptoki library should be initialized before calling this function.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ * workerCount represents the number of worker threads (and sessions)
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int async_executor::start_slot(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+								const size_t workerCount)
+{
+	CK_SESSION_HANDLE hWorker = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	if (!workers.empty() || !workerCount) {
+		cout << "Error, executor is already started or no worker is requested\n";
+		return 3;
+	}
+
+	this->funclistPtr = funclistPtr;
+	for (size_t i = 0; i < workerCount; ++i) {
+		if (check_operation(funclistPtr->C_OpenSession(slotID, CKF_SERIAL_SESSION | CKF_RW_SESSION,
+														NULL_PTR, NULL_PTR, &hWorker),
+							"C_OpenSession()")) {
+			stop();
+			return 3;
+		}
+		sessions.push_back(hWorker);
+	}
+
+	// The sessions are opened before starting any thread, so each worker only ever uses its own.
+	// The workers are started under the lock, since enqueue() checks them to accept a task
+	std::lock_guard<std::mutex> lock(tasksMutex);
+	stopping = false;
+	for (size_t i = 0; i < sessions.size(); ++i) {
+		workers.push_back(std::thread(&async_executor::run_worker, this, sessions[i]));
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function waits for the queued operations to complete, joins the worker threads
+ * and closes their sessions.
+ *
+ * The function does not return anything.
+*/
+void async_executor::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		stopping = true;
+	}
+	tasksReady.notify_all();
+
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+	workers.clear();
+
+	for (size_t i = 0; i < sessions.size(); ++i) {
+		check_operation(funclistPtr->C_CloseSession(sessions[i]), "C_CloseSession()");
+	}
+	sessions.clear();
+}
+
+
+
+/**
+ * The function queues given operation to be performed by one of the worker threads
+ *
+ * operation is the operation to be performed on the session of worker thread
+ *
+ * The std::future holding the value returned by operation is returned. If the executor is not
+ * started or is stopping, the operation is not performed and the future holds non-zero integer.
+*/
+std::future<int> async_executor::submit(token_operation operation)
+{
+	std::shared_ptr<std::packaged_task<int(CK_SESSION_HANDLE&)> > task =
+				std::make_shared<std::packaged_task<int(CK_SESSION_HANDLE&)> >(operation);
+	std::future<int> result = task->get_future();
+
+	if (enqueue([task](CK_SESSION_HANDLE& hWorker) { (*task)(hWorker); })) {
+		std::promise<int> rejected;
+		rejected.set_value(1);
+		return rejected.get_future();
+	}
+	return result;
+}
+
+
+
+/**
+ * The function queues given operation to be performed by one of the worker threads
+ * and invokes the callback with its returned value on that worker thread.
+ * If the executor is not started or is stopping, the operation is not performed and
+ * the callback is invoked with non-zero integer on the calling thread.
+ *
+ * operation is the operation to be performed on the session of worker thread
+ * callback is the completion callback
+ *
+ * The function does not return anything.
+*/
+void async_executor::submit(token_operation operation, completion_callback callback)
+{
+	int retVal = enqueue([operation, callback](CK_SESSION_HANDLE& hWorker) {
+		int opVal = operation(hWorker);
+		if (callback) {
+			callback(opVal);
+		}
+	});
+	if (retVal && callback) {
+		callback(retVal);
+	}
+}
+
+
+
+/**
+ * The function queues given task unless the executor is not started or is stopping,
+ * since no worker thread would ever perform it.
+ *
+ * task is the task to be performed on the session of worker thread
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int async_executor::enqueue(std::function<void(CK_SESSION_HANDLE&)> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		if (stopping || workers.empty()) {
+			cout << "Error, executor is not started or is stopping\n";
+			return 1;
+		}
+		tasks.push_back(task);
+	}
+	tasksReady.notify_one();
+	return 0;
+}
+
+
+
+/**
+ * The function is executed by each worker thread. It performs the queued operations
+ * on the given session until the executor is stopped and the queue is empty.
+ *
+ * hWorker is the session ID/handle owned by this worker thread
+ *
+ * The function does not return anything.
+*/
+void async_executor::run_worker(CK_SESSION_HANDLE hWorker)
+{
+	std::function<void(CK_SESSION_HANDLE&)> task;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(tasksMutex);
+			tasksReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) {
+				// Executor is stopping and nothing left to perform
+				return;
+			}
+			task = tasks.front();
+			tasks.pop_front();
+		}
+		task(hWorker);
+	}
+}
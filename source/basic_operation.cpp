@@ -20,7 +20,6 @@ using std::endl;
 */
 int load_library_HSM(void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr)
 {
-	char* libError;
 	/**
 	 * Instead of reading the SoftHSM full path from user every time,
 	 * it's better to set an environment variable 
@@ -48,7 +47,26 @@ int load_library_HSM(void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr)
 		cout << "Error, SOFTHSM2_LIB environment variable is not set" << endl;
 		return 2;
 	}
-	
+	return load_library_path(libPath, libHandle, funclistPtr);
+}
+
+
+
+
+/**
+ * The function attempts to load the PKCS #11 library from given path in order to use 
+ * PKCS# 11 functions/API e.g., when several libraries (modules) are loaded at once.
+ * 
+ * libPath is a pointer to null-terminated full path of the library
+ * libHandle is a void pointer for the library handle
+ * funclistPtr is an alias of pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ *  
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int load_library_path(const char* libPath, void*& libHandle, CK_FUNCTION_LIST_PTR& funclistPtr)
+{
+	char* libError;
+
 	/**
 	 * void *dlopen(const char *filename, int flags);
 	 * 
@@ -5,6 +5,12 @@
     #include "../header/common_basic_operation.hpp"
 #endif 
 
+/**
+ * The innermost operation_rv_scope of this thread, if any
+ */
+static thread_local operation_rv_scope* currentScope = NULL_PTR;
+
+
 /**
  * The function checks if a requested Cryptoki (PKCS #11) operation was a success or not.
  * 
@@ -18,9 +24,26 @@
 int check_operation(const CK_RV rv, const char* message)
 {
 	if (rv != CKR_OK) {
+		if (currentScope && currentScope->failedRV == CKR_OK) {
+			currentScope->failedRV = rv;
+		}
 		std::cout << "Error, " << message << " failed with RV : " << rv << std::endl;
 		return 1;
 	}
 	return 0;
 }
 
+
+operation_rv_scope::operation_rv_scope() : failedRV(CKR_OK), outer(currentScope)
+{
+	currentScope = this;
+}
+
+
+operation_rv_scope::~operation_rv_scope()
+{
+	currentScope = outer;
+	if (outer && outer->failedRV == CKR_OK) {
+		outer->failedRV = failedRV;
+	}
+}
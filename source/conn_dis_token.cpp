@@ -3,9 +3,13 @@
 #ifdef WIND
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\conn_dis_token.hpp"
+	#include "..\header\login_manager.hpp"
+	#include "..\header\mechanism_cache.hpp"
 #else
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/conn_dis_token.hpp"
+	#include "../header/login_manager.hpp"
+	#include "../header/mechanism_cache.hpp"
 #endif
  
 
@@ -21,6 +25,7 @@ using std::endl;
  * 
  * First, it initializes the Cryptoki/SoftHSM library; 
  * Second, attempts to open a new session by taking solt ID from the user;
+ * Third, caches the mechanisms supported by the token, see application_mechanisms();
  * Finally, attempts to perform login based on user inputs.
  * 
  * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
@@ -42,7 +47,16 @@ int connect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSes
 	*/
 	CK_SLOT_ID slotID = 0;
 
-	// Checking whether funclistPtr is null or not 
+	/**
+	 * CK_C_INITIALIZE_ARGS is a structure containing the optional arguments for C_Initialize().
+	 * The CKF_OS_LOCKING_OK flag indicates that the library can use the native operation system
+	 * threading model for locking, so the sessions can be used from multiple threads
+	 * e.g., by the worker threads of async_executor.
+	*/
+	CK_C_INITIALIZE_ARGS initArgs = {};
+	initArgs.flags = CKF_OS_LOCKING_OK;
+
+	// Checking whether funclistPtr is null or not
 	if (is_nullptr(funclistPtr)) {
 		return 3;
 	}
@@ -56,7 +70,7 @@ int connect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSes
 	 * Cryptoki through multiple threads simultaneously, it can generally supply the value NULL_PTR to C_Initialize().
 	 * Cryptoki defines a C-style NULL pointer, which is distinct from any valid pointeri.e., NULL_PTR
 	 * */
-	retVal = check_operation(funclistPtr->C_Initialize(NULL_PTR), "C_Initialize()");
+	retVal = check_operation(funclistPtr->C_Initialize(&initArgs), "C_Initialize()");
 	if (!retVal) {
 		// C_Initialize() was successful
 		cout << "\tPlease enter the slot ID (integer): ";
@@ -93,6 +107,15 @@ int connect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSes
 															"C_OpenSession()");
 		if (!retVal) {
 			// Session opened successfully
+			/**
+			 * The mechanisms supported by the token are cached once, so callers can pick a supported
+			 * mechanism without calling C_GetMechanismInfo() again. The session can still be used
+			 * without the cache, so a failure is not fatal.
+			*/
+			if (application_mechanisms().build(funclistPtr, slotID)) {
+				cout << "Error, mechanisms of slot ID " << slotID << " are not cached\n";
+			}
+
 			cout << "\tPlease enter the User PIN: ";
 			cin >> usrPIN;
 
@@ -113,10 +136,11 @@ int connect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSes
 			 * To log into a token with a protected authentication path, the pPin parameter to C_Login should be NULL_PTR. 
 			 * When C_Login returns, whatever authentication method supported by the token will have been performed; 
 			 * a return value of CKR_OK means that the user was successfully authenticated
+			 * 
+			 * The application login manager calls C_Login() on the first session of the token only,
+			 * and treats CKR_USER_ALREADY_LOGGED_IN as success.
 			*/
-			retVal = check_operation(funclistPtr->C_Login(hSession, CKU_USER,
-														reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(usrPIN.c_str())),
-														usrPIN.length()), "C_Login()");
+			retVal = application_login().acquire(funclistPtr, slotID, hSession, usrPIN);
 		}
 	}
 	
@@ -138,6 +162,7 @@ int connect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSes
 int disconnect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession)
 {
 	int retVal = 0;
+	CK_SESSION_INFO sessionInfo;
 
 	// Checking whether funclistPtr is null or not 
 	if (is_nullptr(funclistPtr)) {
@@ -152,8 +177,14 @@ int disconnect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& h
 	 * session, and then C_Logout is successfully executed by that application, it may or may
 	 * not be the case that those operations are still active. Therefore, before logging out, 
 	 * any active operations should be finished.
+	 * 
+	 * Since C_Logout() logs out every other session of the application too, the application
+	 * login manager calls it only when the last reference of the token is released.
 	*/
-	retVal = check_operation(funclistPtr->C_Logout(hSession), "C_Logout()");
+	retVal = check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()");
+	if (!retVal) {
+		retVal = application_login().release(funclistPtr, sessionInfo.slotID, hSession);
+	}
 	if (!retVal) {
 		// C_Logout() was successful
 		/**
@@ -179,6 +210,8 @@ int disconnect_slot(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& h
 		 * application’s call to C_Finalize should be preceded by a single call to C_Initialize;
 		*/
 		retVal = check_operation(funclistPtr->C_Finalize(NULL_PTR), "C_Finalize()");
+		application_login().forget(funclistPtr);
+		application_mechanisms().forget(funclistPtr);
 	}
 	
 	return retVal;
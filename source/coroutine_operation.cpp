@@ -0,0 +1,120 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\coroutine_operation.hpp"
+#else
+	#include "../header/coroutine_operation.hpp"
+#endif
+
+
+
+token_task token_task::promise_type::get_return_object()
+{
+	return token_task(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+
+/**
+ * The function is called when the body of token_task is finished. Instead of returning
+ * to the thread which has resumed the task and then resuming the awaiting coroutine,
+ * the awaiting coroutine is resumed directly (symmetric transfer), so no stack grows.
+ *
+ * hTask is the coroutine handle of the finished task
+ *
+ * The coroutine handle to be resumed is returned.
+*/
+std::coroutine_handle<> token_task::promise_type::final_awaiter::await_suspend(
+												std::coroutine_handle<promise_type> hTask) noexcept
+{
+	if (hTask.promise().hContinuation) {
+		return hTask.promise().hContinuation;
+	}
+	return std::noop_coroutine();
+}
+
+
+token_task::token_task(token_task&& other) noexcept : hTask(other.hTask)
+{
+	other.hTask = nullptr;
+}
+
+
+token_task& token_task::operator=(token_task&& other) noexcept
+{
+	if (this != &other) {
+		if (hTask) {
+			hTask.destroy();
+		}
+		hTask = other.hTask;
+		other.hTask = nullptr;
+	}
+	return *this;
+}
+
+
+token_task::~token_task()
+{
+	if (hTask) {
+		hTask.destroy();
+	}
+}
+
+
+/**
+ * The function starts the lazily started task once it is awaited and records the
+ * awaiting coroutine to be resumed when the task is finished.
+ *
+ * hCaller is the coroutine handle of the awaiting coroutine
+ *
+ * The coroutine handle of the task is returned to be resumed (symmetric transfer).
+*/
+std::coroutine_handle<> token_task::await_suspend(std::coroutine_handle<> hCaller) noexcept
+{
+	hTask.promise().hContinuation = hCaller;
+	return hTask;
+}
+
+
+
+namespace {
+
+/**
+ * A coroutine type which starts immediately and destroys itself when finished
+*/
+struct detached_task
+{
+	struct promise_type
+	{
+		detached_task get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+
+detached_task run_detached(token_task task, completion_callback callback)
+{
+	int retVal = co_await task;
+	if (callback) {
+		callback(retVal);
+	}
+}
+
+}
+
+
+
+/**
+ * The function starts given task without awaiting it e.g., from the event loop of a server.
+ * The task and its coroutine frame are destroyed when it is finished.
+ *
+ * task is the token_task to be started
+ * callback is invoked with the value returned by the task, if not empty
+ *
+ * The function does not return anything.
+*/
+void spawn_task(token_task task, completion_callback callback)
+{
+	run_detached(std::move(task), callback);
+}
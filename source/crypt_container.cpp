@@ -0,0 +1,592 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\crypt_container.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/crypt_container.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The magics of the header and the footer of a container
+*/
+const char HEADER_MAGIC[] = "P11CTNR1";
+const char FOOTER_MAGIC[] = "P11CIDX1";
+const size_t MAGIC_LEN = 8;
+
+/**
+ * The byte-length of the fixed part of the header i.e., up to the key ID, and of the footer
+*/
+const size_t HEADER_FIXED_LEN = MAGIC_LEN + 8 + 8 + 8 + 8 + 4;
+const size_t FOOTER_LEN = 8 + MAGIC_LEN;
+
+/**
+ * The byte-lengths of the IV and the tag of AES-GCM
+*/
+const size_t GCM_IV_LEN = 12;
+const size_t GCM_TAG_LEN = 16;
+
+/**
+ * The number of chunks being encrypted per worker session at a time, which bounds the memory of write_container()
+*/
+const size_t CHUNKS_PER_WORKER = 2;
+
+
+
+/**
+ * The function appends given integer in little-endian of given byte-length
+*/
+static void put_uint(std::string& out, const unsigned long long value, const size_t byteLen)
+{
+	for (size_t i = 0; i < byteLen; ++i) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+
+
+/**
+ * The function gets the integer in little-endian of given byte-length at given position
+*/
+static unsigned long long get_uint(const std::string& in, const size_t pos, const size_t byteLen)
+{
+	unsigned long long value = 0;
+
+	for (size_t i = 0; i < byteLen; ++i) {
+		value |= static_cast<unsigned long long>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+	}
+	return value;
+}
+
+
+
+/**
+ * The function reads exactly given byte-length at given offset of the file
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int read_full(const int fd, void* bufPtr, const size_t byteLen, const unsigned long long offset)
+{
+	size_t done = 0;
+
+	while (done < byteLen) {
+		ssize_t ret = pread(fd, static_cast<char*>(bufPtr) + done, byteLen - done, offset + done);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret <= 0) {
+			cout << "Error, cannot read the file: " << (ret ? std::strerror(errno) : "unexpected end") << endl;
+			return 1;
+		}
+		done += ret;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function writes exactly given byte-length at given offset of the file
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int write_full(const int fd, const void* bufPtr, const size_t byteLen, const unsigned long long offset)
+{
+	size_t done = 0;
+
+	while (done < byteLen) {
+		ssize_t ret = pwrite(fd, static_cast<const char*>(bufPtr) + done, byteLen - done, offset + done);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret < 0) {
+			cout << "Error, cannot write the file: " << std::strerror(errno) << endl;
+			return 1;
+		}
+		done += ret;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function serializes given header, which is also the additional authenticated data of every chunk
+*/
+static std::string serialize_header(const container_header& hdr)
+{
+	std::string out(HEADER_MAGIC, MAGIC_LEN);
+
+	put_uint(out, hdr.mechanism, 8);
+	put_uint(out, hdr.chunkSize, 8);
+	put_uint(out, hdr.plainSize, 8);
+	out.append(reinterpret_cast<const char*>(hdr.ivSeed), sizeof(hdr.ivSeed));
+	put_uint(out, hdr.keyId.length(), 4);
+	out += hdr.keyId;
+	return out;
+}
+
+
+
+/**
+ * The function gets the number of chunks of given header, rounding up without
+ * overflowing when plainSize is close to its maximum
+*/
+static unsigned long long chunk_count(const container_header& hdr)
+{
+	return hdr.plainSize / hdr.chunkSize + (hdr.plainSize % hdr.chunkSize ? 1 : 0);
+}
+
+
+
+/**
+ * The function gets the byte-length of the plaintext of given chunk
+*/
+static size_t chunk_plain_length(const container_header& hdr, const unsigned long long chunkNo)
+{
+	unsigned long long remaining = hdr.plainSize - chunkNo * hdr.chunkSize;
+
+	return remaining < hdr.chunkSize ? remaining : hdr.chunkSize;
+}
+
+
+
+/**
+ * The function sets up CKM_AES_GCM for given chunk i.e., the IV is the IV seed followed by the big-endian
+ * chunk number, and the header is the additional authenticated data
+*/
+static void gcm_mechanism(const container_header& hdr, const std::string& headerBytes, const unsigned long long chunkNo,
+							CK_BYTE_PTR const iv, CK_GCM_PARAMS& paramGCM, CK_MECHANISM& mech)
+{
+	std::memcpy(iv, hdr.ivSeed, sizeof(hdr.ivSeed));
+	for (size_t i = 0; i < GCM_IV_LEN - sizeof(hdr.ivSeed); ++i) {
+		iv[GCM_IV_LEN - 1 - i] = static_cast<CK_BYTE>((chunkNo >> (8 * i)) & 0xFF);
+	}
+
+	/**
+	 * CK_GCM_PARAMS is a structure that provides the parameters to the CKM_AES_GCM mechanism
+	 *
+	 * pIv is the IV, ulIvLen its byte-length and ulIvBits its bit-length
+	 * pAAD is the additional authenticated data, which is authenticated but not encrypted
+	 * ulTagBits is the bit-length of the authentication tag appended to the ciphertext
+	*/
+	paramGCM.pIv = iv;
+	paramGCM.ulIvLen = GCM_IV_LEN;
+	paramGCM.ulIvBits = GCM_IV_LEN * 8;
+	paramGCM.pAAD = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(headerBytes.data()));
+	paramGCM.ulAADLen = headerBytes.length();
+	paramGCM.ulTagBits = GCM_TAG_LEN * 8;
+	mech.mechanism = CKM_AES_GCM;
+	mech.pParameter = &paramGCM;
+	mech.ulParameterLen = sizeof(paramGCM);
+}
+
+
+
+/**
+ * The state shared by the chunks of write_container()
+*/
+struct container_job
+{
+	int inFd;
+	int outFd;
+	CK_OBJECT_HANDLE hSecretkey;
+	container_header hdr;
+	std::string headerBytes;
+};
+
+
+
+/**
+ * The function gets the offset of given chunk in the container
+*/
+static unsigned long long chunk_offset(const container_job& job, const unsigned long long chunkNo)
+{
+	return job.headerBytes.length() + chunkNo * (job.hdr.chunkSize + GCM_TAG_LEN);
+}
+
+
+
+/**
+ * The function generates the IV seed of a container on a worker session
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int generate_seed(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, CK_BYTE_PTR seedPtr,
+							const CK_ULONG seedLen)
+{
+	return check_operation(funclistPtr->C_GenerateRandom(hSession, seedPtr, seedLen), "C_GenerateRandom()");
+}
+
+
+
+/**
+ * The function reads, encrypts and writes given chunk on a worker session
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int encrypt_chunk(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const container_job* job, const unsigned long long chunkNo)
+{
+	CK_BYTE iv[GCM_IV_LEN];
+	CK_GCM_PARAMS paramGCM;
+	CK_MECHANISM mech;
+	size_t plainLen = chunk_plain_length(job->hdr, chunkNo);
+	std::vector<CK_BYTE> plain(plainLen);
+	std::vector<CK_BYTE> cipher(plainLen + GCM_TAG_LEN);
+	CK_ULONG cipherLen = cipher.size();
+
+	if (read_full(job->inFd, plain.data(), plainLen, chunkNo * job->hdr.chunkSize)) {
+		return 1;
+	}
+	gcm_mechanism(job->hdr, job->headerBytes, chunkNo, iv, paramGCM, mech);
+	if (check_operation(funclistPtr->C_EncryptInit(hSession, &mech, job->hSecretkey), "C_EncryptInit()")) {
+		return 1;
+	}
+	if (check_operation(funclistPtr->C_Encrypt(hSession, plain.data(), plainLen, cipher.data(), &cipherLen),
+						"C_Encrypt()")) {
+		return 1;
+	}
+	if (cipherLen != cipher.size()) {
+		cout << "Error, unexpected ciphertext length of chunk " << chunkNo << endl;
+		return 1;
+	}
+	return write_full(job->outFd, cipher.data(), cipherLen, chunk_offset(*job, chunkNo));
+}
+
+
+
+/**
+ * The function writes the index and the footer after the last chunk
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int write_index(const container_job& job)
+{
+	unsigned long long count = chunk_count(job.hdr);
+	unsigned long long indexOffset = chunk_offset(job, count);
+	std::string index;
+
+	// The last chunk may be shorter, so its offset ends where its ciphertext ends
+	if (count) {
+		indexOffset = chunk_offset(job, count - 1) + chunk_plain_length(job.hdr, count - 1) + GCM_TAG_LEN;
+	}
+	put_uint(index, count, 8);
+	for (unsigned long long i = 0; i < count; ++i) {
+		put_uint(index, chunk_offset(job, i), 8);
+		put_uint(index, chunk_plain_length(job.hdr, i) + GCM_TAG_LEN, 8);
+	}
+	put_uint(index, indexOffset, 8);
+	index.append(FOOTER_MAGIC, MAGIC_LEN);
+	return write_full(job.outFd, index.data(), index.length(), indexOffset);
+}
+
+
+
+/**
+ * The function encrypts given file into a container, where the chunks are encrypted across the worker
+ * sessions of given executor and at most CHUNKS_PER_WORKER chunks per worker are in memory at a time
+ *
+ * executor is an alias of started async_executor
+ * hSecretkey is an alias of constant AES secret key handle
+ * keyId is an alias of constant ID (CKA_ID) of the key, recorded so a reader can find the key
+ * inPath is an alias of constant path of the file to be encrypted
+ * outPath is an alias of constant path of the container, which is created or overwritten
+ * chunkSz represents the byte-length of the plaintext of a chunk
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the container is removed.
+*/
+int write_container(async_executor& executor, const CK_OBJECT_HANDLE& hSecretkey, const std::string& keyId,
+					const std::string& inPath, const std::string& outPath, const size_t chunkSz)
+{
+	int retVal = 0;
+	struct stat fileStat;
+	container_job job;
+	std::deque<std::future<int> > inFlight;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(executor.function_list())) {
+		return 2;
+	}
+	if (!executor.worker_count()) {
+		cout << "Error, executor is not started\n";
+		return 2;
+	}
+	if (!chunkSz) {
+		cout << "Error, chunk size should not be 0\n";
+		return 2;
+	}
+
+	job.inFd = ::open(inPath.c_str(), O_RDONLY);
+	if (job.inFd < 0 || fstat(job.inFd, &fileStat)) {
+		cout << "Error, cannot open " << inPath << ": " << std::strerror(errno) << endl;
+		if (job.inFd >= 0) {
+			::close(job.inFd);
+		}
+		return 2;
+	}
+	job.hSecretkey = hSecretkey;
+	job.hdr.mechanism = CKM_AES_GCM;
+	job.hdr.chunkSize = chunkSz;
+	job.hdr.plainSize = fileStat.st_size;
+	job.hdr.keyId = keyId;
+	if (chunk_count(job.hdr) >> 32) {
+		// The chunk number is the last 4 bytes of the IV
+		cout << "Error, too many chunks, the chunk size should be larger\n";
+		::close(job.inFd);
+		return 2;
+	}
+
+	job.outFd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (job.outFd < 0) {
+		cout << "Error, cannot create " << outPath << ": " << std::strerror(errno) << endl;
+		::close(job.inFd);
+		return 2;
+	}
+
+	retVal = async_operation(executor, generate_seed, job.hdr.ivSeed, sizeof(job.hdr.ivSeed)).get();
+	if (!retVal) {
+		job.headerBytes = serialize_header(job.hdr);
+		retVal = write_full(job.outFd, job.headerBytes.data(), job.headerBytes.length(), 0);
+	}
+
+	for (unsigned long long chunkNo = 0; !retVal && chunkNo < chunk_count(job.hdr); ++chunkNo) {
+		if (inFlight.size() == executor.worker_count() * CHUNKS_PER_WORKER) {
+			retVal = inFlight.front().get();
+			inFlight.pop_front();
+		}
+		if (!retVal) {
+			inFlight.push_back(async_operation(executor, encrypt_chunk, &job, chunkNo));
+		}
+	}
+	// Waiting for every chunk still in flight, as they use job
+	while (!inFlight.empty()) {
+		if (inFlight.front().get()) {
+			retVal = 1;
+		}
+		inFlight.pop_front();
+	}
+
+	if (!retVal) {
+		retVal = write_index(job);
+	}
+	::close(job.inFd);
+	::close(job.outFd);
+	if (retVal) {
+		std::remove(outPath.c_str());
+		return 2;
+	}
+	return 0;
+}
+
+
+
+container_reader::container_reader() : fd(-1)
+{
+}
+
+
+container_reader::~container_reader()
+{
+	close();
+}
+
+
+
+/**
+ * The function opens given container and reads its header and index
+ *
+ * path is an alias of constant path of the container
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int container_reader::open(const std::string& path)
+{
+	struct stat fileStat;
+	std::string footer(FOOTER_LEN, '\0');
+	std::string index;
+	unsigned long long indexOffset = 0;
+	unsigned long long count = 0;
+
+	close();
+	fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0 || fstat(fd, &fileStat)) {
+		cout << "Error, cannot open " << path << ": " << std::strerror(errno) << endl;
+		close();
+		return 3;
+	}
+
+	// The header
+	headerBytes.assign(HEADER_FIXED_LEN, '\0');
+	if (static_cast<unsigned long long>(fileStat.st_size) < HEADER_FIXED_LEN + 8 + FOOTER_LEN ||
+		read_full(fd, &headerBytes[0], HEADER_FIXED_LEN, 0) || headerBytes.compare(0, MAGIC_LEN, HEADER_MAGIC)) {
+		cout << "Error, " << path << " is not a container\n";
+		close();
+		return 3;
+	}
+	hdr.mechanism = get_uint(headerBytes, MAGIC_LEN, 8);
+	hdr.chunkSize = get_uint(headerBytes, MAGIC_LEN + 8, 8);
+	hdr.plainSize = get_uint(headerBytes, MAGIC_LEN + 16, 8);
+	std::memcpy(hdr.ivSeed, &headerBytes[MAGIC_LEN + 24], sizeof(hdr.ivSeed));
+	hdr.keyId.assign(get_uint(headerBytes, MAGIC_LEN + 32, 4), '\0');
+	if (hdr.mechanism != CKM_AES_GCM || !hdr.chunkSize ||
+		HEADER_FIXED_LEN + hdr.keyId.length() + 8 + FOOTER_LEN > static_cast<unsigned long long>(fileStat.st_size) ||
+		(hdr.keyId.length() && read_full(fd, &hdr.keyId[0], hdr.keyId.length(), HEADER_FIXED_LEN))) {
+		cout << "Error, header of " << path << " is not valid\n";
+		close();
+		return 3;
+	}
+	headerBytes += hdr.keyId;
+
+	// The footer and the index
+	if (read_full(fd, &footer[0], FOOTER_LEN, fileStat.st_size - FOOTER_LEN) ||
+		footer.compare(8, MAGIC_LEN, FOOTER_MAGIC)) {
+		cout << "Error, index of " << path << " is missing\n";
+		close();
+		return 3;
+	}
+	indexOffset = get_uint(footer, 0, 8);
+	if (indexOffset < headerBytes.length() || indexOffset + 8 + FOOTER_LEN > static_cast<unsigned long long>(fileStat.st_size)) {
+		cout << "Error, index of " << path << " is not valid\n";
+		close();
+		return 3;
+	}
+	index.assign(fileStat.st_size - FOOTER_LEN - indexOffset, '\0');
+	if (read_full(fd, &index[0], index.length(), indexOffset)) {
+		close();
+		return 3;
+	}
+	count = get_uint(index, 0, 8);
+	// The chunk number is the last 4 bytes of the IV, as limited by write_container(), and
+	// count is bounded by the index length before multiplying so it cannot wrap around
+	if (count != chunk_count(hdr) || (count >> 32) || count > (index.length() - 8) / 16 ||
+		index.length() != 8 + count * 16) {
+		cout << "Error, index of " << path << " does not match its header\n";
+		close();
+		return 3;
+	}
+	chunks.resize(count);
+	for (unsigned long long i = 0; i < count; ++i) {
+		chunks[i].offset = get_uint(index, 8 + i * 16, 8);
+		chunks[i].length = get_uint(index, 16 + i * 16, 8);
+		if (chunks[i].length != chunk_plain_length(hdr, i) + GCM_TAG_LEN ||
+			chunks[i].offset < headerBytes.length() || chunks[i].offset + chunks[i].length > indexOffset) {
+			cout << "Error, chunk " << i << " of " << path << " is not valid\n";
+			close();
+			return 3;
+		}
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function closes the container
+*/
+void container_reader::close()
+{
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	}
+	chunks.clear();
+	headerBytes.clear();
+	hdr = container_header();
+}
+
+
+
+/**
+ * The function reads and decrypts given chunk, which fails if the chunk or the header was modified
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int container_reader::decrypt_chunk(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+									const CK_OBJECT_HANDLE& hSecretkey, const size_t chunkNo, std::string& plainChunk)
+{
+	CK_BYTE iv[GCM_IV_LEN];
+	CK_GCM_PARAMS paramGCM;
+	CK_MECHANISM mech;
+	std::vector<CK_BYTE> cipher(chunks[chunkNo].length);
+	CK_ULONG plainLen = cipher.size() - GCM_TAG_LEN;
+
+	if (read_full(fd, cipher.data(), cipher.size(), chunks[chunkNo].offset)) {
+		return 1;
+	}
+	gcm_mechanism(hdr, headerBytes, chunkNo, iv, paramGCM, mech);
+	if (check_operation(funclistPtr->C_DecryptInit(hSession, &mech, hSecretkey), "C_DecryptInit()")) {
+		return 1;
+	}
+	plainChunk.resize(plainLen);
+	if (check_operation(funclistPtr->C_Decrypt(hSession, cipher.data(), cipher.size(),
+												reinterpret_cast<CK_BYTE_PTR>(&plainChunk[0]), &plainLen), "C_Decrypt()")) {
+		cout << "Error, chunk " << chunkNo << " failed authentication\n";
+		plainChunk.clear();
+		return 1;
+	}
+	plainChunk.resize(plainLen);
+	return 0;
+}
+
+
+
+/**
+ * The function reads given byte range of the plaintext, decrypting the chunks covering it only
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle, whose CKA_ID is header().keyId
+ * offset represents the offset of the range in the plaintext
+ * length represents the byte-length of the range, which is cut at the end of the plaintext
+ * plaintext is an alias of the plaintext of the range to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int container_reader::read(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const unsigned long long offset, const size_t length,
+							std::string& plaintext)
+{
+	std::string plainChunk;
+	unsigned long long end = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+	if (fd < 0) {
+		cout << "Error, container is not open\n";
+		return 4;
+	}
+	if (offset > hdr.plainSize) {
+		cout << "Error, offset is beyond the end of the container\n";
+		return 4;
+	}
+
+	plaintext.clear();
+	end = hdr.plainSize - offset < length ? hdr.plainSize : offset + length;
+	for (unsigned long long pos = offset; pos < end; ) {
+		unsigned long long chunkNo = pos / hdr.chunkSize;
+		unsigned long long chunkBegin = chunkNo * hdr.chunkSize;
+		if (decrypt_chunk(funclistPtr, hSession, hSecretkey, chunkNo, plainChunk)) {
+			plaintext.clear();
+			return 4;
+		}
+		size_t sliceEnd = (end - chunkBegin < plainChunk.length()) ? end - chunkBegin : plainChunk.length();
+		plaintext.append(plainChunk, pos - chunkBegin, sliceEnd - (pos - chunkBegin));
+		pos = chunkBegin + sliceEnd;
+	}
+	return 0;
+}
@@ -0,0 +1,699 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\crypto_pipeline.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/crypto_pipeline.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * AES uses 128-bit (16-byte) block, which is also the byte-length of the IV
+*/
+const size_t AES_BLOCK_LEN = 16;
+
+
+
+/**
+ * A bounded ring connecting two stages of the pipeline. Closing the ring lets the consumer drain it,
+ * while cancelling it stops both sides at once e.g., when a stage failed.
+*/
+template <typename T>
+class bounded_ring
+{
+public:
+	explicit bounded_ring(const size_t capacity) : slots(capacity), head(0), count(0), closed(false), cancelled(false) {}
+
+	/**
+	 * The function waits for a free slot and adds given item.
+	 * If the ring was cancelled, false is returned. Otherwise, true is returned.
+	*/
+	bool push(const T& item)
+	{
+		std::unique_lock<std::mutex> lock(ringMutex);
+		notFull.wait(lock, [this] { return count < slots.size() || cancelled; });
+		if (cancelled) {
+			return false;
+		}
+		slots[(head + count) % slots.size()] = item;
+		++count;
+		notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * The function waits for an item and removes it.
+	 * If the ring was cancelled, or closed and drained, false is returned. Otherwise, true is returned.
+	*/
+	bool pop(T& item)
+	{
+		std::unique_lock<std::mutex> lock(ringMutex);
+		notEmpty.wait(lock, [this] { return count || closed || cancelled; });
+		if (cancelled || !count) {
+			return false;
+		}
+		item = slots[head];
+		head = (head + 1) % slots.size();
+		--count;
+		notFull.notify_one();
+		return true;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(ringMutex);
+		closed = true;
+		notEmpty.notify_all();
+	}
+
+	void cancel()
+	{
+		std::lock_guard<std::mutex> lock(ringMutex);
+		cancelled = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+private:
+	std::vector<T> slots;
+	size_t head;
+	size_t count;
+	bool closed;
+	bool cancelled;
+	std::mutex ringMutex;
+	std::condition_variable notEmpty;
+	std::condition_variable notFull;
+};
+
+
+
+/**
+ * The rings between the stages and the failure state of a run of the pipeline
+ *
+ * 		freeRing	writer -> reader, the buffers to be filled
+ * 		readRing	reader -> crypto stage, the chunks read
+ * 		writeRing	crypto stage -> writer, the chunks transformed, in any order
+*/
+struct pipeline_state
+{
+	explicit pipeline_state(const size_t depth) : freeRing(depth), readRing(depth), writeRing(depth), failed(false) {}
+
+	void fail()
+	{
+		failed = true;
+		freeRing.cancel();
+		readRing.cancel();
+		writeRing.cancel();
+	}
+
+	bounded_ring<pipeline_chunk*> freeRing;
+	bounded_ring<pipeline_chunk*> readRing;
+	bounded_ring<pipeline_chunk*> writeRing;
+	std::atomic<bool> failed;
+};
+
+
+
+/**
+ * The function gets the seconds elapsed since given time
+*/
+static double seconds_since(const std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+/**
+ * The function reads up to given byte-length from the current position of the file, stopping short at
+ * the end of the file only
+ *
+ * The byte-length read is returned, or -1 on failure.
+*/
+static ssize_t read_full(const int fd, CK_BYTE_PTR bufPtr, const size_t byteLen)
+{
+	size_t done = 0;
+
+	while (done < byteLen) {
+		ssize_t ret = read(fd, bufPtr + done, byteLen - done);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret < 0) {
+			cout << "Error, cannot read the file: " << std::strerror(errno) << endl;
+			return -1;
+		}
+		if (!ret) {
+			break;
+		}
+		done += ret;
+	}
+	return done;
+}
+
+
+
+/**
+ * The function writes given byte-length at the current position of the file
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int write_full(const int fd, const CK_BYTE* bufPtr, const size_t byteLen)
+{
+	size_t done = 0;
+
+	while (done < byteLen) {
+		ssize_t ret = write(fd, bufPtr + done, byteLen - done);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret < 0) {
+			cout << "Error, cannot write the file: " << std::strerror(errno) << endl;
+			return 1;
+		}
+		done += ret;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The reader stage i.e., fills the free buffers with the chunks of the input file in order
+*/
+static void read_stage(pipeline_state& state, const int inFd, const size_t chunkSz, pipeline_stats& stats)
+{
+	pipeline_chunk* chunk = NULL_PTR;
+
+	for (unsigned long long seq = 0; state.freeRing.pop(chunk); ++seq) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ssize_t readLen = read_full(inFd, chunk->in.data(), chunkSz);
+		stats.readSeconds += seconds_since(start);
+		if (readLen < 0) {
+			state.fail();
+			return;
+		}
+		if (!readLen) {
+			break;
+		}
+		chunk->seq = seq;
+		chunk->inLen = readLen;
+		chunk->outLen = 0;
+		stats.bytesIn += readLen;
+		if (!state.readRing.push(chunk) || static_cast<size_t>(readLen) < chunkSz) {
+			// A short chunk is the last one
+			break;
+		}
+	}
+	state.readRing.close();
+}
+
+
+
+/**
+ * The writer stage i.e., writes the output of the chunks in order and gives the buffers back to the reader
+*/
+static void write_stage(pipeline_state& state, const int outFd, pipeline_stats& stats)
+{
+	pipeline_chunk* chunk = NULL_PTR;
+	unsigned long long expected = 0;
+	// The chunks transformed ahead of the next one to be written, at most depth
+	std::map<unsigned long long, pipeline_chunk*> pending;
+
+	while (state.writeRing.pop(chunk)) {
+		pending[chunk->seq] = chunk;
+		while (!pending.empty() && pending.begin()->first == expected) {
+			chunk = pending.begin()->second;
+			pending.erase(pending.begin());
+			if (outFd >= 0 && chunk->outLen) {
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				if (write_full(outFd, chunk->out.data(), chunk->outLen)) {
+					state.fail();
+					return;
+				}
+				stats.writeSeconds += seconds_since(start);
+			}
+			stats.bytesOut += chunk->outLen;
+			++stats.chunkCount;
+			++expected;
+			if (!state.freeRing.push(chunk)) {
+				return;
+			}
+		}
+	}
+}
+
+
+
+/**
+ * The crypto stage on given session i.e., transforms the chunks in order, for chained operations
+*/
+static void crypto_stage(pipeline_state& state, const chunk_transform& transform, CK_SESSION_HANDLE& hSession,
+							pipeline_stats& stats)
+{
+	pipeline_chunk* chunk = NULL_PTR;
+
+	while (state.readRing.pop(chunk)) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (transform(hSession, *chunk)) {
+			state.fail();
+			return;
+		}
+		stats.cryptoSeconds += seconds_since(start);
+		if (!state.writeRing.push(chunk)) {
+			return;
+		}
+	}
+	state.writeRing.close();
+}
+
+
+
+/**
+ * The crypto stage across the worker sessions of given executor i.e., transforms the chunks in any order,
+ * for independent chunks. The busy time is summed over the workers.
+*/
+static void crypto_stage_parallel(pipeline_state& state, const chunk_transform& transform, async_executor& executor,
+									pipeline_stats& stats)
+{
+	pipeline_chunk* chunk = NULL_PTR;
+	size_t inFlight = 0;
+	std::mutex stageMutex;
+	std::condition_variable allDone;
+
+	while (state.readRing.pop(chunk)) {
+		std::lock_guard<std::mutex> lock(stageMutex);
+		++inFlight;
+		executor.submit([&, chunk](CK_SESSION_HANDLE& hWorker) {
+							std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+							int retVal = transform(hWorker, *chunk);
+							std::lock_guard<std::mutex> lock(stageMutex);
+							stats.cryptoSeconds += seconds_since(start);
+							return retVal;
+						},
+						[&, chunk](int retVal) {
+							if (retVal) {
+								state.fail();
+							}
+							else {
+								state.writeRing.push(chunk);
+							}
+							std::lock_guard<std::mutex> lock(stageMutex);
+							--inFlight;
+							allDone.notify_all();
+						});
+	}
+
+	// The operations refer to this stage, so all of them have to finish first
+	std::unique_lock<std::mutex> lock(stageMutex);
+	allDone.wait(lock, [&] { return !inFlight; });
+	state.writeRing.close();
+}
+
+
+
+/**
+ * The function runs the pipeline over given files until the end of the input file
+ *
+ * inFd is the file descriptor of the input, read from its current position
+ * outFd is the file descriptor of the output, written from its current position, or -1 for no output
+ * e.g., digest and signature
+ * config is an alias of constant configuration of the pipeline
+ * transform is an alias of constant transformation of the chunks
+ * hSession is an alias of session ID/handle, used by the transformation if executor is NULL_PTR
+ * executor is a pointer to started async_executor to transform independent chunks in parallel,
+ * or NULL_PTR to transform them in order on hSession
+ * stats is an alias of the statistics to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int run_pipeline(const int inFd, const int outFd, const pipeline_config& config, const chunk_transform& transform,
+					CK_SESSION_HANDLE& hSession, async_executor* executor, pipeline_stats& stats)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (!config.chunkSize || !config.depth) {
+		cout << "Error, chunk size and depth of the pipeline should not be 0\n";
+		return 2;
+	}
+	if (executor && !executor->worker_count()) {
+		cout << "Error, executor is not started\n";
+		return 2;
+	}
+
+	stats = pipeline_stats();
+	pipeline_state state(config.depth);
+	std::vector<pipeline_chunk> chunks(config.depth);
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		chunks[i].in.resize(config.chunkSize);
+		state.freeRing.push(&chunks[i]);
+	}
+
+	std::thread reader(read_stage, std::ref(state), inFd, config.chunkSize, std::ref(stats));
+	std::thread writer(write_stage, std::ref(state), outFd, std::ref(stats));
+	if (executor) {
+		crypto_stage_parallel(state, transform, *executor, stats);
+	}
+	else {
+		crypto_stage(state, transform, hSession, stats);
+	}
+	reader.join();
+	writer.join();
+
+	stats.seconds = seconds_since(start);
+	stats.MiBps = stats.seconds > 0 ? stats.bytesIn / (1024.0 * 1024.0) / stats.seconds : 0;
+	return state.failed ? 2 : 0;
+}
+
+
+
+/**
+ * The function finishes a multi-part operation whose output length is not known in advance i.e.,
+ * asks for the length, then finishes the operation
+ *
+ * The CK_RV value of the last call is returned.
+*/
+static CK_RV finish_operation(const std::function<CK_RV(CK_BYTE_PTR, CK_ULONG_PTR)>& finalFn, std::string& output)
+{
+	CK_ULONG outLen = 0;
+	CK_RV rv = finalFn(NULL_PTR, &outLen);
+
+	if (rv != CKR_OK) {
+		return rv;
+	}
+	// At least one byte, so the operation is finished and not asked for the length again
+	output.resize(outLen ? outLen : 1);
+	rv = finalFn(reinterpret_cast<CK_BYTE_PTR>(&output[0]), &outLen);
+	output.resize(rv == CKR_OK ? outLen : 0);
+	return rv;
+}
+
+
+
+/**
+ * The function opens the input and output files of the pipeline
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and no file is left open.
+*/
+static int open_files(const std::string& inPath, const std::string& outPath, int& inFd, int& outFd)
+{
+	inFd = ::open(inPath.c_str(), O_RDONLY);
+	if (inFd < 0) {
+		cout << "Error, cannot open " << inPath << ": " << std::strerror(errno) << endl;
+		return 1;
+	}
+	outFd = -1;
+	if (outPath.empty()) {
+		return 0;
+	}
+	outFd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (outFd < 0) {
+		cout << "Error, cannot create " << outPath << ": " << std::strerror(errno) << endl;
+		::close(inFd);
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function closes the files of the pipeline, and removes the output file on failure
+*/
+static void close_files(const int inFd, const int outFd, const std::string& outPath, const int retVal)
+{
+	::close(inFd);
+	if (outFd >= 0) {
+		::close(outFd);
+		if (retVal) {
+			std::remove(outPath.c_str());
+		}
+	}
+}
+
+
+
+/**
+ * The function gets the transformation of the chunks by C_EncryptUpdate() or C_DecryptUpdate()
+*/
+static chunk_transform AES_transform(const CK_FUNCTION_LIST_PTR funclistPtr, const bool encrypt)
+{
+	return [funclistPtr, encrypt](CK_SESSION_HANDLE& hSession, pipeline_chunk& chunk) {
+		// CBC holds back up to one block, which may come out with the next chunk
+		if (chunk.out.size() < chunk.inLen + AES_BLOCK_LEN) {
+			chunk.out.resize(chunk.inLen + AES_BLOCK_LEN);
+		}
+		CK_ULONG outLen = chunk.out.size();
+		CK_RV rv = encrypt ? funclistPtr->C_EncryptUpdate(hSession, chunk.in.data(), chunk.inLen, chunk.out.data(), &outLen)
+							: funclistPtr->C_DecryptUpdate(hSession, chunk.in.data(), chunk.inLen, chunk.out.data(), &outLen);
+		chunk.outLen = outLen;
+		return check_operation(rv, encrypt ? "C_EncryptUpdate()" : "C_DecryptUpdate()");
+	};
+}
+
+
+
+/**
+ * The function encrypts given file using CKM_AES_CBC_PAD with a random IV through the pipeline,
+ * where the output file is the IV followed by the ciphertext (as encrypt_file() of file_crypt.hpp)
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be encrypted
+ * outPath is an alias of constant path of the encrypted file, which is created or overwritten
+ * stats is an alias of the statistics to be returned
+ * config is an alias of constant configuration of the pipeline
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int encrypt_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+							pipeline_stats& stats, const pipeline_config& config)
+{
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	CK_MECHANISM encMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+	std::string lastPart;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	if (open_files(inPath, outPath, inFd, outFd)) {
+		return 3;
+	}
+
+	retVal = check_operation(funclistPtr->C_GenerateRandom(hSession, IV, sizeof(IV)), "C_GenerateRandom()");
+	if (!retVal) {
+		retVal = write_full(outFd, IV, sizeof(IV));
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hSecretkey), "C_EncryptInit()");
+		if (!retVal) {
+			retVal = run_pipeline(inFd, outFd, config, AES_transform(funclistPtr, true), hSession, NULL_PTR, stats);
+			// Finishing the operation also after a failed read or write, so the session can start another one
+			CK_RV rv = finish_operation([&](CK_BYTE_PTR partPtr, CK_ULONG_PTR partLenPtr) {
+											return funclistPtr->C_EncryptFinal(hSession, partPtr, partLenPtr);
+										}, lastPart);
+			if (!retVal) {
+				retVal = check_operation(rv, "C_EncryptFinal()");
+			}
+		}
+	}
+	if (!retVal) {
+		retVal = write_full(outFd, reinterpret_cast<const CK_BYTE*>(lastPart.data()), lastPart.length());
+		stats.bytesOut += sizeof(IV) + lastPart.length();
+	}
+
+	close_files(inFd, outFd, outPath, retVal);
+	return retVal ? 3 : 0;
+}
+
+
+
+/**
+ * The function decrypts given file produced by encrypt_file_pipelined() (or encrypt_file()) through the pipeline
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be decrypted
+ * outPath is an alias of constant path of the decrypted file, which is created or overwritten
+ * stats is an alias of the statistics to be returned
+ * config is an alias of constant configuration of the pipeline
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int decrypt_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+							pipeline_stats& stats, const pipeline_config& config)
+{
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+	struct stat fileStat;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	CK_MECHANISM decMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+	std::string lastPart;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+	if (open_files(inPath, outPath, inFd, outFd)) {
+		return 4;
+	}
+
+	// The IV and at least one block, in whole blocks
+	if (fstat(inFd, &fileStat) || fileStat.st_size < static_cast<off_t>(2 * AES_BLOCK_LEN) ||
+		fileStat.st_size % AES_BLOCK_LEN || read_full(inFd, IV, sizeof(IV)) != sizeof(IV)) {
+		cout << "Error, " << inPath << " is not an encrypted file\n";
+		retVal = 1;
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_DecryptInit(hSession, &decMech, hSecretkey), "C_DecryptInit()");
+		if (!retVal) {
+			retVal = run_pipeline(inFd, outFd, config, AES_transform(funclistPtr, false), hSession, NULL_PTR, stats);
+			CK_RV rv = finish_operation([&](CK_BYTE_PTR partPtr, CK_ULONG_PTR partLenPtr) {
+											return funclistPtr->C_DecryptFinal(hSession, partPtr, partLenPtr);
+										}, lastPart);
+			if (!retVal) {
+				retVal = check_operation(rv, "C_DecryptFinal()");
+			}
+		}
+	}
+	if (!retVal) {
+		retVal = write_full(outFd, reinterpret_cast<const CK_BYTE*>(lastPart.data()), lastPart.length());
+		stats.bytesIn += sizeof(IV);
+		stats.bytesOut += lastPart.length();
+	}
+
+	close_files(inFd, outFd, outPath, retVal);
+	return retVal ? 4 : 0;
+}
+
+
+
+/**
+ * The function digests given file on the token through the pipeline, so the reads overlap C_DigestUpdate()
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ * inPath is an alias of constant path of the file
+ * digest is an alias of the digest to be returned
+ * stats is an alias of the statistics to be returned
+ * config is an alias of constant configuration of the pipeline
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_MECHANISM_TYPE digestMech, const std::string& inPath, std::string& digest,
+							pipeline_stats& stats, const pipeline_config& config)
+{
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+	CK_MECHANISM mech = {digestMech, NULL_PTR, 0};
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 5;
+	}
+	if (open_files(inPath, std::string(), inFd, outFd)) {
+		return 5;
+	}
+
+	retVal = check_operation(funclistPtr->C_DigestInit(hSession, &mech), "C_DigestInit()");
+	if (!retVal) {
+		retVal = run_pipeline(inFd, -1, config, [funclistPtr](CK_SESSION_HANDLE& hWorker, pipeline_chunk& chunk) {
+									return check_operation(funclistPtr->C_DigestUpdate(hWorker, chunk.in.data(), chunk.inLen),
+															"C_DigestUpdate()");
+								}, hSession, NULL_PTR, stats);
+		CK_RV rv = finish_operation([&](CK_BYTE_PTR digestPtr, CK_ULONG_PTR digestLenPtr) {
+										return funclistPtr->C_DigestFinal(hSession, digestPtr, digestLenPtr);
+									}, digest);
+		if (!retVal) {
+			retVal = check_operation(rv, "C_DigestFinal()");
+		}
+	}
+
+	close_files(inFd, -1, std::string(), retVal);
+	if (retVal) {
+		digest.clear();
+		return 5;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function signs given file on the token through the pipeline, so the reads overlap C_SignUpdate()
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant private (or HMAC secret) key handle
+ * signMech is an alias of the multi-part signature mechanism with its parameter
+ * e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_HMAC
+ * inPath is an alias of constant path of the file
+ * signature is an alias of the signature to be returned
+ * stats is an alias of the statistics to be returned
+ * config is an alias of constant configuration of the pipeline
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_file_pipelined(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPrv, CK_MECHANISM& signMech, const std::string& inPath,
+						std::string& signature, pipeline_stats& stats, const pipeline_config& config)
+{
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 6;
+	}
+	if (open_files(inPath, std::string(), inFd, outFd)) {
+		return 6;
+	}
+
+	retVal = check_operation(funclistPtr->C_SignInit(hSession, &signMech, hPrv), "C_SignInit()");
+	if (!retVal) {
+		retVal = run_pipeline(inFd, -1, config, [funclistPtr](CK_SESSION_HANDLE& hWorker, pipeline_chunk& chunk) {
+									return check_operation(funclistPtr->C_SignUpdate(hWorker, chunk.in.data(), chunk.inLen),
+															"C_SignUpdate()");
+								}, hSession, NULL_PTR, stats);
+		CK_RV rv = finish_operation([&](CK_BYTE_PTR sigPtr, CK_ULONG_PTR sigLenPtr) {
+										return funclistPtr->C_SignFinal(hSession, sigPtr, sigLenPtr);
+									}, signature);
+		if (!retVal) {
+			retVal = check_operation(rv, "C_SignFinal()");
+		}
+	}
+
+	close_files(inFd, -1, std::string(), retVal);
+	if (retVal) {
+		signature.clear();
+		return 6;
+	}
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\attribute_template.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\derive_ECDH.hpp"
+#else
+	#include "../header/attribute_template.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/derive_ECDH.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The number of key agreements performed by one queued operation of the batched form
+*/
+const size_t AGREEMENTS_PER_CHUNK = 32;
+
+
+/**
+ * The attributes template of the derived AES secret keys i.e., session keys which cannot
+ * leave the token
+*/
+typedef attribute_template<fixed_attribute<CKA_CLASS, CKO_SECRET_KEY>,
+							fixed_attribute<CKA_KEY_TYPE, CKK_AES>,
+							fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							fixed_attribute<CKA_EXTRACTABLE, CK_FALSE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							variable_attribute<CKA_VALUE_LEN> > derived_key_template;
+
+
+
+/**
+ * The function derives an AES secret key using ECDH i.e., CKM_ECDH1_DERIVE
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant EC private key handle, with CKA_DERIVE set
+ * peerPoint is a constant pointer to the public point of the peer
+ * peerPointLen represents the byte-length of the public point of the peer
+ * kdf is the key derivation function applied to the shared secret e.g., CKD_NULL, CKD_SHA256_KDF
+ * keyLen represents the length of the AES key in bytes i.e., 16, 24 or 32
+ * hKey is an alias of the derived AES key handle to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int derive_ECDH_AES_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPrv, CK_BYTE_PTR const peerPoint, const CK_ULONG peerPointLen,
+						const CK_ULONG kdf, const CK_ULONG keyLen, CK_OBJECT_HANDLE& hKey)
+{
+	derived_key_template keyAttrb;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	/**
+	 * CK_ECDH1_DERIVE_PARAMS is a structure that provides the parameters of CKM_ECDH1_DERIVE
+	 *
+	 * kdf is the key derivation function used on the shared secret value; CKD_NULL means the
+	 * 		key is the leftmost keyLen bytes of the shared secret (x-coordinate)
+	 * pSharedData is the data shared between the two parties, must be NULL_PTR for CKD_NULL
+	 * pPublicData is the public point of the other party
+	*/
+	CK_ECDH1_DERIVE_PARAMS paramECDH;
+	paramECDH.kdf = kdf;
+	paramECDH.ulSharedDataLen = 0;
+	paramECDH.pSharedData = NULL_PTR;
+	paramECDH.ulPublicDataLen = peerPointLen;
+	paramECDH.pPublicData = peerPoint;
+	CK_MECHANISM deriveMech = {CKM_ECDH1_DERIVE, &paramECDH, sizeof(paramECDH)};
+
+	keyAttrb.set<CKA_VALUE_LEN>(keyLen);
+
+	/**
+	 * CK_RV C_DeriveKey(CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism,
+	 * 					CK_OBJECT_HANDLE hBaseKey, CK_ATTRIBUTE_PTR pTemplate,
+	 * 					CK_ULONG ulAttributeCount, CK_OBJECT_HANDLE_PTR phKey);
+	 *
+	 * C_DeriveKey() derives a key from a base key, creating a new key object.
+	 *
+	 * hSession is the session’s handle;
+	 * pMechanism points to a structure that specifies the key derivation mechanism;
+	 * hBaseKey is the handle of the base key;
+	 * pTemplate points to the template for the new key;
+	 * ulAttributeCount is the number of attributes in the template;
+	 * phKey points to the location that receives the handle of the derived key.
+	*/
+	return check_operation(funclistPtr->C_DeriveKey(hSession, &deriveMech, hPrv, keyAttrb.data(), keyAttrb.size(),
+													&hKey), "C_DeriveKey()");
+}
+
+
+
+/**
+ * The function derives AES secret keys of many key agreements across the worker sessions
+ * of given executor
+ *
+ * executor is an alias of started async_executor
+ * requests is an alias of constant list of key agreements
+ * kdf is the key derivation function applied to the shared secrets e.g., CKD_NULL, CKD_SHA256_KDF
+ * keyLen represents the length of the AES keys in bytes i.e., 16, 24 or 32
+ * hKeys is an alias of the derived AES key handles, where hKeys[i] is the key of requests[i]
+ * and CK_INVALID_HANDLE if that agreement failed
+ *
+ * On success i.e., all keys are derived, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int derive_ECDH_AES_keys_batch(async_executor& executor, const std::vector<ecdh_request>& requests,
+								const CK_ULONG kdf, const CK_ULONG keyLen, std::vector<CK_OBJECT_HANDLE>& hKeys)
+{
+	hKeys.assign(requests.size(), CK_INVALID_HANDLE);
+	if (async_batch(executor, requests.size(), AGREEMENTS_PER_CHUNK,
+					[&](const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const size_t i) {
+						CK_BYTE_PTR peerPoint = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(requests[i].peerPoint.data()));
+						if (derive_ECDH_AES_key(funclistPtr, hSession, requests[i].hPrv, peerPoint,
+												requests[i].peerPoint.length(), kdf, keyLen, hKeys[i])) {
+							// A bad peer point fails its own agreement only
+							hKeys[i] = CK_INVALID_HANDLE;
+							return 1;
+						}
+						return 0;
+					}, NULL_PTR)) {
+		cout << "Error, not all of " << requests.size() << " key agreements succeeded" << endl;
+		return 3;
+	}
+	return 0;
+}
@@ -0,0 +1,468 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <openssl/evp.h>
+#ifdef WIND
+	#include <malloc.h>
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\digest_token.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/digest_token.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The alignment of the read buffer i.e., a page, so the reads of the file are page-aligned copies
+*/
+const size_t DIGEST_BUFFER_ALIGNMENT = 4096;
+
+
+
+/**
+ * The deleter of the aligned read buffer
+*/
+struct aligned_buffer_deleter
+{
+	void operator()(CK_BYTE_PTR bufferPtr) const
+	{
+	#ifdef WIND
+		_aligned_free(bufferPtr);
+	#else
+		free(bufferPtr);
+	#endif
+	}
+};
+
+typedef std::unique_ptr<CK_BYTE, aligned_buffer_deleter> aligned_buffer;
+
+
+
+/**
+ * The function allocates the read buffer aligned to DIGEST_BUFFER_ALIGNMENT
+ *
+ * The buffer is returned, which is empty if the allocation failed.
+*/
+static aligned_buffer allocate_aligned_buffer(const size_t bufferSz)
+{
+	void* bufferPtr = NULL_PTR;
+
+#ifdef WIND
+	bufferPtr = _aligned_malloc(bufferSz, DIGEST_BUFFER_ALIGNMENT);
+#else
+	if (posix_memalign(&bufferPtr, DIGEST_BUFFER_ALIGNMENT, bufferSz)) {
+		bufferPtr = NULL_PTR;
+	}
+#endif
+	return aligned_buffer(static_cast<CK_BYTE_PTR>(bufferPtr));
+}
+
+
+
+/**
+ * The deleter of the files opened to be digested
+*/
+struct file_closer
+{
+	void operator()(std::FILE* filePtr) const
+	{
+		std::fclose(filePtr);
+	}
+};
+
+typedef std::unique_ptr<std::FILE, file_closer> file_handle;
+
+
+
+/**
+ * The function opens given file to be read sequentially. The stream is unbuffered, therefore,
+ * each read copies the file straight into the aligned buffer of the caller.
+ *
+ * The file is returned, which is empty if the file could not be opened.
+*/
+static file_handle open_file(const std::string& filePath)
+{
+	file_handle file(std::fopen(filePath.c_str(), "rb"));
+
+	if (!file) {
+		cout << "Error, cannot open " << filePath << endl;
+		return file;
+	}
+	std::setvbuf(file.get(), NULL_PTR, _IONBF, 0);
+	return file;
+}
+
+
+
+/**
+ * The function gets the byte-length of the digest of given mechanism, so the digest is computed
+ * without asking the token for its length first.
+ *
+ * The byte-length is returned, or 0 if it is not known.
+*/
+static CK_ULONG digest_length(const CK_MECHANISM_TYPE digestMech)
+{
+	switch (digestMech) {
+	case CKM_SHA224:	return 28;
+	case CKM_SHA256:	return 32;
+	case CKM_SHA384:	return 48;
+	case CKM_SHA512:	return 64;
+	default:			return 0;
+	}
+}
+
+
+
+/**
+ * The function maps the digest mechanism to its OpenSSL name
+ *
+ * The name is returned, or NULL_PTR if the mechanism is not supported.
+*/
+static const char* digest_name(const CK_MECHANISM_TYPE digestMech)
+{
+	switch (digestMech) {
+	case CKM_SHA224:	return "SHA224";
+	case CKM_SHA256:	return "SHA256";
+	case CKM_SHA384:	return "SHA384";
+	case CKM_SHA512:	return "SHA512";
+	default:			return NULL_PTR;
+	}
+}
+
+
+
+/**
+ * The function initializes a multi-part digest
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech)
+{
+	// The SHA-2 mechanisms do not have a parameter
+	CK_MECHANISM mech = {digestMech, NULL_PTR, 0};
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	/**
+	 * CK_RV C_DigestInit(CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism);
+	 *
+	 * C_DigestInit() initializes a message-digesting operation. Only one digest operation
+	 * can be active in a session at a time.
+	*/
+	return check_operation(funclistPtr->C_DigestInit(hSession, &mech), "C_DigestInit()");
+}
+
+
+
+/**
+ * The function continues a multi-part digest with the next part of the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * partPtr is a constant pointer to the part of the message
+ * partLen represents the byte-length of the part
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					CK_BYTE_PTR const partPtr, const CK_ULONG partLen)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+
+	/**
+	 * CK_RV C_DigestUpdate(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG ulPartLen);
+	 *
+	 * C_DigestUpdate() continues a multiple-part message-digesting operation, processing another
+	 * data part. On failure, the operation is terminated.
+	*/
+	return check_operation(funclistPtr->C_DigestUpdate(hSession, partPtr, partLen), "C_DigestUpdate()");
+}
+
+
+
+/**
+ * The function continues a multi-part digest with the value of a secret key
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hKey is an alias of constant secret key handle
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hKey)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+
+	/**
+	 * CK_RV C_DigestKey(CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hKey);
+	 *
+	 * C_DigestKey() continues a multiple-part message-digesting operation by digesting the
+	 * value of a secret key, which never leaves the token.
+	*/
+	return check_operation(funclistPtr->C_DigestKey(hSession, hKey), "C_DigestKey()");
+}
+
+
+
+/**
+ * The function finishes a multi-part digest
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism given to digest_init()
+ * digest is an alias of the digest to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_MECHANISM_TYPE digestMech, std::string& digest)
+{
+	CK_ULONG digestLen = digest_length(digestMech);
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 5;
+	}
+
+	/**
+	 * CK_RV C_DigestFinal(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pDigest, CK_ULONG_PTR pulDigestLen);
+	 *
+	 * C_DigestFinal() finishes a multiple-part message-digesting operation. If pDigest is NULL_PTR,
+	 * then only the length is returned and the operation is not finished.
+	*/
+	if (!digestLen && check_operation(funclistPtr->C_DigestFinal(hSession, NULL_PTR, &digestLen),
+										"C_DigestFinal()")) {
+		return 5;
+	}
+	digest.resize(digestLen);
+	if (check_operation(funclistPtr->C_DigestFinal(hSession, reinterpret_cast<CK_BYTE_PTR>(&digest[0]), &digestLen),
+						"C_DigestFinal()")) {
+		return 5;
+	}
+	digest.resize(digestLen);
+	return 0;
+}
+
+
+
+/**
+ * The function digests given message in a single part
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ * message is an alias of constant message to be digested
+ * digest is an alias of the digest to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_data(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech, const std::string& message, std::string& digest)
+{
+	CK_ULONG digestLen = digest_length(digestMech);
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+
+	if (digest_init(funclistPtr, hSession, digestMech)) {
+		return 6;
+	}
+
+	/**
+	 * CK_RV C_Digest(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG ulDataLen,
+	 * 				CK_BYTE_PTR pDigest, CK_ULONG_PTR pulDigestLen);
+	 *
+	 * C_Digest() digests data in a single part.
+	*/
+	if (!digestLen && check_operation(funclistPtr->C_Digest(hSession, msgPtr, message.length(), NULL_PTR, &digestLen),
+										"C_Digest()")) {
+		return 6;
+	}
+	digest.resize(digestLen);
+	if (check_operation(funclistPtr->C_Digest(hSession, msgPtr, message.length(),
+												reinterpret_cast<CK_BYTE_PTR>(&digest[0]), &digestLen), "C_Digest()")) {
+		return 6;
+	}
+	digest.resize(digestLen);
+	return 0;
+}
+
+
+
+/**
+ * The function digests given file on the token in constant memory i.e., the file is read through
+ * one aligned buffer of bufferSz bytes, and each filled buffer is one C_DigestUpdate() call.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ * filePath is an alias of constant path of the file
+ * digest is an alias of the digest to be returned
+ * bufferSz represents the byte-length of the read buffer
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_MECHANISM_TYPE digestMech, const std::string& filePath, std::string& digest,
+				const size_t bufferSz)
+{
+	size_t readLen = 0;
+	aligned_buffer buffer = allocate_aligned_buffer(bufferSz);
+	file_handle file = open_file(filePath);
+
+	if (!buffer || !file) {
+		return 7;
+	}
+	if (digest_init(funclistPtr, hSession, digestMech)) {
+		return 7;
+	}
+
+	while ((readLen = std::fread(buffer.get(), 1, bufferSz, file.get())) > 0) {
+		if (digest_update(funclistPtr, hSession, buffer.get(), readLen)) {
+			// The failed C_DigestUpdate() has already terminated the operation
+			return 7;
+		}
+	}
+	if (std::ferror(file.get())) {
+		cout << "Error, cannot read " << filePath << endl;
+		// Finishing the operation, so the session can start another one
+		digest_final(funclistPtr, hSession, digestMech, digest);
+		digest.clear();
+		return 7;
+	}
+	return digest_final(funclistPtr, hSession, digestMech, digest) ? 7 : 0;
+}
+
+
+
+/**
+ * The function digests given file on the host (OpenSSL) in the same way as digest_file()
+ *
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ * filePath is an alias of constant path of the file
+ * digest is an alias of the digest to be returned
+ * bufferSz represents the byte-length of the read buffer
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_file_host(const CK_MECHANISM_TYPE digestMech, const std::string& filePath, std::string& digest,
+						const size_t bufferSz)
+{
+	int retVal = 0;
+	size_t readLen = 0;
+	unsigned int digestLen = 0;
+	const char* name = digest_name(digestMech);
+
+	if (!name) {
+		cout << "Error, digest mechanism is not supported on the host\n";
+		return 8;
+	}
+
+	aligned_buffer buffer = allocate_aligned_buffer(bufferSz);
+	file_handle file = open_file(filePath);
+	EVP_MD* md = EVP_MD_fetch(NULL_PTR, name, NULL_PTR);
+	EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+
+	if (!buffer || !file || !md || !ctx || EVP_DigestInit_ex(ctx, md, NULL_PTR) != 1) {
+		retVal = 8;
+	}
+	while (!retVal && (readLen = std::fread(buffer.get(), 1, bufferSz, file.get())) > 0) {
+		if (EVP_DigestUpdate(ctx, buffer.get(), readLen) != 1) {
+			retVal = 8;
+		}
+	}
+	if (!retVal && std::ferror(file.get())) {
+		cout << "Error, cannot read " << filePath << endl;
+		retVal = 8;
+	}
+	if (!retVal) {
+		digest.resize(EVP_MAX_MD_SIZE);
+		if (EVP_DigestFinal_ex(ctx, reinterpret_cast<unsigned char*>(&digest[0]), &digestLen) != 1) {
+			retVal = 8;
+		}
+		digest.resize(retVal ? 0 : digestLen);
+	}
+
+	EVP_MD_CTX_free(ctx);
+	EVP_MD_free(md);
+	return retVal;
+}
+
+
+
+/**
+ * The function computes the throughput in MiB/s of the given number of bytes over given time
+*/
+static double throughput(const unsigned long long byteCount, const std::chrono::steady_clock::duration elapsed)
+{
+	double seconds = std::chrono::duration<double>(elapsed).count();
+
+	return seconds > 0 ? byteCount / (1024.0 * 1024.0) / seconds : 0;
+}
+
+
+
+/**
+ * The function digests given file on the token and on the host with the same read buffer size,
+ * and measures the throughput of both paths. The digests are compared, therefore, a mismatch is
+ * reported as an error.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * digestMech is the digest mechanism e.g., CKM_SHA256
+ * filePath is an alias of constant path of the file
+ * result is an alias of the digests and throughputs to be returned
+ * bufferSz represents the byte-length of the read buffer
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int digest_file_benchmark(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_MECHANISM_TYPE digestMech, const std::string& filePath,
+							digest_benchmark& result, const size_t bufferSz)
+{
+	std::chrono::steady_clock::time_point start;
+	file_handle file = open_file(filePath);
+
+	if (!file || std::fseek(file.get(), 0, SEEK_END)) {
+		return 9;
+	}
+	result.fileSize = std::ftell(file.get());
+	file.reset();
+
+	start = std::chrono::steady_clock::now();
+	if (digest_file(funclistPtr, hSession, digestMech, filePath, result.tokenDigest, bufferSz)) {
+		return 9;
+	}
+	result.tokenMiBps = throughput(result.fileSize, std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+	if (digest_file_host(digestMech, filePath, result.hostDigest, bufferSz)) {
+		return 9;
+	}
+	result.hostMiBps = throughput(result.fileSize, std::chrono::steady_clock::now() - start);
+
+	if (result.tokenDigest != result.hostDigest) {
+		cout << "Error, digests of the token and the host are different\n";
+		return 9;
+	}
+	return 0;
+}
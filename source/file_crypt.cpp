@@ -0,0 +1,418 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\file_crypt.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/file_crypt.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * AES uses 128-bit (16-byte) block, which is also the byte-length of the IV
+*/
+const size_t AES_BLOCK_LEN = 16;
+
+
+
+/**
+ * A memory-mapped file, whose pages are released behind the processed chunk
+*/
+class mapped_file
+{
+public:
+	mapped_file() : fd(-1), addr(NULL_PTR), length(0), released(0), writable(false) {}
+
+	~mapped_file() { close(); }
+
+	int open_input(const std::string& path);
+
+	int open_output(const std::string& path, const size_t length);
+
+	int truncate(const size_t newLength);
+
+	void release_upto(const size_t end);
+
+	void close();
+
+	CK_BYTE_PTR data() const { return addr; }
+
+	size_t size() const { return length; }
+
+private:
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	int map();
+
+	int fd;
+	CK_BYTE_PTR addr;
+	size_t length;
+	size_t released;
+	bool writable;
+};
+
+
+
+/**
+ * The function maps the opened file, where an empty file is not mapped
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mapped_file::map()
+{
+	void* mapPtr = NULL_PTR;
+
+	if (!length) {
+		return 0;
+	}
+	mapPtr = mmap(NULL_PTR, length, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+					writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+	if (mapPtr == MAP_FAILED) {
+		cout << "Error, mmap() failed: " << std::strerror(errno) << endl;
+		return 1;
+	}
+	addr = static_cast<CK_BYTE_PTR>(mapPtr);
+	// The chunks are processed in order, so the kernel can read ahead aggressively
+	madvise(addr, length, MADV_SEQUENTIAL);
+	return 0;
+}
+
+
+
+/**
+ * The function maps given file to be read
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mapped_file::open_input(const std::string& path)
+{
+	struct stat fileStat;
+
+	fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0 || fstat(fd, &fileStat)) {
+		cout << "Error, cannot open " << path << ": " << std::strerror(errno) << endl;
+		return 1;
+	}
+	length = fileStat.st_size;
+	writable = false;
+	return map();
+}
+
+
+
+/**
+ * The function creates (or truncates) given file, preallocates it to given byte-length and maps it to be written
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mapped_file::open_output(const std::string& path, const size_t newLength)
+{
+	int err = 0;
+
+	fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		cout << "Error, cannot create " << path << ": " << std::strerror(errno) << endl;
+		return 1;
+	}
+	length = newLength;
+	writable = true;
+	// Allocating the blocks up front, so running out of disk space fails here and not as SIGBUS while writing
+	if (length && (err = posix_fallocate(fd, 0, length))) {
+		cout << "Error, cannot preallocate " << path << ": " << std::strerror(err) << endl;
+		return 1;
+	}
+	return map();
+}
+
+
+
+/**
+ * The function unmaps the file and shrinks it to given byte-length e.g., the length of a decrypted file
+ * is known after C_DecryptFinal() only
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mapped_file::truncate(const size_t newLength)
+{
+	if (addr) {
+		munmap(addr, length);
+		addr = NULL_PTR;
+	}
+	length = newLength;
+	if (ftruncate(fd, length)) {
+		cout << "Error, ftruncate() failed: " << std::strerror(errno) << endl;
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function releases the whole pages of the mapping behind given byte offset, so only the pages
+ * of the current chunk stay resident. The dirty pages of the output are queued for writeback first.
+*/
+void mapped_file::release_upto(const size_t end)
+{
+	static const size_t pageSz = sysconf(_SC_PAGESIZE);
+	size_t pageEnd = end / pageSz * pageSz;
+
+	if (!addr || pageEnd <= released) {
+		return;
+	}
+	if (writable) {
+		msync(addr + released, pageEnd - released, MS_ASYNC);
+	}
+	madvise(addr + released, pageEnd - released, MADV_DONTNEED);
+	released = pageEnd;
+}
+
+
+
+/**
+ * The function unmaps and closes the file
+*/
+void mapped_file::close()
+{
+	if (addr) {
+		munmap(addr, length);
+		addr = NULL_PTR;
+	}
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	}
+	length = 0;
+	released = 0;
+}
+
+
+
+/**
+ * The function streams the input [inBegin, in.size()) through the initialized encryption (decryption)
+ * operation chunk by chunk, writing straight into the output from outBegin, and finishes the operation.
+ * The chunks end on multiples of chunkSz, so after a prefix e.g., the IV of an encrypted file, only the
+ * first chunk is shorter and every other chunk starts on a page boundary of the input.
+ *
+ * encrypt is true for C_EncryptUpdate()/C_EncryptFinal() and false for C_DecryptUpdate()/C_DecryptFinal()
+ * outEnd is an alias of the end of the output to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int crypt_stream(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const bool encrypt,
+						mapped_file& in, const size_t inBegin, mapped_file& out, const size_t outBegin,
+						const size_t chunkSz, size_t& outEnd, file_crypt_stats& stats)
+{
+	CK_RV rv = CKR_OK;
+	CK_ULONG partLen = 0;
+	size_t outOffset = outBegin;
+
+	for (size_t inOffset = inBegin, inEnd = 0; inOffset < in.size(); inOffset = inEnd) {
+		inEnd = (inOffset / chunkSz + 1) * chunkSz;
+		if (inEnd > in.size()) {
+			inEnd = in.size();
+		}
+		CK_ULONG inLen = inEnd - inOffset;
+
+		// On input, the remaining capacity of the output. On output, the byte-length written
+		partLen = out.size() - outOffset;
+		rv = encrypt ? funclistPtr->C_EncryptUpdate(hSession, in.data() + inOffset, inLen, out.data() + outOffset, &partLen)
+						: funclistPtr->C_DecryptUpdate(hSession, in.data() + inOffset, inLen, out.data() + outOffset, &partLen);
+		if (check_operation(rv, encrypt ? "C_EncryptUpdate()" : "C_DecryptUpdate()")) {
+			// The failed update has already terminated the operation
+			return 1;
+		}
+		outOffset += partLen;
+		++stats.chunkCount;
+
+		in.release_upto(inEnd);
+		out.release_upto(outOffset);
+	}
+
+	partLen = out.size() - outOffset;
+	rv = encrypt ? funclistPtr->C_EncryptFinal(hSession, out.data() + outOffset, &partLen)
+					: funclistPtr->C_DecryptFinal(hSession, out.data() + outOffset, &partLen);
+	if (check_operation(rv, encrypt ? "C_EncryptFinal()" : "C_DecryptFinal()")) {
+		return 1;
+	}
+	outEnd = outOffset + partLen;
+	return 0;
+}
+
+
+
+/**
+ * The function checks the chunk byte-length i.e., a non-zero multiple of the page size, so the pages
+ * of the mappings are released in whole chunks
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int check_chunk_size(const size_t chunkSz)
+{
+	size_t pageSz = sysconf(_SC_PAGESIZE);
+
+	if (!chunkSz || chunkSz % pageSz) {
+		cout << "Error, chunk size should be a multiple of the page size (" << pageSz << " bytes)\n";
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function fills the time and throughput of the statistics
+*/
+static void finish_stats(file_crypt_stats& stats, const std::chrono::steady_clock::time_point start)
+{
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	stats.MiBps = stats.seconds > 0 ? stats.bytesIn / (1024.0 * 1024.0) / stats.seconds : 0;
+}
+
+
+
+/**
+ * The function encrypts given file using CKM_AES_CBC_PAD with a random IV, where the output file is
+ * the IV followed by the ciphertext
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be encrypted
+ * outPath is an alias of constant path of the encrypted file, which is created or overwritten
+ * stats is an alias of the statistics to be returned
+ * chunkSz represents the byte-length of the chunks, a multiple of the page size
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int encrypt_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					file_crypt_stats& stats, const size_t chunkSz)
+{
+	int retVal = 0;
+	size_t outEnd = 0;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	mapped_file in;
+	mapped_file out;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	if (check_chunk_size(chunkSz) || in.open_input(inPath)) {
+		return 2;
+	}
+
+	stats = file_crypt_stats();
+	stats.bytesIn = in.size();
+	// The IV and the plaintext padded to whole blocks, where a whole block of padding is added to whole blocks
+	if (out.open_output(outPath, AES_BLOCK_LEN + (in.size() / AES_BLOCK_LEN + 1) * AES_BLOCK_LEN)) {
+		retVal = 2;
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_GenerateRandom(hSession, IV, sizeof(IV)), "C_GenerateRandom()");
+	}
+	if (!retVal) {
+		CK_MECHANISM encMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+		std::memcpy(out.data(), IV, sizeof(IV));
+		retVal = check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hSecretkey), "C_EncryptInit()");
+	}
+	if (!retVal) {
+		retVal = crypt_stream(funclistPtr, hSession, true, in, 0, out, AES_BLOCK_LEN, chunkSz, outEnd, stats);
+	}
+	if (!retVal && outEnd != out.size()) {
+		// Not expected with CKM_AES_CBC_PAD, but the file has to end at the last byte written
+		retVal = out.truncate(outEnd);
+	}
+
+	out.close();
+	if (retVal) {
+		std::remove(outPath.c_str());
+		return 2;
+	}
+	stats.bytesOut = outEnd;
+	finish_stats(stats, start);
+	return 0;
+}
+
+
+
+/**
+ * The function decrypts given file produced by encrypt_file()
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be decrypted
+ * outPath is an alias of constant path of the decrypted file, which is created or overwritten
+ * stats is an alias of the statistics to be returned
+ * chunkSz represents the byte-length of the chunks, a multiple of the page size
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int decrypt_file(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					file_crypt_stats& stats, const size_t chunkSz)
+{
+	int retVal = 0;
+	size_t outEnd = 0;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	mapped_file in;
+	mapped_file out;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	if (check_chunk_size(chunkSz) || in.open_input(inPath)) {
+		return 3;
+	}
+	// The IV and at least one block, in whole blocks
+	if (in.size() < 2 * AES_BLOCK_LEN || in.size() % AES_BLOCK_LEN) {
+		cout << "Error, " << inPath << " is not an encrypted file\n";
+		return 3;
+	}
+
+	stats = file_crypt_stats();
+	stats.bytesIn = in.size();
+	std::memcpy(IV, in.data(), sizeof(IV));
+	CK_MECHANISM decMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+
+	// The plaintext is shorter than the ciphertext by the padding, which is known after C_DecryptFinal() only
+	if (out.open_output(outPath, in.size() - AES_BLOCK_LEN)) {
+		retVal = 3;
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_DecryptInit(hSession, &decMech, hSecretkey), "C_DecryptInit()");
+	}
+	if (!retVal) {
+		retVal = crypt_stream(funclistPtr, hSession, false, in, AES_BLOCK_LEN, out, 0, chunkSz, outEnd, stats);
+	}
+	if (!retVal) {
+		retVal = out.truncate(outEnd);
+	}
+
+	out.close();
+	if (retVal) {
+		std::remove(outPath.c_str());
+		return 3;
+	}
+	stats.bytesOut = outEnd;
+	finish_stats(stats, start);
+	return 0;
+}
@@ -1,8 +1,10 @@
 #include <iostream>
 #ifdef WIND
+	#include "..\header\attribute_template.hpp"
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\gen_AES_keys.hpp"
 #else
+	#include "../header/attribute_template.hpp"
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/gen_AES_keys.hpp"
 #endif
@@ -16,6 +18,21 @@
 CK_MECHANISM keyMech = {CKM_AES_KEY_GEN};
 
 
+/**
+ * The attributes template of AES secret keys
+ * 
+ * */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							fixed_attribute<CKA_EXTRACTABLE, CK_TRUE>,
+							fixed_attribute<CKA_MODIFIABLE, CK_FALSE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							variable_attribute<CKA_LABEL>,
+							variable_attribute<CKA_VALUE_LEN> > AES_key_template;
+
+
 
 /**
  * The function generates AES secret key based on given parameters
@@ -31,26 +48,16 @@ int gen_AES_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSess
 				const std::string& keyLabel)
 {
 	int retVal = 0;
-	CK_BBOOL yes = CK_TRUE;
-    CK_BBOOL no = CK_FALSE;
+	AES_key_template keyAttrb;
 
 	// Checking whether funclistPtr is null or not 
 	if (is_nullptr(funclistPtr)) {
 		return 4;
 	}
     
-
-    CK_ATTRIBUTE keyAttrb[] = {
-		{CKA_TOKEN,				&yes,									sizeof(yes)},
-        {CKA_PRIVATE,			&yes,									sizeof(yes)},
-        {CKA_SENSITIVE,			&yes,									sizeof(yes)},
-        {CKA_EXTRACTABLE,		&yes,									sizeof(yes)},
-        {CKA_MODIFIABLE,		&no,									sizeof(no)},
-        {CKA_ENCRYPT,			&yes,									sizeof(yes)},
-        {CKA_DECRYPT,			&yes,									sizeof(yes)},
-        {CKA_LABEL,				const_cast<char*>(keyLabel.c_str()),	keyLabel.length()},
-		{CKA_VALUE_LEN,			&keyLen,								sizeof(keyLen)}
-    };
+	// Only the variable attributes are patched, the remaining are laid out at compile time
+	keyAttrb.set_bytes<CKA_LABEL>(keyLabel.c_str(), keyLabel.length());
+	keyAttrb.set<CKA_VALUE_LEN>(keyLen);
 
     /**
 	 * CK_RV C_GenerateKey(CK_SESSION_HANDLE hSession, 
@@ -71,8 +78,8 @@ int gen_AES_key(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSess
 	 * mechanism, the template does not need to supply a key type. The CKA_CLASS attribute is
 	 * treated similarly.
 	*/
-    retVal = check_operation(funclistPtr->C_GenerateKey(hSession, &keyMech, keyAttrb, 
-														sizeof(keyAttrb) / sizeof(*keyAttrb), 
+    retVal = check_operation(funclistPtr->C_GenerateKey(hSession, &keyMech, keyAttrb.data(), 
+														keyAttrb.size(), 
 														hkeyPtr), "C_GenerateKey()");
 
     return retVal;
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#ifdef WIND
+	#include "..\header\attribute_template.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\gen_AES_keys_bulk.hpp"
+#else
+	#include "../header/attribute_template.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/gen_AES_keys_bulk.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The number of keys generated by one queued operation, large enough to amortize queuing
+ * and small enough to balance the keys across the worker sessions
+*/
+const size_t KEYS_PER_CHUNK = 64;
+
+/**
+ * The interval of reporting the progress on the calling thread
+*/
+const std::chrono::milliseconds PROGRESS_INTERVAL(250);
+
+/**
+ * The attributes template of the AES secret keys generated in bulk. CKA_ID is the last
+ * attribute so that it is left out by the count when the keys have no ID.
+ *
+ * */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							fixed_attribute<CKA_EXTRACTABLE, CK_TRUE>,
+							fixed_attribute<CKA_MODIFIABLE, CK_FALSE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							variable_attribute<CKA_VALUE_LEN>,
+							variable_attribute<CKA_LABEL>,
+							variable_attribute<CKA_ID> > AES_bulk_key_template;
+
+
+
+/**
+ * The function builds the name (label or ID) of a key from its index
+ *
+ * prefix is an alias of constant prefix of the name
+ * width represents the minimum number of digits of the index, padded with zeros
+ * index is the index of the key
+ *
+ * The name of the key is returned.
+*/
+std::string key_name(const std::string& prefix, const size_t width, const size_t index)
+{
+	char digits[32];
+
+	snprintf(digits, sizeof(digits), "%0*zu", static_cast<int>(width < 20 ? width : 20), index);
+	return prefix + digits;
+}
+
+
+
+/**
+ * The function generates the keys of indexes [begin, end) on a worker session by reusing
+ * one template. Only CKA_LABEL and CKA_ID are updated per key.
+ *
+ * The handle of the key i is stored at hKeys[i], therefore, workers do not share any element.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int gen_AES_keys_chunk(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+								const CK_ULONG keyLen, const key_name_pattern& pattern,
+								const size_t begin, const size_t end, CK_OBJECT_HANDLE* hKeys,
+								std::atomic<size_t>& generated, std::atomic<bool>& failed)
+{
+	CK_MECHANISM keyMech = {CKM_AES_KEY_GEN};
+	AES_bulk_key_template keyAttrb;
+	std::string label, id;
+	// CKA_ID is the last attribute, left out when the keys have no ID
+	const CK_ULONG attrbCount = pattern.idPrefix.empty() ? keyAttrb.size() - 1 : keyAttrb.size();
+
+	keyAttrb.set<CKA_VALUE_LEN>(keyLen);
+
+	for (size_t i = begin; i < end; ++i) {
+		// Another chunk failed, do not waste the token on keys which would be discarded
+		if (failed) {
+			return 0;
+		}
+
+		label = key_name(pattern.labelPrefix, pattern.width, i);
+		keyAttrb.set_bytes<CKA_LABEL>(label.c_str(), label.length());
+		if (!pattern.idPrefix.empty()) {
+			id = key_name(pattern.idPrefix, pattern.width, i);
+			keyAttrb.set_bytes<CKA_ID>(id.c_str(), id.length());
+		}
+
+		if (check_operation(funclistPtr->C_GenerateKey(hSession, &keyMech, keyAttrb.data(), attrbCount,
+														&hKeys[i]), "C_GenerateKey()")) {
+			hKeys[i] = CK_INVALID_HANDLE;
+			failed = true;
+			return 1;
+		}
+		++generated;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function generates given number of AES secret keys across the worker sessions of
+ * given executor, named by given pattern.
+ *
+ * executor is an alias of started async_executor
+ * keyLen represents the length of the keys in bytes i.e., 16, 24 or 32
+ * pattern is an alias of constant label/ID pattern of the keys
+ * keyCount represents the number of keys to be generated
+ * hKeys is an alias of the handles of the keys, where hKeys[i] is the key of index i
+ * progress is the progress callback, may be empty
+ *
+ * On failure, the keys generated so far are kept and their handles are returned
+ * (CK_INVALID_HANDLE for the keys not generated), so the caller may destroy them.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int gen_AES_keys_bulk(async_executor& executor, const CK_ULONG keyLen, const key_name_pattern& pattern,
+						const size_t keyCount, std::vector<CK_OBJECT_HANDLE>& hKeys,
+						bulk_progress progress)
+{
+	std::atomic<size_t> generated(0);
+	std::atomic<bool> failed(false);
+	std::vector<std::future<int> > chunks;
+	int retVal = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(executor.function_list())) {
+		return 2;
+	}
+	if (!executor.worker_count()) {
+		cout << "Error, executor is not started\n";
+		return 2;
+	}
+
+	hKeys.assign(keyCount, CK_INVALID_HANDLE);
+	chunks.reserve(keyCount / KEYS_PER_CHUNK + 1);
+	for (size_t begin = 0; begin < keyCount; begin += KEYS_PER_CHUNK) {
+		size_t end = begin + KEYS_PER_CHUNK < keyCount ? begin + KEYS_PER_CHUNK : keyCount;
+		chunks.push_back(async_operation(executor, gen_AES_keys_chunk, keyLen, std::cref(pattern),
+											begin, end, hKeys.data(), std::ref(generated), std::ref(failed)));
+	}
+
+	// Reporting the progress until every chunk is done
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		while (chunks[i].wait_for(PROGRESS_INTERVAL) != std::future_status::ready) {
+			if (progress) {
+				progress(generated, keyCount);
+			}
+		}
+		if (chunks[i].get()) {
+			retVal = 3;
+		}
+	}
+	if (progress) {
+		progress(generated, keyCount);
+	}
+
+	if (retVal) {
+		cout << "Error, only " << generated << " of " << keyCount << " AES keys are generated" << endl;
+	}
+	return retVal;
+}
@@ -1,13 +1,41 @@
 #include <iostream>
 #ifdef WIND
+	#include "..\header\attribute_template.hpp"
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\gen_EC_keypair.hpp"
 #else
+	#include "../header/attribute_template.hpp"
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/gen_EC_keypair.hpp"
 #endif
 
 
+/**
+ * The labels of EC public and private keys
+ */
+const CK_UTF8CHAR pubLabel[] = "EC public key";
+const CK_UTF8CHAR prvLabel[] = "EC private key";
+
+/**
+ * The EC public key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+							fixed_attribute<CKA_PRIVATE, CK_FALSE>,
+							fixed_attribute<CKA_VERIFY, CK_TRUE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							variable_attribute<CKA_EC_PARAMS>,
+							variable_attribute<CKA_LABEL> > EC_public_template;
+
+/**
+ * The EC private key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SIGN, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							fixed_attribute<CKA_DERIVE, CK_TRUE>,		// ECDH key agreement i.e., CKM_ECDH1_DERIVE
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							variable_attribute<CKA_LABEL> > EC_private_template;
 
 
 
@@ -54,10 +82,8 @@ int gen_EC_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hS
 	*/
 
     CK_MECHANISM mech = {CKM_EC_KEY_PAIR_GEN};
-    CK_BBOOL yes = CK_TRUE;
-    CK_BBOOL no = CK_FALSE;
-    CK_UTF8CHAR pubLabel[] = "EC public key";
-    CK_UTF8CHAR prvLabel[] = "EC private key";
+    EC_public_template attribPub;
+    EC_private_template attribPrv;
 	
 
 	/**
@@ -77,25 +103,14 @@ int gen_EC_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hS
 	 * If an attribute has no value, then ulValueLen = 0, and the value of pValue is irrelevant.
 	 * An array of CK_ATTRIBUTEs is called a “template” and is used for creating,
 	 * manipulating and searching for objects
+	 * 
+	 * The attributes of the templates are laid out at compile time, and only the variable
+	 * attributes are patched per call.
 	*/
 
-    CK_ATTRIBUTE attribPub[] = {
-        {CKA_TOKEN,				&yes,			sizeof(yes)},
-        {CKA_PRIVATE,			&no,			sizeof(no)},
-        {CKA_VERIFY,			&yes,			sizeof(yes)},
-        {CKA_ENCRYPT,			&yes,			sizeof(yes)},
-        {CKA_EC_PARAMS,			ecPara,			ecParaSZ},
-        {CKA_LABEL,				&pubLabel,		sizeof(pubLabel)}
-    };
-    
-    CK_ATTRIBUTE attribPrv[] = {
-        {CKA_TOKEN,				&yes,			sizeof(yes)},
-        {CKA_PRIVATE,			&yes,			sizeof(yes)},
-        {CKA_SIGN,				&yes,			sizeof(yes)},
-        {CKA_DECRYPT,			&yes,			sizeof(yes)},
-        {CKA_SENSITIVE,			&yes,			sizeof(yes)},
-        {CKA_LABEL,				&prvLabel,		sizeof(prvLabel)}
-    };
+	attribPub.set_bytes<CKA_EC_PARAMS>(ecPara, ecParaSZ);
+	attribPub.set_bytes<CKA_LABEL>(pubLabel, sizeof(pubLabel));
+	attribPrv.set_bytes<CKA_LABEL>(prvLabel, sizeof(prvLabel));
     
 	/**
 	 * CK_RV C_GenerateKeyPair(CK_SESSION_HANDLE hSession,
@@ -128,8 +143,8 @@ int gen_EC_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hS
 	 * 
 	*/
 	retVal = check_operation(funclistPtr->C_GenerateKeyPair(hSession, &mech, 
-											attribPub, sizeof(attribPub) / sizeof(*attribPub),
-											attribPrv, sizeof(attribPrv) / sizeof(*attribPrv),
+											attribPub.data(), attribPub.size(),
+											attribPrv.data(), attribPrv.size(),
 											hPubPtr, hPrvPtr), "C_GenerateKeyPair()");
 
 	return retVal;    
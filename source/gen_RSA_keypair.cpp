@@ -1,13 +1,43 @@
 #include <iostream>
 #ifdef WIND
+	#include "..\header\attribute_template.hpp"
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\gen_RSA_keypair.hpp"
 #else
+	#include "../header/attribute_template.hpp"
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/gen_RSA_keypair.hpp"
 #endif
 
 
+/**
+ * The labels of RSA public and private keys
+ */
+const CK_UTF8CHAR pubLabel[] = "RSA public key";
+const CK_UTF8CHAR prvLabel[] = "RSA private key";
+
+/**
+ * The RSA public key attributes template, CKA_MODULUS_BITS should be CK_ULONG
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+                            fixed_attribute<CKA_PRIVATE, CK_FALSE>,
+                            fixed_attribute<CKA_VERIFY, CK_TRUE>,
+                            fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+                            variable_attribute<CKA_MODULUS_BITS>,
+                            variable_attribute<CKA_PUBLIC_EXPONENT>,
+                            variable_attribute<CKA_LABEL> > RSA_public_template;
+
+/**
+ * The RSA private key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_TRUE>,
+                            fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+                            fixed_attribute<CKA_SIGN, CK_TRUE>,
+                            fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+                            fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+                            variable_attribute<CKA_LABEL> > RSA_private_template;
+
+
 /**
  * The function attempts to generate RSA keypair (i.e., public and private keys) 
  * based on given bit size.
@@ -24,7 +54,7 @@
  * 
  */
 int gen_RSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
-					size_t modBitSz, CK_BYTE_PTR const pubExpn, const size_t pubExpnSz,
+					const CK_ULONG modBitSz, CK_BYTE_PTR const pubExpn, const size_t pubExpnSz,
 					CK_OBJECT_HANDLE_PTR hPubPtr, CK_OBJECT_HANDLE_PTR hPrvPtr)
 {
     int retVal = 0;
@@ -44,38 +74,17 @@ int gen_RSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& h
      * 
     */
     CK_MECHANISM mechKey = {CKM_RSA_PKCS_KEY_PAIR_GEN};
-    CK_BBOOL yes = CK_TRUE;
-    CK_BBOOL no = CK_FALSE;
-    CK_UTF8CHAR pubLabel[] = "RSA public key";
-    CK_UTF8CHAR prvLabel[] = "RSA private key";
-
-    /**
-     * Defining the RSA public key attributes template
-     */
-    CK_ATTRIBUTE attribPub[] = {
-        {CKA_TOKEN,             &yes,               sizeof(yes)},
-        {CKA_PRIVATE,           &no,                sizeof(no)},
-        {CKA_VERIFY,            &yes,               sizeof(yes)},
-        {CKA_ENCRYPT,           &yes,               sizeof(yes)},
-        {CKA_MODULUS_BITS,      &modBitSz,          sizeof(modBitSz)},      //RSA keypair bit-length
-        {CKA_PUBLIC_EXPONENT,   pubExpn,            pubExpnSz},
-        {CKA_LABEL,             &pubLabel,          sizeof(pubLabel)}
-    };
-
-    // std::cout << "Public key attributes\n" 
-    //           << "\t Modulus bit-size       :: " << *(reinterpret_cast<CK_ULONG_PTR>(attribPub[4].pValue)) << std::endl;
+    RSA_public_template attribPub;
+    RSA_private_template attribPrv;
 
     /**
-     * Defining the RSA private key attributes template
+     * Patching the variable attributes of the RSA public and private key templates,
+     * the remaining attributes are laid out at compile time
      */
-    CK_ATTRIBUTE attribPrv[] = {
-        {CKA_TOKEN,             &yes,               sizeof(yes)},
-        {CKA_PRIVATE,           &yes,               sizeof(yes)},
-        {CKA_SIGN,              &yes,               sizeof(yes)},
-        {CKA_DECRYPT,           &yes,               sizeof(yes)},
-        {CKA_SENSITIVE,         &yes,               sizeof(yes)},
-        {CKA_LABEL,             &prvLabel,          sizeof(prvLabel)}
-    };
+    attribPub.set<CKA_MODULUS_BITS>(modBitSz);      //RSA keypair bit-length
+    attribPub.set_bytes<CKA_PUBLIC_EXPONENT>(pubExpn, pubExpnSz);
+    attribPub.set_bytes<CKA_LABEL>(pubLabel, sizeof(pubLabel));
+    attribPrv.set_bytes<CKA_LABEL>(prvLabel, sizeof(prvLabel));
 
     /**
      * C_GenerateKeyPair() generates a public/private key pair, creating new key objects.
@@ -89,8 +98,8 @@ int gen_RSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& h
      * 
      */
     retVal = check_operation(funclistPtr->C_GenerateKeyPair(hSession, &mechKey, 
-											attribPub, sizeof(attribPub) / sizeof(*attribPub),
-											attribPrv, sizeof(attribPrv) / sizeof(*attribPrv),
+											attribPub.data(), attribPub.size(),
+											attribPrv.data(), attribPrv.size(),
 											hPubPtr, hPrvPtr), "C_GenerateKeyPair()");
 
 
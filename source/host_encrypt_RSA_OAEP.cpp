@@ -0,0 +1,334 @@
+#include <iostream>
+#include <vector>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/param_build.h>
+#include <openssl/rsa.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\object_attributes.hpp"
+	#include "..\header\host_encrypt_RSA_OAEP.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/object_attributes.hpp"
+	#include "../header/host_encrypt_RSA_OAEP.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function gets the OAEP parameters used by encrypt_plaintext() of RSA_OAEP_enc_dec.cpp
+ * i.e., SHA-1, MGF1 with SHA-1 and an empty encoding parameter.
+ *
+ * The OAEP parameters are returned.
+*/
+CK_RSA_PKCS_OAEP_PARAMS default_OAEP_params()
+{
+	CK_RSA_PKCS_OAEP_PARAMS paramOAEP;
+
+	paramOAEP.hashAlg = CKM_SHA_1;
+	paramOAEP.mgf = CKG_MGF1_SHA1;
+	paramOAEP.source = CKZ_DATA_SPECIFIED;
+	paramOAEP.pSourceData = NULL_PTR;
+	paramOAEP.ulSourceDataLen = 0;
+	return paramOAEP;
+}
+
+
+
+/**
+ * The function maps the hash algorithm of OAEP to its OpenSSL name
+ *
+ * The name is returned, or NULL_PTR if the hash algorithm is not supported.
+*/
+static const char* hash_name(const CK_MECHANISM_TYPE hashAlg)
+{
+	switch (hashAlg) {
+	case CKM_SHA_1:		return "SHA1";
+	case CKM_SHA224:	return "SHA224";
+	case CKM_SHA256:	return "SHA256";
+	case CKM_SHA384:	return "SHA384";
+	case CKM_SHA512:	return "SHA512";
+	default:			return NULL_PTR;
+	}
+}
+
+
+
+/**
+ * The function maps the mask generation function (MGF) of OAEP to the OpenSSL name of its hash
+ *
+ * The name is returned, or NULL_PTR if the MGF is not supported.
+*/
+static const char* mgf_hash_name(const CK_RSA_PKCS_MGF_TYPE mgf)
+{
+	switch (mgf) {
+	case CKG_MGF1_SHA1:		return "SHA1";
+	case CKG_MGF1_SHA224:	return "SHA224";
+	case CKG_MGF1_SHA256:	return "SHA256";
+	case CKG_MGF1_SHA384:	return "SHA384";
+	case CKG_MGF1_SHA512:	return "SHA512";
+	default:				return NULL_PTR;
+	}
+}
+
+
+
+/**
+ * The function builds the host (OpenSSL) key of an RSA public key of the token
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * hPub is an alias of constant public key handle
+ * hostKey is an alias of the pointer to the host key to be returned, freed by EVP_PKEY_free()
+ *
+ * On success, integer 0 is returned. If the public key cannot be read from the token e.g., the session
+ * is lost, integer 2 is returned. Otherwise, i.e., the key cannot be used on the host e.g., the
+ * attributes cannot be extracted, integer 3 is returned.
+*/
+int load_host_RSA_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, EVP_PKEY*& hostKey)
+{
+	attribute_arena arena(1024);
+	object_attributes pubAttrb;
+	BIGNUM* modulus = NULL_PTR;
+	BIGNUM* exponent = NULL_PTR;
+	OSSL_PARAM_BLD* builder = NULL_PTR;
+	OSSL_PARAM* params = NULL_PTR;
+	EVP_PKEY_CTX* ctx = NULL_PTR;
+
+	hostKey = NULL_PTR;
+	if (read_object_attributes(funclistPtr, hSession, hPub, {CKA_MODULUS, CKA_PUBLIC_EXPONENT}, arena, pubAttrb)) {
+		return 2;
+	}
+	const CK_ATTRIBUTE* n = pubAttrb.find(CKA_MODULUS);
+	const CK_ATTRIBUTE* e = pubAttrb.find(CKA_PUBLIC_EXPONENT);
+	if (n->ulValueLen == CK_UNAVAILABLE_INFORMATION || e->ulValueLen == CK_UNAVAILABLE_INFORMATION) {
+		cout << "Error, handle " << hPub << " is not an RSA public key" << endl;
+		return 3;
+	}
+
+	// The modulus and the public exponent are big-endian unsigned integers
+	modulus = BN_bin2bn(static_cast<const unsigned char*>(n->pValue), n->ulValueLen, NULL_PTR);
+	exponent = BN_bin2bn(static_cast<const unsigned char*>(e->pValue), e->ulValueLen, NULL_PTR);
+	builder = OSSL_PARAM_BLD_new();
+	if (modulus && exponent && builder
+		&& OSSL_PARAM_BLD_push_BN(builder, OSSL_PKEY_PARAM_RSA_N, modulus)
+		&& OSSL_PARAM_BLD_push_BN(builder, OSSL_PKEY_PARAM_RSA_E, exponent)) {
+		params = OSSL_PARAM_BLD_to_param(builder);
+	}
+	ctx = EVP_PKEY_CTX_new_from_name(NULL_PTR, "RSA", NULL_PTR);
+	if (!params || !ctx || EVP_PKEY_fromdata_init(ctx) != 1
+		|| EVP_PKEY_fromdata(ctx, &hostKey, EVP_PKEY_PUBLIC_KEY, params) != 1) {
+		cout << "Error, RSA public key of handle " << hPub << " is not valid on the host" << endl;
+		hostKey = NULL_PTR;
+	}
+
+	EVP_PKEY_CTX_free(ctx);
+	OSSL_PARAM_free(params);
+	OSSL_PARAM_BLD_free(builder);
+	BN_free(exponent);
+	BN_free(modulus);
+	return hostKey ? 0 : 3;
+}
+
+
+
+/**
+ * The function encrypts given plaintext using RSA-OAEP on the host
+ *
+ * hostKey is a pointer to the host key built by load_host_RSA_key()
+ * paramOAEP is an alias of constant OAEP parameters, as used by CKM_RSA_PKCS_OAEP
+ * plaintext is an alias of plaintext (source) to be encrypted
+ * ciphertext is an alias ciphertext (destination) to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int encrypt_host_RSA_OAEP(EVP_PKEY* hostKey, const CK_RSA_PKCS_OAEP_PARAMS& paramOAEP,
+							const std::string& plaintext, std::string& ciphertext)
+{
+	int retVal = 3;
+	size_t ctLen = 0;
+	unsigned char* label = NULL_PTR;
+	const char* hashName = hash_name(paramOAEP.hashAlg);
+	const char* mgfName = mgf_hash_name(paramOAEP.mgf);
+	EVP_PKEY_CTX* ctx = NULL_PTR;
+
+	if (!hashName || !mgfName || paramOAEP.source != CKZ_DATA_SPECIFIED) {
+		cout << "Error, OAEP parameters are not supported on the host\n";
+		return 3;
+	}
+
+	ctx = EVP_PKEY_CTX_new(hostKey, NULL_PTR);
+	if (ctx && EVP_PKEY_encrypt_init(ctx) == 1
+		&& EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING) == 1
+		&& EVP_PKEY_CTX_set_rsa_oaep_md_name(ctx, hashName, NULL_PTR) == 1
+		&& EVP_PKEY_CTX_set_rsa_mgf1_md_name(ctx, mgfName, NULL_PTR) == 1) {
+		// The context takes the ownership of the label
+		if (paramOAEP.ulSourceDataLen) {
+			label = static_cast<unsigned char*>(OPENSSL_memdup(paramOAEP.pSourceData, paramOAEP.ulSourceDataLen));
+		}
+		if (!paramOAEP.ulSourceDataLen
+			|| (label && EVP_PKEY_CTX_set0_rsa_oaep_label(ctx, label, paramOAEP.ulSourceDataLen) == 1)) {
+			label = NULL_PTR;
+			if (EVP_PKEY_encrypt(ctx, NULL_PTR, &ctLen,
+								reinterpret_cast<const unsigned char*>(plaintext.data()), plaintext.length()) == 1) {
+				ciphertext.resize(ctLen);
+				if (EVP_PKEY_encrypt(ctx, reinterpret_cast<unsigned char*>(&ciphertext[0]), &ctLen,
+									reinterpret_cast<const unsigned char*>(plaintext.data()), plaintext.length()) == 1) {
+					ciphertext.resize(ctLen);
+					retVal = 0;
+				}
+			}
+		}
+	}
+	OPENSSL_free(label);
+	EVP_PKEY_CTX_free(ctx);
+
+	if (retVal) {
+		cout << "Error, RSA-OAEP encryption on the host failed e.g., the plaintext is too long\n";
+	}
+	return retVal;
+}
+
+
+
+/**
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * paramOAEP is an alias of constant OAEP parameters, the encoding parameter is copied
+*/
+host_rsa_encryptor::host_rsa_encryptor(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_RSA_PKCS_OAEP_PARAMS& paramOAEP)
+	: funclistPtr(funclistPtr), paramOAEP(paramOAEP)
+{
+	if (paramOAEP.pSourceData && paramOAEP.ulSourceDataLen) {
+		label.assign(static_cast<const char*>(paramOAEP.pSourceData), paramOAEP.ulSourceDataLen);
+		this->paramOAEP.pSourceData = const_cast<char*>(label.data());
+	}
+}
+
+
+
+/**
+ * The function gets the cached host key of given public key handle, and builds it on the
+ * first use. The token is not locked while building, so a concurrent first use may build
+ * the key twice, only the first one is cached. An empty key is only cached if the key cannot
+ * be used on the host.
+ *
+ * The host key is returned, or an empty key if the token should be used.
+*/
+host_rsa_encryptor::host_key host_rsa_encryptor::lookup(const CK_SESSION_HANDLE& hSession,
+														const CK_OBJECT_HANDLE& hPub)
+{
+	EVP_PKEY* hostKey = NULL_PTR;
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		std::unordered_map<CK_OBJECT_HANDLE, host_key>::const_iterator found = keys.find(hPub);
+		if (found != keys.end()) {
+			return found->second;
+		}
+	}
+
+	int loaded = load_host_RSA_key(funclistPtr, hSession, hPub, hostKey);
+	if (loaded == 2) {
+		// The failure may be transient e.g., a lost session, so the key is built again on the next use
+		return host_key();
+	}
+	if (loaded) {
+		cout << "Handle " << hPub << " is encrypted to on the token" << endl;
+	}
+	host_key built(hostKey, EVP_PKEY_free);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	return keys.emplace(hPub, built).first->second;
+}
+
+
+
+/**
+ * The function encrypts given plaintext using CKM_RSA_PKCS_OAEP on the token with the
+ * parameters of the encryptor.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int host_rsa_encryptor::encrypt_token(CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+										const std::string& plaintext, std::string& ciphertext)
+{
+	CK_ULONG ctLen = 0;
+	CK_RSA_PKCS_OAEP_PARAMS tokenParams = paramOAEP;
+	CK_MECHANISM encMech = {CKM_RSA_PKCS_OAEP, &tokenParams, sizeof(tokenParams)};
+	CK_BYTE_PTR ptPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(plaintext.data()));
+
+	if (check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hPub), "C_EncryptInit()")) {
+		return 4;
+	}
+	if (check_operation(funclistPtr->C_Encrypt(hSession, ptPtr, plaintext.length(), NULL_PTR, &ctLen), "C_Encrypt()")) {
+		return 4;
+	}
+	ciphertext.resize(ctLen);
+	if (check_operation(funclistPtr->C_Encrypt(hSession, ptPtr, plaintext.length(),
+												reinterpret_cast<CK_BYTE_PTR>(&ciphertext[0]), &ctLen), "C_Encrypt()")) {
+		return 4;
+	}
+	ciphertext.resize(ctLen);
+	return 0;
+}
+
+
+
+/**
+ * The function encrypts given plaintext using RSA-OAEP on the host, or on the token if
+ * the host key of given public key cannot be built.
+ *
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of public key handle
+ * plaintext is an alias of plaintext (source) to be encrypted
+ * ciphertext is an alias ciphertext (destination) to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int host_rsa_encryptor::encrypt(CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+								const std::string& plaintext, std::string& ciphertext)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 5;
+	}
+
+	host_key hostKey = lookup(hSession, hPub);
+	if (hostKey) {
+		return encrypt_host_RSA_OAEP(hostKey.get(), paramOAEP, plaintext, ciphertext);
+	}
+	return encrypt_token(hSession, hPub, plaintext, ciphertext);
+}
+
+
+
+/**
+ * The function removes the cached host key of given public key handle e.g., the key was destroyed
+ *
+ * The function does not return anything.
+*/
+void host_rsa_encryptor::invalidate(const CK_OBJECT_HANDLE& hPub)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	keys.erase(hPub);
+}
+
+
+
+/**
+ * The function removes all cached host keys e.g., before C_Finalize()
+ *
+ * The function does not return anything.
+*/
+void host_rsa_encryptor::clear()
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	keys.clear();
+}
@@ -0,0 +1,259 @@
+#include <iostream>
+#include <vector>
+#include <openssl/asn1.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/x509.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\object_attributes.hpp"
+	#include "..\header\sign_verify_ECDSA.hpp"
+	#include "..\header\host_verify_ECDSA.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/object_attributes.hpp"
+	#include "../header/sign_verify_ECDSA.hpp"
+	#include "../header/host_verify_ECDSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function builds the host (OpenSSL) key of an EC public key of the token
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * hPub is an alias of constant public key handle
+ * hostKey is an alias of the pointer to the host key to be returned, freed by EVP_PKEY_free()
+ *
+ * On success, integer 0 is returned. If the public key cannot be read from the token e.g., the session
+ * is lost, integer 2 is returned. Otherwise, i.e., the key cannot be used on the host e.g., the curve
+ * is not supported or the attributes cannot be extracted, integer 3 is returned.
+*/
+int load_host_EC_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, EVP_PKEY*& hostKey)
+{
+	attribute_arena arena(512);
+	object_attributes pubAttrb;
+	const unsigned char* derPtr = NULL_PTR;
+	const unsigned char* pointPtr = NULL_PTR;
+	size_t pointLen = 0;
+	ASN1_OCTET_STRING* pointOctets = NULL_PTR;
+
+	hostKey = NULL_PTR;
+	if (read_object_attributes(funclistPtr, hSession, hPub, {CKA_EC_PARAMS, CKA_EC_POINT}, arena, pubAttrb)) {
+		return 2;
+	}
+	const CK_ATTRIBUTE* params = pubAttrb.find(CKA_EC_PARAMS);
+	const CK_ATTRIBUTE* point = pubAttrb.find(CKA_EC_POINT);
+	if (params->ulValueLen == CK_UNAVAILABLE_INFORMATION || point->ulValueLen == CK_UNAVAILABLE_INFORMATION) {
+		cout << "Error, handle " << hPub << " is not an EC public key" << endl;
+		return 3;
+	}
+
+	/**
+	 * CKA_EC_PARAMS is the DER-encoding of ECParameters i.e., the OID of a named curve
+	 * (or explicit parameters), which gives the key with the parameters only.
+	*/
+	derPtr = static_cast<const unsigned char*>(params->pValue);
+	hostKey = d2i_KeyParams(EVP_PKEY_EC, NULL_PTR, &derPtr, params->ulValueLen);
+	if (!hostKey) {
+		cout << "Error, EC parameters of handle " << hPub << " are not supported on the host" << endl;
+		return 3;
+	}
+
+	/**
+	 * CKA_EC_POINT is the DER-encoding of the octet string holding the point, though some
+	 * tokens return the point itself.
+	*/
+	derPtr = static_cast<const unsigned char*>(point->pValue);
+	pointOctets = d2i_ASN1_OCTET_STRING(NULL_PTR, &derPtr, point->ulValueLen);
+	if (pointOctets && derPtr == static_cast<const unsigned char*>(point->pValue) + point->ulValueLen) {
+		pointPtr = ASN1_STRING_get0_data(pointOctets);
+		pointLen = ASN1_STRING_length(pointOctets);
+	}
+	else {
+		pointPtr = static_cast<const unsigned char*>(point->pValue);
+		pointLen = point->ulValueLen;
+	}
+
+	int loaded = EVP_PKEY_set1_encoded_public_key(hostKey, pointPtr, pointLen);
+	ASN1_OCTET_STRING_free(pointOctets);
+	if (loaded != 1) {
+		cout << "Error, EC point of handle " << hPub << " is not valid on the host" << endl;
+		EVP_PKEY_free(hostKey);
+		hostKey = NULL_PTR;
+		return 3;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function verifies given CKM_ECDSA signature on the host i.e., the data is not hashed
+ * and the signature is r || s, each of the byte-length of the order of the curve.
+ *
+ * hostKey is a pointer to the host key built by load_host_EC_key()
+ * dataPtr is a pointer to byte array of data that was signed
+ * dataLen is a constant unsigned long representing byte-length of data
+ * sigPtr is a pointer to byte array of given signature
+ * sigLen is a constant unsigned long representing the byte-length of the signature
+ *
+ * If the signature is valid, integer 0 is returned. If it is not valid, integer 1 is returned.
+ * Otherwise, i.e., on failure of the host, integer 2 is returned.
+*/
+int verify_host_ECDSA(EVP_PKEY* hostKey, CK_BYTE_PTR dataPtr, const CK_ULONG dataLen,
+						CK_BYTE_PTR sigPtr, const CK_ULONG sigLen)
+{
+	int retVal = 2;
+	unsigned char* derPtr = NULL_PTR;
+	std::vector<unsigned char> derSig;
+	ECDSA_SIG* sig = NULL_PTR;
+	EVP_PKEY_CTX* ctx = NULL_PTR;
+
+	if (!sigLen || sigLen % 2) {
+		cout << "Error, signature is not valid\n";
+		return 1;
+	}
+
+	// OpenSSL verifies DER-encoded signatures i.e., SEQUENCE { r INTEGER, s INTEGER }
+	sig = ECDSA_SIG_new();
+	BIGNUM* r = BN_bin2bn(sigPtr, sigLen / 2, NULL_PTR);
+	BIGNUM* s = BN_bin2bn(sigPtr + sigLen / 2, sigLen / 2, NULL_PTR);
+	if (!sig || !r || !s || ECDSA_SIG_set0(sig, r, s) != 1) {
+		BN_free(r);
+		BN_free(s);
+		ECDSA_SIG_free(sig);
+		return 2;
+	}
+	derSig.resize(i2d_ECDSA_SIG(sig, NULL_PTR));
+	derPtr = derSig.data();
+	i2d_ECDSA_SIG(sig, &derPtr);
+	ECDSA_SIG_free(sig);
+
+	ctx = EVP_PKEY_CTX_new(hostKey, NULL_PTR);
+	if (ctx && EVP_PKEY_verify_init(ctx) == 1) {
+		int verified = EVP_PKEY_verify(ctx, derSig.data(), derSig.size(), dataPtr, dataLen);
+		if (verified == 1) {
+			retVal = 0;
+		}
+		else if (!verified) {
+			cout << "Error, signature is not valid\n";
+			retVal = 1;
+		}
+	}
+	EVP_PKEY_CTX_free(ctx);
+	return retVal;
+}
+
+
+
+/**
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+*/
+host_ecdsa_verifier::host_ecdsa_verifier(const CK_FUNCTION_LIST_PTR funclistPtr) : funclistPtr(funclistPtr)
+{
+}
+
+
+
+/**
+ * The function gets the cached host key of given public key handle, and builds it on the
+ * first use. The token is not locked while building, so a concurrent first use may build
+ * the key twice, only the first one is cached. An empty key is only cached if the key cannot
+ * be used on the host.
+ *
+ * The host key is returned, or an empty key if the token should be used.
+*/
+host_ecdsa_verifier::host_key host_ecdsa_verifier::lookup(const CK_SESSION_HANDLE& hSession,
+															const CK_OBJECT_HANDLE& hPub)
+{
+	EVP_PKEY* hostKey = NULL_PTR;
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		std::unordered_map<CK_OBJECT_HANDLE, host_key>::const_iterator found = keys.find(hPub);
+		if (found != keys.end()) {
+			return found->second;
+		}
+	}
+
+	int loaded = load_host_EC_key(funclistPtr, hSession, hPub, hostKey);
+	if (loaded == 2) {
+		// The failure may be transient e.g., a lost session, so the key is built again on the next use
+		return host_key();
+	}
+	if (loaded) {
+		cout << "Handle " << hPub << " is verified on the token" << endl;
+	}
+	host_key built(hostKey, EVP_PKEY_free);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	return keys.emplace(hPub, built).first->second;
+}
+
+
+
+/**
+ * The function verifies the signed data using CKM_ECDSA on the host, or on the token if
+ * the host key of given public key cannot be built.
+ *
+ * hSession is an alias of constant session ID/handle
+ * hPub is an alias of constant public key handle
+ * dataPtr is a pointer to byte array of data that was signed
+ * dataLen is a constant unsigned long representing byte-length of data
+ * sigPtr is a pointer to byte array of given signature
+ * sigLen is a constant unsigned long representing the byte-length of the signature
+ *
+ * On success i.e., the signature is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int host_ecdsa_verifier::verify(const CK_SESSION_HANDLE& hSession, const CK_OBJECT_HANDLE& hPub,
+								CK_BYTE_PTR dataPtr, const CK_ULONG dataLen, CK_BYTE_PTR sigPtr, const CK_ULONG sigLen)
+{
+	int retVal = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+
+	host_key hostKey = lookup(hSession, hPub);
+	if (hostKey) {
+		retVal = verify_host_ECDSA(hostKey.get(), dataPtr, dataLen, sigPtr, sigLen);
+		if (retVal != 2) {
+			return retVal;
+		}
+	}
+	return verify_data_no_hashing(funclistPtr, hSession, hPub, dataPtr, dataLen, sigPtr, sigLen);
+}
+
+
+
+/**
+ * The function removes the cached host key of given public key handle e.g., the key was destroyed
+ *
+ * The function does not return anything.
+*/
+void host_ecdsa_verifier::invalidate(const CK_OBJECT_HANDLE& hPub)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	keys.erase(hPub);
+}
+
+
+
+/**
+ * The function removes all cached host keys e.g., before C_Finalize()
+ *
+ * The function does not return anything.
+*/
+void host_ecdsa_verifier::clear()
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	keys.clear();
+}
@@ -0,0 +1,929 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\io_backend.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/io_backend.hpp"
+#endif
+
+#if defined(__linux__) && !defined(NO_IO_URING) && defined(__has_include)
+	#if __has_include(<linux/io_uring.h>)
+		#define IO_URING_AVAILABLE
+		#include <linux/io_uring.h>
+		#include <sys/mman.h>
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * AES uses 128-bit (16-byte) block, which is also the byte-length of the IV
+*/
+const size_t AES_BLOCK_LEN = 16;
+
+
+
+/**
+ * The backend executing every queued operation by pread() or pwrite() at submission, in order.
+ * A failed or short linked operation cancels the next one with -ECANCELED, as io_uring does.
+*/
+class pread_backend : public io_backend
+{
+public:
+	io_backend_type type() const { return IO_BACKEND_PREAD; }
+
+	const char* name() const { return "pread"; }
+
+	int register_buffers(const std::vector<struct iovec>& buffers)
+	{
+		bufs = buffers;
+		return 0;
+	}
+
+	int queue_read(const int fd, const size_t bufIndex, const size_t bufOffset, const size_t len,
+					const unsigned long long offset, const unsigned long long tag)
+	{
+		return queue(fd, bufIndex, bufOffset, len, offset, tag, false, false);
+	}
+
+	int queue_write(const int fd, const size_t bufIndex, const size_t len, const unsigned long long offset,
+					const unsigned long long tag, const bool linkNext)
+	{
+		return queue(fd, bufIndex, 0, len, offset, tag, true, linkNext);
+	}
+
+	int submit()
+	{
+		bool cancelNext = false;
+
+		for (size_t i = 0; i < queued.size(); ++i) {
+			const queued_operation& op = queued[i];
+			io_completion completion = {op.tag, -ECANCELED};
+			if (!cancelNext) {
+				completion.result = transfer(op);
+			}
+			cancelNext = op.linkNext && completion.result != static_cast<long long>(op.len);
+			done.push_back(completion);
+		}
+		queued.clear();
+		return 0;
+	}
+
+	size_t unsubmitted() const { return queued.size(); }
+
+	int wait(io_completion& completion)
+	{
+		if (done.empty()) {
+			cout << "Error, no I/O operation was submitted\n";
+			return 1;
+		}
+		completion = done.front();
+		done.pop_front();
+		return 0;
+	}
+
+private:
+	struct queued_operation
+	{
+		int fd;
+		size_t bufIndex;
+		size_t bufOffset;
+		size_t len;
+		unsigned long long offset;
+		unsigned long long tag;
+		bool write;
+		bool linkNext;
+	};
+
+	int queue(const int fd, const size_t bufIndex, const size_t bufOffset, const size_t len,
+				const unsigned long long offset, const unsigned long long tag, const bool write, const bool linkNext)
+	{
+		if (bufIndex >= bufs.size() || bufOffset > bufs[bufIndex].iov_len || len > bufs[bufIndex].iov_len - bufOffset) {
+			cout << "Error, I/O buffer " << bufIndex << " is not registered or too small\n";
+			return 1;
+		}
+		queued_operation op = {fd, bufIndex, bufOffset, len, offset, tag, write, linkNext};
+		queued.push_back(op);
+		return 0;
+	}
+
+	/**
+	 * The function transfers the whole byte-length of given operation, stopping short at the end of the file
+	 * only. The byte-length transferred is returned, or -errno on failure.
+	*/
+	long long transfer(const queued_operation& op)
+	{
+		CK_BYTE_PTR bufPtr = static_cast<CK_BYTE_PTR>(bufs[op.bufIndex].iov_base) + op.bufOffset;
+		size_t done = 0;
+
+		while (done < op.len) {
+			ssize_t ret = op.write ? pwrite(op.fd, bufPtr + done, op.len - done, op.offset + done)
+									: pread(op.fd, bufPtr + done, op.len - done, op.offset + done);
+			if (ret < 0 && errno == EINTR) {
+				continue;
+			}
+			if (ret < 0) {
+				return -errno;
+			}
+			if (!ret) {
+				break;
+			}
+			done += ret;
+		}
+		return done;
+	}
+
+	std::vector<struct iovec> bufs;
+	std::vector<queued_operation> queued;
+	std::deque<io_completion> done;
+};
+
+
+
+#ifdef IO_URING_AVAILABLE
+
+/**
+ * The backend submitting the queued operations to an io_uring instance, set up by the system calls
+ * i.e., io_uring_setup(), io_uring_enter() and io_uring_register(), and the rings mapped in memory.
+ * The application owns the tail of the submission ring and the head of the completion ring, the kernel
+ * the others, so they are read with acquire and written with release ordering.
+*/
+class uring_backend : public io_backend
+{
+public:
+	uring_backend() : ringFd(-1), sqRingPtr(MAP_FAILED), cqRingPtr(MAP_FAILED), sqesPtr(MAP_FAILED),
+						sqRingSz(0), cqRingSz(0), sqesSz(0), toSubmit(0), registered(false) {}
+
+	~uring_backend()
+	{
+		if (sqesPtr != MAP_FAILED) {
+			munmap(sqesPtr, sqesSz);
+		}
+		if (cqRingPtr != MAP_FAILED && cqRingPtr != sqRingPtr) {
+			munmap(cqRingPtr, cqRingSz);
+		}
+		if (sqRingPtr != MAP_FAILED) {
+			munmap(sqRingPtr, sqRingSz);
+		}
+		if (ringFd >= 0) {
+			::close(ringFd);
+		}
+	}
+
+	/**
+	 * The function sets up the io_uring instance with given number of submission entries
+	 *
+	 * On success, integer 0 is returned. Otherwise, non-zero integer is returned e.g., io_uring is not
+	 * supported or not allowed.
+	*/
+	int setup(const unsigned entries)
+	{
+		struct io_uring_params params;
+
+		std::memset(&params, 0, sizeof(params));
+		ringFd = syscall(__NR_io_uring_setup, entries, &params);
+		if (ringFd < 0) {
+			return 1;
+		}
+
+		sqRingSz = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSz = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		sqesSz = params.sq_entries * sizeof(struct io_uring_sqe);
+		// Both rings are in one mapping since Linux 5.4
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			sqRingSz = cqRingSz = std::max(sqRingSz, cqRingSz);
+		}
+
+		sqRingPtr = mmap(NULL_PTR, sqRingSz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+							IORING_OFF_SQ_RING);
+		if (sqRingPtr == MAP_FAILED) {
+			return 1;
+		}
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			cqRingPtr = sqRingPtr;
+		}
+		else {
+			cqRingPtr = mmap(NULL_PTR, cqRingSz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+								IORING_OFF_CQ_RING);
+			if (cqRingPtr == MAP_FAILED) {
+				return 1;
+			}
+		}
+		sqesPtr = mmap(NULL_PTR, sqesSz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (sqesPtr == MAP_FAILED) {
+			return 1;
+		}
+
+		char* sqBase = static_cast<char*>(sqRingPtr);
+		char* cqBase = static_cast<char*>(cqRingPtr);
+		sqHead = reinterpret_cast<unsigned*>(sqBase + params.sq_off.head);
+		sqTail = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+		sqEntries = *reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_entries);
+		sqArray = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+		cqHead = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<struct io_uring_cqe*>(cqBase + params.cq_off.cqes);
+		sqes = static_cast<struct io_uring_sqe*>(sqesPtr);
+		return 0;
+	}
+
+	io_backend_type type() const { return IO_BACKEND_URING; }
+
+	const char* name() const { return registered ? "io_uring" : "io_uring (unregistered)"; }
+
+	/**
+	 * The buffers are pinned by the kernel, which counts them against RLIMIT_MEMLOCK. If they cannot be
+	 * registered, the operations address them directly i.e., IORING_OP_READ and IORING_OP_WRITE.
+	*/
+	int register_buffers(const std::vector<struct iovec>& buffers)
+	{
+		bufs = buffers;
+		registered = !syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, bufs.data(), bufs.size());
+		return 0;
+	}
+
+	/**
+	 * A fixed read may start anywhere in its registered buffer, as long as it ends in that buffer
+	*/
+	int queue_read(const int fd, const size_t bufIndex, const size_t bufOffset, const size_t len,
+					const unsigned long long offset, const unsigned long long tag)
+	{
+		return queue(registered ? IORING_OP_READ_FIXED : IORING_OP_READ, fd, bufIndex, bufOffset, len, offset, tag,
+						false);
+	}
+
+	int queue_write(const int fd, const size_t bufIndex, const size_t len, const unsigned long long offset,
+					const unsigned long long tag, const bool linkNext)
+	{
+		return queue(registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, fd, bufIndex, 0, len, offset, tag,
+						linkNext);
+	}
+
+	int submit()
+	{
+		while (toSubmit) {
+			int ret = syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, NULL_PTR, 0);
+			if (ret < 0 && errno == EINTR) {
+				continue;
+			}
+			if (ret < 0) {
+				cout << "Error, io_uring_enter() failed: " << std::strerror(errno) << endl;
+				return 1;
+			}
+			toSubmit -= ret;
+		}
+		return 0;
+	}
+
+	/**
+	 * The entries not consumed by the kernel after a failed submission, which are dropped with the ring
+	*/
+	size_t unsubmitted() const { return toSubmit; }
+
+	int wait(io_completion& completion)
+	{
+		unsigned head = *cqHead;
+
+		while (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+			int ret = syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL_PTR, 0);
+			if (ret < 0 && errno != EINTR) {
+				cout << "Error, io_uring_enter() failed: " << std::strerror(errno) << endl;
+				return 1;
+			}
+		}
+		const struct io_uring_cqe& cqe = cqes[head & cqMask];
+		completion.tag = cqe.user_data;
+		completion.result = cqe.res;
+		__atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+		return 0;
+	}
+
+private:
+	uring_backend(const uring_backend&);
+	uring_backend& operator=(const uring_backend&);
+
+	int queue(const unsigned char opcode, const int fd, const size_t bufIndex, const size_t bufOffset,
+				const size_t len, const unsigned long long offset, const unsigned long long tag, const bool linkNext)
+	{
+		unsigned tail = *sqTail;
+
+		if (bufIndex >= bufs.size() || bufOffset > bufs[bufIndex].iov_len || len > bufs[bufIndex].iov_len - bufOffset) {
+			cout << "Error, I/O buffer " << bufIndex << " is not registered or too small\n";
+			return 1;
+		}
+		// A link has to end in the same submission, so a linked operation needs room for the next one
+		if (tail + (linkNext ? 2 : 1) - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) > sqEntries) {
+			cout << "Error, io_uring submission ring is full\n";
+			return 1;
+		}
+
+		unsigned index = tail & sqMask;
+		struct io_uring_sqe* sqe = &sqes[index];
+		std::memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = opcode;
+		sqe->flags = linkNext ? IOSQE_IO_LINK : 0;
+		sqe->fd = fd;
+		sqe->off = offset;
+		sqe->addr = reinterpret_cast<unsigned long long>(static_cast<char*>(bufs[bufIndex].iov_base) + bufOffset);
+		sqe->len = len;
+		sqe->user_data = tag;
+		if (registered) {
+			sqe->buf_index = bufIndex;
+		}
+		sqArray[index] = index;
+		__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+		++toSubmit;
+		return 0;
+	}
+
+	int ringFd;
+	void* sqRingPtr;
+	void* cqRingPtr;
+	void* sqesPtr;
+	size_t sqRingSz;
+	size_t cqRingSz;
+	size_t sqesSz;
+	unsigned* sqHead;
+	unsigned* sqTail;
+	unsigned sqMask;
+	unsigned sqEntries;
+	unsigned* sqArray;
+	unsigned* cqHead;
+	unsigned* cqTail;
+	unsigned cqMask;
+	struct io_uring_cqe* cqes;
+	struct io_uring_sqe* sqes;
+	unsigned toSubmit;
+	bool registered;
+	std::vector<struct iovec> bufs;
+};
+
+#endif
+
+
+
+/**
+ * The function makes a backend of given type
+ *
+ * type is the backend requested, where IO_BACKEND_URING falls back to IO_BACKEND_PREAD if io_uring is not
+ * built in or cannot be set up
+ * queueDepth is the number of operations which can be queued and in flight at the same time
+ *
+ * The backend is returned, whose type() tells the one actually made.
+*/
+std::unique_ptr<io_backend> make_io_backend(const io_backend_type type, const unsigned queueDepth)
+{
+#ifdef IO_URING_AVAILABLE
+	if (type == IO_BACKEND_URING) {
+		std::unique_ptr<uring_backend> uring(new uring_backend());
+		if (!uring->setup(queueDepth)) {
+			return std::unique_ptr<io_backend>(uring.release());
+		}
+	}
+#else
+	(void)type;
+	(void)queueDepth;
+#endif
+	return std::unique_ptr<io_backend>(new pread_backend());
+}
+
+
+
+/**
+ * The transformation of a chunk on the token, from in (inLen bytes) to out, whose byte-length is outLen
+ * on input and the byte-length of the output on return.
+ * It returns integer 0 on success. Otherwise, non-zero integer is returned.
+*/
+typedef std::function<int(CK_BYTE_PTR, CK_ULONG, CK_BYTE_PTR, CK_ULONG&)> io_transform;
+
+
+/**
+ * The page-aligned chunk buffers of a streaming operation, freed on destruction unless released
+*/
+struct io_buffers
+{
+	~io_buffers()
+	{
+		for (size_t i = 0; i < iov.size(); ++i) {
+			std::free(iov[i].iov_base);
+		}
+	}
+
+	int add(const size_t len)
+	{
+		void* bufPtr = NULL_PTR;
+		if (posix_memalign(&bufPtr, 4096, len)) {
+			cout << "Error, cannot allocate " << len << " bytes of I/O buffer\n";
+			return 1;
+		}
+		struct iovec buf = {bufPtr, len};
+		iov.push_back(buf);
+		return 0;
+	}
+
+	CK_BYTE_PTR at(const size_t index) const { return static_cast<CK_BYTE_PTR>(iov[index].iov_base); }
+
+	/**
+	 * The buffers are left allocated i.e., leaked, when operations which may still transfer into them
+	 * cannot be waited for
+	*/
+	void release() { iov.clear(); }
+
+	std::vector<struct iovec> iov;
+};
+
+
+
+/**
+ * The function streams given input file through the transformation into given output file on a backend,
+ * until the end of the input file
+ *
+ * type is the backend requested
+ * inFd is the file descriptor of the input, read from inBase
+ * outFd is the file descriptor of the output, written from outOffset, which is advanced
+ * chunkSz is the byte-length of the chunks read
+ * depth is the number of chunks in flight
+ * transform is an alias of constant transformation of the chunks, in order
+ * stats is an alias of the statistics, whose backend, byte-lengths and counts are updated
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int stream_file(const io_backend_type type, const int inFd, const unsigned long long inBase, const int outFd,
+						unsigned long long& outOffset, const size_t chunkSz, const unsigned depth,
+						const io_transform& transform, io_stream_stats& stats)
+{
+	int retVal = 0;
+	io_buffers buffers;
+	// The input buffers are 0..depth-1 and the output ones depth..2*depth-1, where the output has room for
+	// the block CBC held back from the previous chunk
+	for (unsigned i = 0; i < 2 * depth && !retVal; ++i) {
+		retVal = buffers.add(i < depth ? chunkSz : chunkSz + AES_BLOCK_LEN);
+	}
+	if (retVal) {
+		return 1;
+	}
+	// Declared after the buffers, so the operations in flight are gone before the buffers
+	std::unique_ptr<io_backend> backend = make_io_backend(type, 2 * depth);
+	if (backend->register_buffers(buffers.iov)) {
+		return 1;
+	}
+	stats.backend = backend->name();
+
+	// The tag of an operation is the chunk number followed by one bit telling a write. A chunk is read
+	// into readLen bytes of its buffer so far, and readPart is the result of its last read completed.
+	std::vector<bool> readDone(depth, false);
+	std::vector<long long> readPart(depth, 0);
+	std::vector<size_t> readLen(depth, 0);
+	std::vector<size_t> writeLen(depth, 0);
+	size_t inFlight = 0;
+	size_t queued = 0;
+
+	// The function waits for a completion and records it
+	auto reap = [&]() {
+		io_completion completion;
+		if (backend->wait(completion)) {
+			return 2;
+		}
+		--inFlight;
+		size_t slot = (completion.tag >> 1) % depth;
+		if (completion.tag & 1) {
+			if (completion.result != static_cast<long long>(writeLen[slot])) {
+				cout << "Error, cannot write the file: "
+						<< (completion.result < 0 ? std::strerror(-completion.result) : "short write") << endl;
+				return 1;
+			}
+		}
+		else {
+			readDone[slot] = true;
+			readPart[slot] = completion.result;
+		}
+		return 0;
+	};
+
+	for (unsigned long long seq = 0; seq < depth && !retVal; ++seq) {
+		retVal = backend->queue_read(inFd, seq, 0, chunkSz, inBase + seq * chunkSz, seq << 1);
+		inFlight += !retVal;
+		queued += !retVal;
+	}
+
+	for (unsigned long long seq = 0; !retVal; ++seq) {
+		size_t slot = seq % depth;
+		bool complete = false;
+		while (!retVal && !complete) {
+			while (!retVal && !readDone[slot]) {
+				// Submitting what was queued meanwhile in one batch, then waiting
+				if (queued) {
+					retVal = backend->submit();
+					stats.submitCount += !retVal;
+					queued = 0;
+				}
+				if (!retVal) {
+					retVal = reap();
+				}
+			}
+			if (retVal) {
+				break;
+			}
+			readDone[slot] = false;
+			if (readPart[slot] < 0) {
+				// -ECANCELED tells the linked write before failed, which reported it already
+				if (readPart[slot] != -ECANCELED) {
+					cout << "Error, cannot read the file: " << std::strerror(-readPart[slot]) << endl;
+				}
+				retVal = 1;
+				break;
+			}
+			readLen[slot] += readPart[slot];
+			// A read can complete short before the end of the file (io_uring), so the rest of the chunk is
+			// read into the same buffer, until the chunk is full or a read tells the end of the file
+			complete = !readPart[slot] || readLen[slot] == chunkSz;
+			if (!complete) {
+				retVal = backend->queue_read(inFd, slot, readLen[slot], chunkSz - readLen[slot],
+												inBase + seq * chunkSz + readLen[slot], seq << 1);
+				inFlight += !retVal;
+				queued += !retVal;
+			}
+		}
+		if (retVal || !readLen[slot]) {
+			break;
+		}
+
+		CK_ULONG outLen = chunkSz + AES_BLOCK_LEN;
+		retVal = transform(buffers.at(slot), readLen[slot], buffers.at(depth + slot), outLen);
+		if (retVal) {
+			break;
+		}
+		writeLen[slot] = outLen;
+		stats.bytesIn += readLen[slot];
+		stats.bytesOut += outLen;
+		++stats.chunkCount;
+
+		// A short chunk ends at the end of the file, so it is the last one. Otherwise, the write frees the
+		// output buffer for the chunk depth ahead.
+		bool last = readLen[slot] < chunkSz;
+		readLen[slot] = 0;
+		retVal = backend->queue_write(outFd, depth + slot, outLen, outOffset, (seq << 1) | 1, !last);
+		if (retVal) {
+			break;
+		}
+		++inFlight;
+		++queued;
+		outOffset += outLen;
+		if (last) {
+			break;
+		}
+		retVal = backend->queue_read(inFd, slot, 0, chunkSz, inBase + (seq + depth) * chunkSz, (seq + depth) << 1);
+		inFlight += !retVal;
+		queued += !retVal;
+	}
+
+	// Draining the operations in flight, also after a failure, since they refer to the buffers. The ones
+	// left unsubmitted by a failed submission never complete.
+	if (queued) {
+		if (backend->submit()) {
+			retVal = 1;
+		}
+		else {
+			++stats.submitCount;
+		}
+	}
+	inFlight -= backend->unsubmitted();
+	while (inFlight) {
+		int ret = reap();
+		if (ret == 2) {
+			break;
+		}
+		retVal |= ret;
+	}
+	if (inFlight) {
+		cout << "Error, " << inFlight << " I/O operations cannot be waited for, their buffers are left allocated\n";
+		buffers.release();
+		return 1;
+	}
+	return retVal;
+}
+
+
+
+/**
+ * The function finishes a multi-part operation whose output length is not known in advance i.e.,
+ * asks for the length, then finishes the operation
+ *
+ * The CK_RV value of the last call is returned.
+*/
+static CK_RV finish_operation(const std::function<CK_RV(CK_BYTE_PTR, CK_ULONG_PTR)>& finalFn, std::string& output)
+{
+	CK_ULONG outLen = 0;
+	CK_RV rv = finalFn(NULL_PTR, &outLen);
+
+	if (rv != CKR_OK) {
+		return rv;
+	}
+	// At least one byte, so the operation is finished and not asked for the length again
+	output.resize(outLen ? outLen : 1);
+	rv = finalFn(reinterpret_cast<CK_BYTE_PTR>(&output[0]), &outLen);
+	output.resize(rv == CKR_OK ? outLen : 0);
+	return rv;
+}
+
+
+
+/**
+ * The function writes given byte-length at given offset of the file
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int pwrite_full(const int fd, const CK_BYTE* bufPtr, const size_t byteLen, const unsigned long long offset)
+{
+	size_t done = 0;
+
+	while (done < byteLen) {
+		ssize_t ret = pwrite(fd, bufPtr + done, byteLen - done, offset + done);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret < 0) {
+			cout << "Error, cannot write the file: " << std::strerror(errno) << endl;
+			return 1;
+		}
+		done += ret;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function opens the input and output files of a streaming operation
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and no file is left open.
+*/
+static int open_files(const std::string& inPath, const std::string& outPath, int& inFd, int& outFd)
+{
+	inFd = ::open(inPath.c_str(), O_RDONLY);
+	if (inFd < 0) {
+		cout << "Error, cannot open " << inPath << ": " << std::strerror(errno) << endl;
+		return 1;
+	}
+	outFd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (outFd < 0) {
+		cout << "Error, cannot create " << outPath << ": " << std::strerror(errno) << endl;
+		::close(inFd);
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function closes the files of a streaming operation, and removes the output file on failure
+*/
+static void close_files(const int inFd, const int outFd, const std::string& outPath, const int retVal)
+{
+	::close(inFd);
+	::close(outFd);
+	if (retVal) {
+		std::remove(outPath.c_str());
+	}
+}
+
+
+
+/**
+ * The function gets the transformation of the chunks by C_EncryptUpdate() or C_DecryptUpdate()
+*/
+static io_transform AES_transform(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+									const bool encrypt)
+{
+	return [funclistPtr, &hSession, encrypt](CK_BYTE_PTR inPtr, CK_ULONG inLen, CK_BYTE_PTR outPtr, CK_ULONG& outLen) {
+		CK_RV rv = encrypt ? funclistPtr->C_EncryptUpdate(hSession, inPtr, inLen, outPtr, &outLen)
+							: funclistPtr->C_DecryptUpdate(hSession, inPtr, inLen, outPtr, &outLen);
+		return check_operation(rv, encrypt ? "C_EncryptUpdate()" : "C_DecryptUpdate()");
+	};
+}
+
+
+
+/**
+ * The function sets the wall time and the throughput of given statistics
+*/
+static void finish_stats(io_stream_stats& stats, const std::chrono::steady_clock::time_point start)
+{
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	stats.MiBps = stats.seconds > 0 ? stats.bytesIn / (1024.0 * 1024.0) / stats.seconds : 0;
+}
+
+
+
+/**
+ * The function encrypts given file using CKM_AES_CBC_PAD with a random IV on given I/O backend,
+ * where the output file is the IV followed by the ciphertext (as encrypt_file() of file_crypt.hpp)
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be encrypted
+ * outPath is an alias of constant path of the encrypted file, which is created or overwritten
+ * type is the backend requested, see make_io_backend()
+ * stats is an alias of the statistics to be returned
+ * chunkSz is the byte-length of the chunks, a multiple of 16
+ * depth is the number of chunks in flight
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int encrypt_file_io(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					const io_backend_type type, io_stream_stats& stats, const size_t chunkSz, const unsigned depth)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+	unsigned long long outOffset = AES_BLOCK_LEN;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	CK_MECHANISM encMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+	std::string lastPart;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 1;
+	}
+	if (!chunkSz || chunkSz % AES_BLOCK_LEN || !depth) {
+		cout << "Error, chunk size should be a non-zero multiple of " << AES_BLOCK_LEN << " and depth non-zero\n";
+		return 1;
+	}
+	if (open_files(inPath, outPath, inFd, outFd)) {
+		return 1;
+	}
+
+	stats = io_stream_stats();
+	retVal = check_operation(funclistPtr->C_GenerateRandom(hSession, IV, sizeof(IV)), "C_GenerateRandom()");
+	if (!retVal) {
+		retVal = pwrite_full(outFd, IV, sizeof(IV), 0);
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_EncryptInit(hSession, &encMech, hSecretkey), "C_EncryptInit()");
+		if (!retVal) {
+			retVal = stream_file(type, inFd, 0, outFd, outOffset, chunkSz, depth,
+									AES_transform(funclistPtr, hSession, true), stats);
+			// Finishing the operation also after a failed read or write, so the session can start another one
+			CK_RV rv = finish_operation([&](CK_BYTE_PTR partPtr, CK_ULONG_PTR partLenPtr) {
+											return funclistPtr->C_EncryptFinal(hSession, partPtr, partLenPtr);
+										}, lastPart);
+			if (!retVal) {
+				retVal = check_operation(rv, "C_EncryptFinal()");
+			}
+		}
+	}
+	if (!retVal) {
+		retVal = pwrite_full(outFd, reinterpret_cast<const CK_BYTE*>(lastPart.data()), lastPart.length(), outOffset);
+		stats.bytesOut += sizeof(IV) + lastPart.length();
+	}
+
+	close_files(inFd, outFd, outPath, retVal);
+	finish_stats(stats, start);
+	return retVal ? 1 : 0;
+}
+
+
+
+/**
+ * The function decrypts given file produced by encrypt_file_io() (or encrypt_file()) on given I/O backend
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be decrypted
+ * outPath is an alias of constant path of the decrypted file, which is created or overwritten
+ * type is the backend requested, see make_io_backend()
+ * stats is an alias of the statistics to be returned
+ * chunkSz is the byte-length of the chunks, a multiple of 16
+ * depth is the number of chunks in flight
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned and the output file is removed.
+*/
+int decrypt_file_io(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath, const std::string& outPath,
+					const io_backend_type type, io_stream_stats& stats, const size_t chunkSz, const unsigned depth)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int retVal = 0;
+	int inFd = -1;
+	int outFd = -1;
+	unsigned long long outOffset = 0;
+	struct stat fileStat;
+	CK_BYTE IV[AES_BLOCK_LEN];
+	CK_MECHANISM decMech = {CKM_AES_CBC_PAD, IV, sizeof(IV)};
+	std::string lastPart;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	if (!chunkSz || chunkSz % AES_BLOCK_LEN || !depth) {
+		cout << "Error, chunk size should be a non-zero multiple of " << AES_BLOCK_LEN << " and depth non-zero\n";
+		return 2;
+	}
+	if (open_files(inPath, outPath, inFd, outFd)) {
+		return 2;
+	}
+
+	stats = io_stream_stats();
+	// The IV and at least one block, in whole blocks
+	if (fstat(inFd, &fileStat) || fileStat.st_size < static_cast<off_t>(2 * AES_BLOCK_LEN) ||
+		fileStat.st_size % AES_BLOCK_LEN || pread(inFd, IV, sizeof(IV), 0) != sizeof(IV)) {
+		cout << "Error, " << inPath << " is not an encrypted file\n";
+		retVal = 1;
+	}
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_DecryptInit(hSession, &decMech, hSecretkey), "C_DecryptInit()");
+		if (!retVal) {
+			retVal = stream_file(type, inFd, AES_BLOCK_LEN, outFd, outOffset, chunkSz, depth,
+									AES_transform(funclistPtr, hSession, false), stats);
+			CK_RV rv = finish_operation([&](CK_BYTE_PTR partPtr, CK_ULONG_PTR partLenPtr) {
+											return funclistPtr->C_DecryptFinal(hSession, partPtr, partLenPtr);
+										}, lastPart);
+			if (!retVal) {
+				retVal = check_operation(rv, "C_DecryptFinal()");
+			}
+		}
+	}
+	if (!retVal) {
+		retVal = pwrite_full(outFd, reinterpret_cast<const CK_BYTE*>(lastPart.data()), lastPart.length(), outOffset);
+		stats.bytesIn += sizeof(IV);
+		stats.bytesOut += lastPart.length();
+	}
+
+	close_files(inFd, outFd, outPath, retVal);
+	finish_stats(stats, start);
+	return retVal ? 2 : 0;
+}
+
+
+
+/**
+ * The function compares the backends by encrypting given file with encrypt_file_io() on each of them at
+ * every chunk size, and prints the throughput and the number of submissions. The file is encrypted once
+ * before, so every run reads it from the page cache. The encrypted files are removed.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hSecretkey is an alias of constant AES secret key handle
+ * inPath is an alias of constant path of the file to be encrypted
+ * chunkSizes is an alias of constant list of chunk sizes, multiples of 16
+ * depth is the number of chunks in flight
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int benchmark_io_backends(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE& hSecretkey, const std::string& inPath,
+							const std::vector<size_t>& chunkSizes, const unsigned depth)
+{
+	const std::string outPath = inPath + ".iobench";
+	const io_backend_type types[] = {IO_BACKEND_PREAD, IO_BACKEND_URING};
+	io_stream_stats stats;
+
+	if (chunkSizes.empty()) {
+		cout << "Error, no chunk size to benchmark\n";
+		return 3;
+	}
+	if (encrypt_file_io(funclistPtr, hSession, hSecretkey, inPath, outPath, IO_BACKEND_PREAD, stats, chunkSizes[0], depth)) {
+		return 3;
+	}
+	cout << "Encrypting " << stats.bytesIn << " bytes, " << depth << " chunks in flight\n";
+	cout << std::left << std::setw(26) << "backend" << std::right << std::setw(12) << "chunk (KiB)"
+			<< std::setw(12) << "MiB/s" << std::setw(12) << "submits" << endl;
+
+	for (size_t i = 0; i < chunkSizes.size(); ++i) {
+		for (size_t j = 0; j < sizeof(types) / sizeof(types[0]); ++j) {
+			if (encrypt_file_io(funclistPtr, hSession, hSecretkey, inPath, outPath, types[j], stats, chunkSizes[i], depth)) {
+				return 3;
+			}
+			cout << std::left << std::setw(26) << stats.backend << std::right << std::setw(12) << chunkSizes[i] / 1024
+					<< std::setw(12) << std::fixed << std::setprecision(1) << stats.MiBps
+					<< std::setw(12) << stats.submitCount << endl;
+		}
+	}
+	std::remove(outPath.c_str());
+	return 0;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\login_manager.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/login_manager.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The function logs the user into the token of given session
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * usrPIN is an alias of constant user PIN
+ *
+ * On success i.e., also if the user is already logged in, integer 0 is returned.
+ * Otherwise, non-zero integer is returned.
+*/
+static int login_user(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const std::string& usrPIN)
+{
+	CK_RV rv = funclistPtr->C_Login(hSession, CKU_USER,
+									reinterpret_cast<CK_UTF8CHAR_PTR>(const_cast<char*>(usrPIN.c_str())),
+									usrPIN.length());
+
+	// The login state is shared by all sessions of the application with a token
+	if (rv == CKR_USER_ALREADY_LOGGED_IN) {
+		rv = CKR_OK;
+	}
+	return check_operation(rv, "C_Login()");
+}
+
+
+
+login_manager::login_manager()
+{
+}
+
+
+
+/**
+ * The function takes a reference of the login state of given token, and logs in on the
+ * first reference only. The next references do not call the token.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot of the token
+ * hSession is an alias of constant session ID/handle opened on the slot
+ * usrPIN is an alias of constant user PIN
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int login_manager::acquire(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+							const CK_SESSION_HANDLE& hSession, const std::string& usrPIN)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	// Concurrent acquires of the same token wait for the first login
+	std::lock_guard<std::mutex> lock(loginMutex);
+	size_t& count = tokens[token_key(funclistPtr, slotID)];
+	if (!count && login_user(funclistPtr, hSession, usrPIN)) {
+		tokens.erase(token_key(funclistPtr, slotID));
+		return 2;
+	}
+	++count;
+	return 0;
+}
+
+
+
+/**
+ * The function logs in again without taking a reference e.g., on a new session after
+ * the token was reset and the login state was lost.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * usrPIN is an alias of constant user PIN
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int login_manager::ensure(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+							const std::string& usrPIN)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	return login_user(funclistPtr, hSession, usrPIN) ? 3 : 0;
+}
+
+
+
+/**
+ * The function releases a reference of the login state of given token, and logs out
+ * when the last reference is released.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot of the token
+ * hSession is an alias of constant session ID/handle, still opened on the slot
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int login_manager::release(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+							const CK_SESSION_HANDLE& hSession)
+{
+	CK_RV rv = CKR_OK;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+
+	std::lock_guard<std::mutex> lock(loginMutex);
+	std::map<token_key, size_t>::iterator found = tokens.find(token_key(funclistPtr, slotID));
+	if (found == tokens.end()) {
+		cout << "Error, slot ID " << slotID << " is not logged in by the login manager" << endl;
+		return 4;
+	}
+	if (--found->second) {
+		return 0;
+	}
+	tokens.erase(found);
+
+	/**
+	 * Logs out the last reference. The login state may already be lost e.g., the token
+	 * was reset, which is not an error here.
+	*/
+	rv = funclistPtr->C_Logout(hSession);
+	if (rv == CKR_USER_NOT_LOGGED_IN) {
+		rv = CKR_OK;
+	}
+	return check_operation(rv, "C_Logout()") ? 4 : 0;
+}
+
+
+
+/**
+ * The function drops the references of every token of given library without logging out
+ * e.g., right before C_Finalize() which logs out and closes all sessions anyway.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ *
+ * The function does not return anything.
+*/
+void login_manager::forget(const CK_FUNCTION_LIST_PTR funclistPtr)
+{
+	std::lock_guard<std::mutex> lock(loginMutex);
+	std::map<token_key, size_t>::iterator it = tokens.begin();
+	while (it != tokens.end()) {
+		if (it->first.first == funclistPtr) {
+			it = tokens.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+
+
+/**
+ * The function gets the number of references of the login state of given token
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot of the token
+ *
+ * The number of references is returned, 0 means the token is not logged in by the login manager.
+*/
+size_t login_manager::references(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID)
+{
+	std::lock_guard<std::mutex> lock(loginMutex);
+	std::map<token_key, size_t>::const_iterator found = tokens.find(token_key(funclistPtr, slotID));
+	return found == tokens.end() ? 0 : found->second;
+}
+
+
+
+/**
+ * The function gets the login manager shared by the whole application e.g., connect_slot(),
+ * slot_dispatcher and recoverable_session.
+ *
+ * The alias of the application login manager is returned.
+*/
+login_manager& application_login()
+{
+	static login_manager manager;
+	return manager;
+}
@@ -0,0 +1,306 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\mechanism_cache.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/mechanism_cache.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+mechanism_cache::mechanism_cache() : slotID(0)
+{
+}
+
+
+
+/**
+ * The function builds the cache of supported mechanisms of given slot
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mechanism_cache::build(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID)
+{
+	CK_ULONG mechCount = 0;
+	std::vector<CK_MECHANISM_TYPE> mechList;
+	CK_MECHANISM_INFO mechInfo;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	/**
+	 * CK_RV C_GetMechanismList(CK_SLOT_ID slotID, CK_MECHANISM_TYPE_PTR pMechanismList, CK_ULONG_PTR pulCount);
+	 *
+	 * C_GetMechanismList() is used to obtain a list of mechanism types supported by a token.
+	 * Similar to C_GetSlotList(), if pMechanismList is NULL_PTR, then only the number of
+	 * mechanisms is returned in *pulCount.
+	*/
+	if (check_operation(funclistPtr->C_GetMechanismList(slotID, NULL_PTR, &mechCount), "C_GetMechanismList()")) {
+		return 2;
+	}
+	mechList.resize(mechCount);
+	if (mechCount && check_operation(funclistPtr->C_GetMechanismList(slotID, mechList.data(), &mechCount),
+										"C_GetMechanismList()")) {
+		return 2;
+	}
+
+	this->slotID = slotID;
+	mechanisms.clear();
+	for (CK_ULONG i = 0; i < mechCount; ++i) {
+		/**
+		 * CK_RV C_GetMechanismInfo(CK_SLOT_ID slotID, CK_MECHANISM_TYPE type, CK_MECHANISM_INFO_PTR pInfo);
+		 *
+		 * C_GetMechanismInfo() obtains information about a particular mechanism possibly
+		 * supported by a token i.e., ulMinKeySize, ulMaxKeySize and flags.
+		*/
+		if (!check_operation(funclistPtr->C_GetMechanismInfo(slotID, mechList[i], &mechInfo), "C_GetMechanismInfo()")) {
+			mechanisms[mechList[i]] = mechInfo;
+		}
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function builds the cache of supported mechanisms of the slot of a connected session
+ * e.g., the session opened by connect_slot().
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mechanism_cache::build_session(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession)
+{
+	CK_SESSION_INFO sessionInfo;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	if (check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()")) {
+		return 3;
+	}
+	return build(funclistPtr, sessionInfo.slotID);
+}
+
+
+
+/**
+ * The function checks whether given mechanism is supported with the required flags and key size
+ *
+ * mechType is the mechanism type e.g., CKM_AES_CBC_PAD
+ * requiredFlags represents the flags which should all be set e.g., CKF_ENCRYPT | CKF_HW
+ * keySize represents the key size to be used, 0 means any key size
+ *
+ * If the mechanism is supported, true is returned. Otherwise, false is returned.
+*/
+bool mechanism_cache::supports(const CK_MECHANISM_TYPE mechType, const CK_FLAGS requiredFlags,
+								const CK_ULONG keySize) const
+{
+	CK_MECHANISM_INFO mechInfo;
+
+	if (!info(mechType, mechInfo)) {
+		return false;
+	}
+	if ((mechInfo.flags & requiredFlags) != requiredFlags) {
+		return false;
+	}
+	return !keySize || (keySize >= mechInfo.ulMinKeySize && keySize <= mechInfo.ulMaxKeySize);
+}
+
+
+
+/**
+ * The function gets the cached information of given mechanism
+ *
+ * mechType is the mechanism type
+ * mechInfo is an alias of mechanism information to be returned
+ *
+ * If the mechanism is supported, true is returned. Otherwise, false is returned.
+*/
+bool mechanism_cache::info(const CK_MECHANISM_TYPE mechType, CK_MECHANISM_INFO& mechInfo) const
+{
+	std::unordered_map<CK_MECHANISM_TYPE, CK_MECHANISM_INFO>::const_iterator found = mechanisms.find(mechType);
+
+	if (found == mechanisms.end()) {
+		return false;
+	}
+	mechInfo = found->second;
+	return true;
+}
+
+
+
+/**
+ * The function selects the first supported mechanism from given list
+ *
+ * preferred is an alias of constant list of mechanisms ordered by preference e.g., fastest first
+ * requiredFlags represents the flags which should all be set
+ * keySize represents the key size to be used, 0 means any key size
+ *
+ * The selected mechanism is returned, or CK_UNAVAILABLE_INFORMATION if none is supported.
+*/
+CK_MECHANISM_TYPE mechanism_cache::select(const std::vector<CK_MECHANISM_TYPE>& preferred,
+											const CK_FLAGS requiredFlags, const CK_ULONG keySize) const
+{
+	for (size_t i = 0; i < preferred.size(); ++i) {
+		if (supports(preferred[i], requiredFlags, keySize)) {
+			return preferred[i];
+		}
+	}
+	return CK_UNAVAILABLE_INFORMATION;
+}
+
+
+
+/**
+ * Similar to check_operation(), the function checks whether given mechanism is supported
+ * before calling the token, so an unsupported operation fails fast.
+ *
+ * cache is an alias of constant mechanism_cache
+ * mechType is the mechanism type
+ * requiredFlags represents the flags which should all be set
+ * keySize represents the key size to be used, 0 means any key size
+ * message represent the operation to be performed
+ *
+ * If the mechanism is supported, then 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int check_mechanism(const mechanism_cache& cache, const CK_MECHANISM_TYPE mechType,
+					const CK_FLAGS requiredFlags, const CK_ULONG keySize, const char* message)
+{
+	if (!cache.supports(mechType, requiredFlags, keySize)) {
+		cout << "Error, " << message << " mechanism 0x" << std::hex << mechType << std::dec
+				<< " is not supported by the token in slot ID " << cache.slot() << endl;
+		return 1;
+	}
+	return 0;
+}
+
+
+
+mechanism_registry::mechanism_registry()
+{
+}
+
+
+
+/**
+ * The function builds the mechanism cache of given slot once, the next calls do not call the token
+ * e.g., connect_slot() and slot_dispatcher connecting to the same slot.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int mechanism_registry::build(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID)
+{
+	std::shared_ptr<mechanism_cache> cache(new mechanism_cache());
+
+	// Concurrent builds of the same slot wait for the first one
+	std::lock_guard<std::mutex> lock(registryMutex);
+	if (caches.count(token_key(funclistPtr, slotID))) {
+		return 0;
+	}
+	if (cache->build(funclistPtr, slotID)) {
+		return 2;
+	}
+	caches[token_key(funclistPtr, slotID)] = cache;
+	return 0;
+}
+
+
+
+/**
+ * The function gets the mechanism cache of given slot
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ *
+ * The mechanism cache is returned, or an empty pointer if the slot is not connected.
+*/
+std::shared_ptr<const mechanism_cache> mechanism_registry::lookup(const CK_FUNCTION_LIST_PTR funclistPtr,
+																	const CK_SLOT_ID slotID)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	std::map<token_key, std::shared_ptr<const mechanism_cache> >::const_iterator found =
+		caches.find(token_key(funclistPtr, slotID));
+	return found == caches.end() ? std::shared_ptr<const mechanism_cache>() : found->second;
+}
+
+
+
+/**
+ * The function gets the mechanism cache of the slot of a connected session e.g., the session
+ * opened by connect_slot().
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ *
+ * The mechanism cache is returned, or an empty pointer if the slot is not connected.
+*/
+std::shared_ptr<const mechanism_cache> mechanism_registry::lookup_session(const CK_FUNCTION_LIST_PTR funclistPtr,
+																			const CK_SESSION_HANDLE& hSession)
+{
+	CK_SESSION_INFO sessionInfo;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return std::shared_ptr<const mechanism_cache>();
+	}
+	if (check_operation(funclistPtr->C_GetSessionInfo(hSession, &sessionInfo), "C_GetSessionInfo()")) {
+		return std::shared_ptr<const mechanism_cache>();
+	}
+	return lookup(funclistPtr, sessionInfo.slotID);
+}
+
+
+
+/**
+ * The function removes the mechanism caches of every slot of given library e.g., after C_Finalize(),
+ * since the tokens may change before the library is initialized again. A cache still held by a caller
+ * stays valid.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ *
+ * The function does not return anything.
+*/
+void mechanism_registry::forget(const CK_FUNCTION_LIST_PTR funclistPtr)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	std::map<token_key, std::shared_ptr<const mechanism_cache> >::iterator it = caches.begin();
+	while (it != caches.end()) {
+		if (it->first.first == funclistPtr) {
+			it = caches.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+
+
+/**
+ * The function gets the mechanism registry shared by the whole application e.g., connect_slot()
+ * and slot_dispatcher.
+ *
+ * The alias of the application mechanism registry is returned.
+*/
+mechanism_registry& application_mechanisms()
+{
+	static mechanism_registry registry;
+	return registry;
+}
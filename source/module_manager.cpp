@@ -0,0 +1,263 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#ifdef WIND
+	#include "..\header\win_basic_operation.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\login_manager.hpp"
+	#include "..\header\mechanism_cache.hpp"
+	#include "..\header\module_manager.hpp"
+#else
+	#include <dlfcn.h>		// On Linux, required for dynamic loading, linking e.g., dlopen(), dlclose(), dlsym(), etc.
+	#include "../header/basic_operation.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/login_manager.hpp"
+	#include "../header/mechanism_cache.hpp"
+	#include "../header/module_manager.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+module_manager::module_manager()
+{
+}
+
+
+module_manager::~module_manager()
+{
+	unload_all();
+}
+
+
+
+/**
+ * The function loads the libraries listed in given configuration file, one library per line
+ * followed by optional environment variables (NAME=VALUE) to be set before its C_Initialize()
+ *
+ * configPath is an alias of constant path of the configuration file
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int module_manager::load_config(const std::string& configPath)
+{
+	int retVal = 0;
+	std::ifstream configFile(configPath.c_str());
+	std::string line;
+
+	if (!configFile) {
+		cout << "Error, failed to open module configuration file " << configPath << endl;
+		return 2;
+	}
+
+	while (!retVal && std::getline(configFile, line)) {
+		std::istringstream fields(line);
+		std::string libPath;
+		std::string assign;
+		std::vector<std::string> envAssign;
+
+		if (!(fields >> libPath) || libPath[0] == '#') {
+			// Empty line or comment
+			continue;
+		}
+		while (fields >> assign) {
+			envAssign.push_back(assign);
+		}
+		retVal = load_module(libPath, envAssign);
+	}
+	if (!retVal) {
+		retVal = refresh_slots();
+	}
+	return retVal;
+}
+
+
+
+/**
+ * The function loads the libraries listed in given environment variable where the
+ * library paths are separated by colon e.g.,
+ *      export SOFTHSM2_LIBS=/opt/softhsm2-a/lib/libsofthsm2.so:/opt/softhsm2-b/lib/libsofthsm2.so
+ *
+ * envName is a pointer to null-terminated name of the environment variable
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int module_manager::load_env(const char* envName)
+{
+	int retVal = 0;
+	const char* libPaths = getenv(envName);
+	std::string libPath;
+
+	if (!libPaths) {
+		cout << "Error, " << envName << " environment variable is not set" << endl;
+		return 3;
+	}
+
+	std::istringstream paths(libPaths);
+	while (!retVal && std::getline(paths, libPath, ':')) {
+		if (!libPath.empty()) {
+			retVal = load_module(libPath, std::vector<std::string>());
+		}
+	}
+	if (!retVal) {
+		retVal = refresh_slots();
+	}
+	return retVal;
+}
+
+
+
+/**
+ * The function loads and initializes one library (module)
+ *
+ * libPath is an alias of constant library path
+ * envAssign is an alias of constant list of NAME=VALUE environment variables to be set
+ * before C_Initialize() e.g., SOFTHSM2_CONF of a SoftHSM instance
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int module_manager::load_module(const std::string& libPath, const std::vector<std::string>& envAssign)
+{
+	pkcs11_module newModule;
+	CK_C_INITIALIZE_ARGS initArgs = {};
+	CK_RV rv = CKR_OK;
+
+	newModule.libPath = libPath;
+	newModule.libHandle = NULL_PTR;
+	newModule.funclistPtr = NULL_PTR;
+	newModule.finalize = false;
+
+	if (load_library_path(libPath.c_str(), newModule.libHandle, newModule.funclistPtr)) {
+		if (newModule.libHandle) {
+			dlclose(newModule.libHandle);
+		}
+		return 4;
+	}
+
+	for (size_t i = 0; i < modules.size(); ++i) {
+		if (modules[i].libHandle == newModule.libHandle) {
+			cout << "Error, " << libPath << " is already loaded, use a copy of the library instead" << endl;
+			dlclose(newModule.libHandle);
+			return 4;
+		}
+	}
+
+	for (size_t i = 0; i < envAssign.size(); ++i) {
+		size_t pos = envAssign[i].find('=');
+		if (pos == std::string::npos) {
+			cout << "Error, " << envAssign[i] << " is not NAME=VALUE" << endl;
+			dlclose(newModule.libHandle);
+			return 4;
+		}
+		setenv(envAssign[i].substr(0, pos).c_str(), envAssign[i].substr(pos + 1).c_str(), 1);
+	}
+
+	// The library may be used by the worker threads of async_executor
+	initArgs.flags = CKF_OS_LOCKING_OK;
+	rv = newModule.funclistPtr->C_Initialize(&initArgs);
+	if (rv == CKR_OK) {
+		newModule.finalize = true;
+	}
+	else if (rv != CKR_CRYPTOKI_ALREADY_INITIALIZED) {
+		check_operation(rv, "C_Initialize()");
+		dlclose(newModule.libHandle);
+		return 4;
+	}
+
+	modules.push_back(newModule);
+	return 0;
+}
+
+
+
+/**
+ * The function rebuilds the unified slot namespace from the slots with a token present
+ * of every loaded module. The unified slot ID is the index in this namespace.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int module_manager::refresh_slots()
+{
+	CK_ULONG slotsCount = 0;
+
+	unifiedSlots.clear();
+	for (size_t i = 0; i < modules.size(); ++i) {
+		pkcs11_module& current = modules[i];
+
+		if (check_operation(current.funclistPtr->C_GetSlotList(CK_TRUE, NULL_PTR, &slotsCount), "C_GetSlotList()")) {
+			return 5;
+		}
+		current.slots.resize(slotsCount);
+		if (slotsCount && check_operation(current.funclistPtr->C_GetSlotList(CK_TRUE, current.slots.data(), &slotsCount),
+											"C_GetSlotList()")) {
+			return 5;
+		}
+		current.slots.resize(slotsCount);
+
+		for (CK_ULONG j = 0; j < slotsCount; ++j) {
+			unified_slot unified = {i, current.funclistPtr, current.slots[j]};
+			unifiedSlots.push_back(unified);
+		}
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function finalizes the libraries initialized by the manager and unloads all libraries
+ *
+ * The function does not return anything.
+*/
+void module_manager::unload_all()
+{
+	for (size_t i = 0; i < modules.size(); ++i) {
+		// The login state of the library does not survive C_Finalize()
+		application_login().forget(modules[i].funclistPtr);
+		if (modules[i].finalize) {
+			check_operation(modules[i].funclistPtr->C_Finalize(NULL_PTR), "C_Finalize()");
+		}
+		application_mechanisms().forget(modules[i].funclistPtr);
+		free_resource(modules[i].libHandle, modules[i].funclistPtr);
+	}
+	modules.clear();
+	unifiedSlots.clear();
+}
+
+
+
+/**
+ * The function adds the slots of all modules holding the required key to given dispatcher,
+ * so operations are spread across heterogeneous modules.
+ *
+ * manager is an alias of constant module_manager with loaded modules
+ * dispatcher is an alias of slot_dispatcher
+ * selector is an alias of constant key selector
+ * usrPIN is an alias of user PIN
+ * workersPerSlot represents the number of worker threads (and sessions) per slot
+ *
+ * On success i.e., at least one slot is eligible, integer 0 is returned.
+ * Otherwise, non-zero integer is returned.
+*/
+int add_module_slots(const module_manager& manager, slot_dispatcher& dispatcher,
+						const key_selector& selector, const std::string& usrPIN,
+						const size_t workersPerSlot)
+{
+	size_t added = 0;
+
+	for (size_t i = 0; i < manager.slot_count(); ++i) {
+		const unified_slot& current = manager.slot(i);
+		if (dispatcher.add_slot(current.funclistPtr, current.slotID, selector, usrPIN, workersPerSlot)) {
+			cout << "Unified slot " << i << " (module " << current.moduleIndex << ", slot ID "
+					<< current.slotID << ") is not eligible, skipped" << endl;
+		}
+		else {
+			++added;
+		}
+	}
+	return added ? 0 : 6;
+}
@@ -0,0 +1,232 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\object_attributes.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/object_attributes.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The alignment of every allocation, enough for CK_ATTRIBUTE and CK_ULONG values e.g., CKA_CLASS
+*/
+const size_t ARENA_ALIGNMENT = alignof(CK_ATTRIBUTE) > alignof(CK_ULONG) ? alignof(CK_ATTRIBUTE) : alignof(CK_ULONG);
+
+
+
+/**
+ * blockSize represents the byte-length of every block of the arena, a larger allocation
+ * gets a block of its own size
+*/
+attribute_arena::attribute_arena(const size_t blockSize) : blockSize(blockSize), current(0), offset(0)
+{
+}
+
+
+
+/**
+ * The function allocates given number of bytes from the arena
+ *
+ * size represents the number of bytes
+ *
+ * The pointer to the allocated bytes is returned.
+*/
+CK_BYTE_PTR attribute_arena::allocate(const size_t size)
+{
+	size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+	// Moving to the next block, re-used after reset() or appended
+	while (current < blocks.size() && offset + aligned > blocks[current].size) {
+		++current;
+		offset = 0;
+	}
+	if (current == blocks.size()) {
+		arena_block block;
+		block.size = aligned > blockSize ? aligned : blockSize;
+		block.memory.reset(new CK_BYTE[block.size]);
+		blocks.push_back(std::move(block));
+	}
+
+	CK_BYTE_PTR allocated = blocks[current].memory.get() + offset;
+	offset += aligned;
+	return allocated;
+}
+
+
+
+/**
+ * The function releases all allocations at once, the blocks are kept for re-use
+ *
+ * The function does not return anything.
+*/
+void attribute_arena::reset()
+{
+	current = 0;
+	offset = 0;
+}
+
+
+
+/**
+ * The function gets the number of bytes used in the arena, including alignment and the
+ * unused tails of the blocks already passed
+ *
+ * The number of bytes is returned.
+*/
+size_t attribute_arena::used() const
+{
+	size_t total = offset;
+
+	for (size_t i = 0; i < current && i < blocks.size(); ++i) {
+		total += blocks[i].size;
+	}
+	return total;
+}
+
+
+
+/**
+ * The function finds an attribute of the object
+ *
+ * type is the attribute type e.g., CKA_LABEL
+ *
+ * The pointer to the attribute is returned, or NULL_PTR if it was not requested.
+*/
+const CK_ATTRIBUTE* object_attributes::find(const CK_ATTRIBUTE_TYPE type) const
+{
+	for (CK_ULONG i = 0; i < count; ++i) {
+		if (attributes[i].type == type) {
+			return &attributes[i];
+		}
+	}
+	return NULL_PTR;
+}
+
+
+
+/**
+ * The function checks whether given CK_RV of C_GetAttributeValue() still returned the
+ * available attributes i.e., some attributes are sensitive or not held by the object.
+*/
+static bool is_partial_rv(const CK_RV rv)
+{
+	return rv == CKR_OK || rv == CKR_ATTRIBUTE_SENSITIVE || rv == CKR_ATTRIBUTE_TYPE_INVALID;
+}
+
+
+
+/**
+ * The function reads given attributes of an object in at most two calls
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * hObject is the handle of the object
+ * types is an alias of constant list of attribute types
+ * arena is an alias of the arena storing the attributes and their values
+ * result is an alias of the attributes to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int read_object_attributes(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+							const CK_OBJECT_HANDLE hObject, const std::vector<CK_ATTRIBUTE_TYPE>& types,
+							attribute_arena& arena, object_attributes& result)
+{
+	CK_RV rv = CKR_OK;
+	bool anyAvailable = false;
+
+	result.hObject = hObject;
+	result.count = types.size();
+	result.valid = false;
+	result.attributes = reinterpret_cast<CK_ATTRIBUTE_PTR>(arena.allocate(types.size() * sizeof(CK_ATTRIBUTE)));
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		result.count = 0;
+		return 2;
+	}
+
+	for (size_t i = 0; i < types.size(); ++i) {
+		result.attributes[i].type = types[i];
+		result.attributes[i].pValue = NULL_PTR;
+		result.attributes[i].ulValueLen = 0;
+	}
+
+	/**
+	 * CK_RV C_GetAttributeValue(CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject,
+	 * 							CK_ATTRIBUTE_PTR pTemplate, CK_ULONG ulCount);
+	 *
+	 * C_GetAttributeValue() obtains the value of one or more attributes of an object.
+	 * If pValue of an attribute is NULL_PTR, then only its byte-length is returned in ulValueLen.
+	 * If an attribute is sensitive or the object does not hold it, then its ulValueLen is set
+	 * to CK_UNAVAILABLE_INFORMATION and the remaining attributes are still processed.
+	*/
+	rv = funclistPtr->C_GetAttributeValue(hSession, hObject, result.attributes, result.count);
+	if (!is_partial_rv(rv)) {
+		check_operation(rv, "C_GetAttributeValue()");
+		return 3;
+	}
+
+	for (CK_ULONG i = 0; i < result.count; ++i) {
+		if (result.attributes[i].ulValueLen != CK_UNAVAILABLE_INFORMATION) {
+			result.attributes[i].pValue = arena.allocate(result.attributes[i].ulValueLen);
+			anyAvailable = true;
+		}
+	}
+
+	if (anyAvailable) {
+		rv = funclistPtr->C_GetAttributeValue(hSession, hObject, result.attributes, result.count);
+		if (!is_partial_rv(rv)) {
+			check_operation(rv, "C_GetAttributeValue()");
+			return 3;
+		}
+	}
+	result.valid = true;
+	return 0;
+}
+
+
+
+/**
+ * The function reads given attributes of many objects, every object in at most two calls
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * hObjects is an alias of constant list of object handles e.g., found by C_FindObjects()
+ * types is an alias of constant list of attribute types
+ * arena is an alias of the arena storing the attributes and their values
+ * results is an alias of the attributes of the objects, in the order of hObjects
+ *
+ * An object which cannot be read e.g., destroyed meanwhile, is marked as not valid and
+ * the remaining objects are still read.
+ *
+ * On success i.e., all objects are read, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int read_attributes(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+					const std::vector<CK_OBJECT_HANDLE>& hObjects, const std::vector<CK_ATTRIBUTE_TYPE>& types,
+					attribute_arena& arena, std::vector<object_attributes>& results)
+{
+	size_t failed = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+
+	results.resize(hObjects.size());
+	for (size_t i = 0; i < hObjects.size(); ++i) {
+		if (read_object_attributes(funclistPtr, hSession, hObjects[i], types, arena, results[i])) {
+			++failed;
+		}
+	}
+
+	if (failed) {
+		cout << "Error, attributes of " << failed << " of " << hObjects.size() << " objects are not read" << endl;
+		return 4;
+	}
+	return 0;
+}
@@ -0,0 +1,356 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef WIND
+	#include "..\header\secure_pool.hpp"
+#else
+	#include "../header/secure_pool.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * The free blocks cached by a thread, per size class. It is trivially destructible, so it can be used
+ * until the thread ends, after cache_flusher has given its blocks back to the pool i.e., exiting.
+*/
+struct thread_cache
+{
+	secure_block* heads[SECURE_CLASS_COUNT];
+	size_t counts[SECURE_CLASS_COUNT];
+	bool registered;
+	bool exiting;
+};
+
+static thread_local thread_cache cache;
+
+
+/**
+ * The function gets the size class of given byte-length, or SECURE_CLASS_COUNT if it is too large
+*/
+static size_t class_index(const size_t len)
+{
+	size_t index = 0;
+
+	while (index < SECURE_CLASS_COUNT && SECURE_SIZE_CLASSES[index] < len) {
+		++index;
+	}
+	return index;
+}
+
+
+
+/**
+ * The function rounds given byte-length up to whole pages
+*/
+static size_t page_round(const size_t len)
+{
+	const size_t pageSz = sysconf(_SC_PAGESIZE);
+	return (len + pageSz - 1) / pageSz * pageSz;
+}
+
+
+
+/**
+ * The function gives the blocks of the cache of the calling thread back to the pool when the thread ends
+*/
+struct cache_flusher
+{
+	~cache_flusher()
+	{
+		for (size_t i = 0; i < SECURE_CLASS_COUNT; ++i) {
+			if (cache.heads[i]) {
+				application_secure_pool().release(i, cache.heads[i]);
+			}
+			cache.heads[i] = NULL_PTR;
+			cache.counts[i] = 0;
+		}
+		cache.exiting = true;
+	}
+};
+
+
+/**
+ * The function makes sure the cache of the calling thread is flushed when the thread ends
+*/
+static void register_cache()
+{
+	static thread_local cache_flusher flusher;
+	(void)flusher;
+	cache.registered = true;
+}
+
+
+
+/**
+ * The function zeroizes given memory. The compiler cannot remove it, though the memory is not read
+ * again before it is released.
+*/
+void secure_zero(void* ptr, const size_t len)
+{
+	if (!ptr || !len) {
+		return;
+	}
+#if defined(__GNUC__)
+	std::memset(ptr, 0, len);
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+#else
+	volatile CK_BYTE* bytePtr = static_cast<volatile CK_BYTE*>(ptr);
+	for (size_t i = 0; i < len; ++i) {
+		bytePtr[i] = 0;
+	}
+#endif
+}
+
+
+
+secure_pool::secure_pool() : poolStats(), lockFailed(false)
+{
+	for (size_t i = 0; i < SECURE_CLASS_COUNT; ++i) {
+		freeLists[i] = NULL_PTR;
+	}
+}
+
+
+
+/**
+ * The function maps given byte-length of zeroed memory, locks it and leaves it out of core dumps.
+ * It is called with poolMutex held.
+ *
+ * The memory is returned, or NULL_PTR on failure.
+*/
+void* secure_pool::map_locked(const size_t len)
+{
+	void* ptr = mmap(NULL_PTR, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (ptr == MAP_FAILED) {
+		cout << "Error, cannot map " << len << " bytes of secure memory: " << std::strerror(errno) << endl;
+		return NULL_PTR;
+	}
+#ifdef MADV_DONTDUMP
+	madvise(ptr, len, MADV_DONTDUMP);
+#endif
+	if (!mlock(ptr, len)) {
+		poolStats.lockedBytes += len;
+	}
+	else if (!lockFailed) {
+		lockFailed = true;
+		cout << "Error, cannot lock secure memory, it may be swapped out: " << std::strerror(errno) << endl;
+	}
+	return ptr;
+}
+
+
+
+/**
+ * The function maps a slab and carves it into free blocks of given size class.
+ * It is called with poolMutex held.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int secure_pool::add_slab(const size_t classIndex)
+{
+	const size_t blockSz = SECURE_SIZE_CLASSES[classIndex];
+	CK_BYTE_PTR slabPtr = static_cast<CK_BYTE_PTR>(map_locked(SECURE_SLAB_SIZE));
+
+	if (!slabPtr) {
+		return 1;
+	}
+	for (size_t offset = SECURE_SLAB_SIZE; offset >= blockSz; offset -= blockSz) {
+		secure_block* block = reinterpret_cast<secure_block*>(slabPtr + offset - blockSz);
+		block->next = freeLists[classIndex];
+		freeLists[classIndex] = block;
+	}
+	++poolStats.slabCount;
+	poolStats.slabBytes += SECURE_SLAB_SIZE;
+	return 0;
+}
+
+
+
+/**
+ * The function moves up to given number of free blocks of given size class from the pool to given list,
+ * adding a slab if needed
+ *
+ * The number of blocks moved is returned, 0 on failure.
+*/
+size_t secure_pool::refill(const size_t classIndex, secure_block*& head, const size_t count)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	size_t moved = 0;
+
+	for (; moved < count; ++moved) {
+		if (!freeLists[classIndex] && add_slab(classIndex)) {
+			break;
+		}
+		secure_block* block = freeLists[classIndex];
+		freeLists[classIndex] = block->next;
+		block->next = head;
+		head = block;
+	}
+	++poolStats.refillCount;
+	return moved;
+}
+
+
+
+/**
+ * The function gives given list of zeroized free blocks of given size class back to the pool
+*/
+void secure_pool::release(const size_t classIndex, secure_block* head)
+{
+	secure_block* tail = head;
+
+	if (!head) {
+		return;
+	}
+	while (tail->next) {
+		tail = tail->next;
+	}
+	std::lock_guard<std::mutex> lock(poolMutex);
+	tail->next = freeLists[classIndex];
+	freeLists[classIndex] = head;
+}
+
+
+
+/**
+ * The function allocates zeroed secure memory of given byte-length, from the cache of the calling thread
+ * if it fits a size class
+ *
+ * len is the byte-length
+ *
+ * The memory is returned, or NULL_PTR on failure.
+*/
+void* secure_pool::allocate(const size_t len)
+{
+	const size_t classIndex = class_index(len);
+
+	if (classIndex == SECURE_CLASS_COUNT) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		size_t lockedBefore = poolStats.lockedBytes;
+		void* ptr = map_locked(page_round(len));
+		if (ptr) {
+			largeBlocks[ptr] = poolStats.lockedBytes != lockedBefore;
+			++poolStats.largeCount;
+			poolStats.largeBytes += page_round(len);
+		}
+		return ptr;
+	}
+
+	if (!cache.registered) {
+		register_cache();
+	}
+	secure_block* block = NULL_PTR;
+	if (cache.exiting) {
+		// The thread is ending, so the pool is used directly
+		refill(classIndex, block, 1);
+	}
+	else {
+		if (!cache.heads[classIndex]) {
+			cache.counts[classIndex] += refill(classIndex, cache.heads[classIndex], SECURE_CACHE_BATCH);
+		}
+		block = cache.heads[classIndex];
+		if (block) {
+			cache.heads[classIndex] = block->next;
+			--cache.counts[classIndex];
+		}
+	}
+	if (block) {
+		block->next = NULL_PTR;
+	}
+	return block;
+}
+
+
+
+/**
+ * The function zeroizes and releases given secure memory, to the cache of the calling thread if it fits
+ * a size class. When the cache holds two batches, one batch goes back to the pool.
+ *
+ * ptr is a pointer to memory given by allocate(), or NULL_PTR
+ * len is the byte-length given to allocate()
+*/
+void secure_pool::deallocate(void* ptr, const size_t len)
+{
+	const size_t classIndex = class_index(len);
+
+	if (!ptr) {
+		return;
+	}
+
+	if (classIndex == SECURE_CLASS_COUNT) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		std::map<void*, bool>::iterator found = largeBlocks.find(ptr);
+		if (found == largeBlocks.end()) {
+			// Not mapped by allocate() e.g., released twice, so it is neither touched nor unmapped
+			cout << "Error, " << ptr << " is not a large block of the secure pool" << endl;
+			return;
+		}
+		secure_zero(ptr, page_round(len));
+		if (found->second) {
+			munlock(ptr, page_round(len));
+			poolStats.lockedBytes -= page_round(len);
+		}
+		largeBlocks.erase(found);
+		munmap(ptr, page_round(len));
+		--poolStats.largeCount;
+		poolStats.largeBytes -= page_round(len);
+		return;
+	}
+
+	secure_zero(ptr, SECURE_SIZE_CLASSES[classIndex]);
+	secure_block* block = static_cast<secure_block*>(ptr);
+	if (!cache.registered) {
+		register_cache();
+	}
+	if (cache.exiting) {
+		block->next = NULL_PTR;
+		release(classIndex, block);
+		return;
+	}
+	block->next = cache.heads[classIndex];
+	cache.heads[classIndex] = block;
+	if (++cache.counts[classIndex] >= 2 * SECURE_CACHE_BATCH) {
+		// Cutting one batch off the front of the list
+		secure_block* last = cache.heads[classIndex];
+		for (size_t i = 1; i < SECURE_CACHE_BATCH; ++i) {
+			last = last->next;
+		}
+		secure_block* batch = cache.heads[classIndex];
+		cache.heads[classIndex] = last->next;
+		last->next = NULL_PTR;
+		cache.counts[classIndex] -= SECURE_CACHE_BATCH;
+		release(classIndex, batch);
+	}
+}
+
+
+
+/**
+ * The function gets the statistics of the pool
+*/
+secure_pool_stats secure_pool::stats()
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return poolStats;
+}
+
+
+
+/**
+ * The function gets the secure pool shared by the whole application e.g., secure_allocator.
+ * It is never destroyed, so the buffers of static objects can still be released at exit.
+ *
+ * The alias of the application secure pool is returned.
+*/
+secure_pool& application_secure_pool()
+{
+	static secure_pool* pool = new secure_pool();
+	return *pool;
+}
@@ -0,0 +1,208 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\login_manager.hpp"
+	#include "..\header\session_recovery.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/login_manager.hpp"
+	#include "../header/session_recovery.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The first wait before retrying an operation, it is doubled on every retry
+ * e.g., while a removed token is coming back
+*/
+const std::chrono::milliseconds FIRST_BACKOFF(5);
+
+
+
+/**
+ * The function checks whether given CK_RV means the session (or its login state) is lost,
+ * so the operation may succeed on a new session.
+ *
+ * rv represents the CK_RV value returned by Cryptoki function
+ *
+ * If the CK_RV value is retryable, true is returned. Otherwise, false is returned.
+*/
+bool is_retryable_rv(const CK_RV rv)
+{
+	switch (rv) {
+	case CKR_SESSION_HANDLE_INVALID:
+	case CKR_SESSION_CLOSED:
+	case CKR_DEVICE_REMOVED:
+	case CKR_DEVICE_ERROR:
+	case CKR_TOKEN_NOT_PRESENT:
+	case CKR_USER_NOT_LOGGED_IN:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+
+/**
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ * credentials is the source of the user PIN, called once on the first login
+ * retryBudget represents the maximum number of retries of one operation
+*/
+recoverable_session::recoverable_session(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+											credential_source credentials, const unsigned retryBudget)
+	: funclistPtr(funclistPtr), slotID(slotID), hSession(0), opened(false), holdsLogin(false),
+	credentials(credentials), pinCached(false), retryBudget(retryBudget)
+{
+}
+
+
+recoverable_session::~recoverable_session()
+{
+	close();
+	usrPIN.assign(usrPIN.length(), '\0');
+	usrPIN.clear();
+}
+
+
+
+/**
+ * The function opens the session and logs in
+ * Note that Cryptoki library should be initialized before calling this function.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int recoverable_session::open()
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	if (check_operation(funclistPtr->C_OpenSession(slotID, CKF_SERIAL_SESSION | CKF_RW_SESSION,
+													NULL_PTR, NULL_PTR, &hSession), "C_OpenSession()")) {
+		return 2;
+	}
+	opened = true;
+	if (login()) {
+		close();
+		return 2;
+	}
+	return 0;
+}
+
+
+
+int recoverable_session::login()
+{
+	if (!pinCached) {
+		if (!credentials || credentials(usrPIN)) {
+			cout << "Error, no credential is available to login\n";
+			return 3;
+		}
+		pinCached = true;
+	}
+
+	// The reference is kept while recovering, the login state may be lost with the dead session though
+	if (holdsLogin) {
+		return application_login().ensure(funclistPtr, hSession, usrPIN);
+	}
+	if (application_login().acquire(funclistPtr, slotID, hSession, usrPIN)) {
+		return 3;
+	}
+	holdsLogin = true;
+	return 0;
+}
+
+
+
+/**
+ * The function closes the dead session, if any, then re-opens the session and re-logs in
+ * with the cached credential.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int recoverable_session::recover()
+{
+	if (opened) {
+		// The session may already be invalid, so the returned value is ignored
+		funclistPtr->C_CloseSession(hSession);
+		opened = false;
+	}
+	return open();
+}
+
+
+
+/**
+ * The function releases the login reference and closes the session
+ *
+ * The function does not return anything.
+*/
+void recoverable_session::close()
+{
+	if (holdsLogin) {
+		application_login().release(funclistPtr, slotID, hSession);
+		holdsLogin = false;
+	}
+	if (opened) {
+		check_operation(funclistPtr->C_CloseSession(hSession), "C_CloseSession()");
+		opened = false;
+	}
+}
+
+
+
+/**
+ * The function performs given operation, and if it fails because the session is lost,
+ * then recovers the session and performs the idempotent operation again, up to the
+ * retry budget. A non-idempotent operation is not performed again, but the session is
+ * recovered for the next operations.
+ *
+ * operation is the operation to be performed on the session
+ * idempotent tells whether the operation can be safely performed again
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int recoverable_session::run(token_operation operation, const bool idempotent)
+{
+	int retVal = 0;
+	std::chrono::milliseconds backoff = FIRST_BACKOFF;
+
+	if (!opened && recover()) {
+		return 4;
+	}
+
+	for (unsigned retry = 0; ; ++retry) {
+		if (opened) {
+			// Only the CK_RV the operation failed with tells whether the session is lost
+			operation_rv_scope rvScope;
+			retVal = operation(hSession);
+			if (!retVal || !is_retryable_rv(rvScope.failed_rv())) {
+				return retVal;
+			}
+		}
+		else {
+			// The previous recovery failed e.g., the token is not back yet
+			retVal = 4;
+		}
+		if (!idempotent || retry >= retryBudget) {
+			cout << "Error, session is lost and the operation is not retried" << endl;
+			// The session is still recovered, so the next operations do not use the dead session
+			recover();
+			return retVal;
+		}
+
+		cout << "Session is lost, recovering (retry " << retry + 1 << " of " << retryBudget << ")" << endl;
+		if (retry) {
+			std::this_thread::sleep_for(backoff);
+			backoff *= 2;
+		}
+		recover();
+	}
+}
@@ -1,9 +1,11 @@
 #include <iostream>
 #include <limits>
 #ifdef WIND
+	#include "..\header\attribute_template.hpp"
 	#include "..\header\common_basic_operation.hpp"
 	#include "..\header\sign_verify_ECDSA.hpp"
 #else
+	#include "../header/attribute_template.hpp"
 	#include "../header/common_basic_operation.hpp"
 	#include "../header/sign_verify_ECDSA.hpp"
 #endif
@@ -20,6 +22,33 @@ using std::cout;
 CK_MECHANISM signMech = {CKM_ECDSA};
 
 
+/**
+ * The labels of ECDSA public and private keys
+ */
+const CK_UTF8CHAR pubLabel[] = "ECDSA public key";
+const CK_UTF8CHAR prvLabel[] = "ECDSA private key";
+
+/**
+ * The ECDSA public key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_PRIVATE, CK_FALSE>,
+							fixed_attribute<CKA_VERIFY, CK_TRUE>,
+							fixed_attribute<CKA_ENCRYPT, CK_TRUE>,
+							variable_attribute<CKA_ECDSA_PARAMS>,
+							variable_attribute<CKA_LABEL> > ECDSA_public_template;
+
+/**
+ * The ECDSA private key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SIGN, CK_TRUE>,
+							fixed_attribute<CKA_DECRYPT, CK_TRUE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							variable_attribute<CKA_LABEL> > ECDSA_private_template;
+
+
 
 
 
@@ -49,33 +78,17 @@ int gen_ECDSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_H
 	}
 
 	CK_MECHANISM mech = {CKM_ECDSA_KEY_PAIR_GEN};
-    CK_BBOOL yes = CK_TRUE;
-    CK_BBOOL no = CK_FALSE;
-    CK_UTF8CHAR pubLabel[] = "ECDSA public key";
-    CK_UTF8CHAR prvLabel[] = "ECDSA private key";
-	
+	ECDSA_public_template attribPub;
+	ECDSA_private_template attribPrv;
 
-	CK_ATTRIBUTE attribPub[] = {
-        {CKA_TOKEN,				&no,			sizeof(no)},
-        {CKA_PRIVATE,			&no,			sizeof(no)},
-        {CKA_VERIFY,			&yes,			sizeof(yes)},
-        {CKA_ENCRYPT,			&yes,			sizeof(yes)},
-        {CKA_ECDSA_PARAMS,		ecPara,			ecParaSZ},
-        {CKA_LABEL,				&pubLabel,		sizeof(pubLabel)}
-    };
-    
-    CK_ATTRIBUTE attribPrv[] = {
-        {CKA_TOKEN,				&no,			sizeof(no)},
-        {CKA_PRIVATE,			&yes,			sizeof(yes)},
-        {CKA_SIGN,				&yes,			sizeof(yes)},
-        {CKA_DECRYPT,			&yes,			sizeof(yes)},
-        {CKA_SENSITIVE,			&yes,			sizeof(yes)},
-        {CKA_LABEL,				&prvLabel,		sizeof(prvLabel)}
-    };
+	// Only the variable attributes are patched, the remaining are laid out at compile time
+	attribPub.set_bytes<CKA_ECDSA_PARAMS>(ecPara, ecParaSZ);
+	attribPub.set_bytes<CKA_LABEL>(pubLabel, sizeof(pubLabel));
+	attribPrv.set_bytes<CKA_LABEL>(prvLabel, sizeof(prvLabel));
     
 	retVal = check_operation(funclistPtr->C_GenerateKeyPair(hSession, &mech, 
-											attribPub, sizeof(attribPub) / sizeof(*attribPub),
-											attribPrv, sizeof(attribPrv) / sizeof(*attribPrv),
+											attribPub.data(), attribPub.size(),
+											attribPrv.data(), attribPrv.size(),
 											hPubPtr, hPrvPtr), "C_GenerateKeyPair()");
 
     if (!retVal) {
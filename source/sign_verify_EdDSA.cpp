@@ -0,0 +1,293 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\attribute_template.hpp"
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\sign_verify_EdDSA.hpp"
+#else
+	#include "../header/attribute_template.hpp"
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/sign_verify_EdDSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The number of messages signed or verified by one queued operation of the batch mode
+*/
+const size_t SIGNATURES_PER_CHUNK = 32;
+
+
+/**
+ * The DER encoded object identifiers of the Edwards curves i.e., id-Ed25519 (1.3.101.112)
+ * and id-Ed448 (1.3.101.113), used as CKA_EC_PARAMS
+*/
+const CK_BYTE ed25519Params[] = {0x06, 0x03, 0x2b, 0x65, 0x70};
+const CK_BYTE ed448Params[] = {0x06, 0x03, 0x2b, 0x65, 0x71};
+
+
+/**
+ * The labels of EdDSA public and private keys
+ */
+const CK_UTF8CHAR pubLabel[] = "EdDSA public key";
+const CK_UTF8CHAR prvLabel[] = "EdDSA private key";
+
+
+/**
+ * The EdDSA public key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_PRIVATE, CK_FALSE>,
+							fixed_attribute<CKA_VERIFY, CK_TRUE>,
+							variable_attribute<CKA_EC_PARAMS>,
+							variable_attribute<CKA_LABEL> > EdDSA_public_template;
+
+/**
+ * The EdDSA private key attributes template
+ */
+typedef attribute_template<fixed_attribute<CKA_TOKEN, CK_FALSE>,
+							fixed_attribute<CKA_PRIVATE, CK_TRUE>,
+							fixed_attribute<CKA_SIGN, CK_TRUE>,
+							fixed_attribute<CKA_SENSITIVE, CK_TRUE>,
+							variable_attribute<CKA_LABEL> > EdDSA_private_template;
+
+
+
+/**
+ * The function gets the key size of given Edwards curve in bits, as reported by C_GetMechanismInfo()
+*/
+static CK_ULONG curve_bits(const edwards_curve curve)
+{
+	return curve == ED25519 ? 255 : 448;
+}
+
+
+
+/**
+ * The function gets the byte-length of the signatures of given Edwards curve
+ * i.e., 64 for Ed25519 and 114 for Ed448
+ *
+ * The byte-length is returned.
+*/
+CK_ULONG EdDSA_signature_length(const edwards_curve curve)
+{
+	return curve == ED25519 ? 64 : 114;
+}
+
+
+
+/**
+ * The function selects the fastest Edwards curve supported by the token i.e., Ed25519, then Ed448.
+ * A curve is supported if the token can generate its keypair and sign/verify with CKM_EDDSA,
+ * and its size is within the key sizes of CKM_EDDSA, where the token reports them.
+ *
+ * cache is an alias of constant mechanism cache of the slot e.g., application_mechanisms().lookup_session()
+ * curve is an alias of the selected curve to be returned
+ *
+ * If a curve is supported, then 0 is returned. Otherwise, non-zero integer is returned and
+ * the caller keeps using ECDSA.
+*/
+int select_EdDSA_curve(const mechanism_cache& cache, edwards_curve& curve)
+{
+	const edwards_curve preferred[] = {ED25519, ED448};
+	CK_MECHANISM_INFO mechInfo;
+
+	if (!cache.supports(CKM_EC_EDWARDS_KEY_PAIR_GEN, CKF_GENERATE_KEY_PAIR) ||
+		!cache.supports(CKM_EDDSA, CKF_SIGN | CKF_VERIFY) || !cache.info(CKM_EDDSA, mechInfo)) {
+		return 1;
+	}
+
+	for (size_t i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i) {
+		// Tokens differ in how they count the bits of Ed25519 e.g., 255 or 256, only the upper bound is checked
+		if (!mechInfo.ulMaxKeySize || curve_bits(preferred[i]) <= mechInfo.ulMaxKeySize) {
+			curve = preferred[i];
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+
+/**
+ * The function generates Edwards-curve Digital Signature Algorithm (EdDSA) keypair
+ * on given curve.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * curve is the Edwards curve i.e., ED25519 or ED448
+ * hPub is an alias of public key handle to be returned
+ * hPrv is an alias of private key handle to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int gen_EdDSA_keypair(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+						const edwards_curve curve, CK_OBJECT_HANDLE& hPub, CK_OBJECT_HANDLE& hPrv)
+{
+	CK_MECHANISM mech = {CKM_EC_EDWARDS_KEY_PAIR_GEN};
+	EdDSA_public_template attribPub;
+	EdDSA_private_template attribPrv;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	if (curve == ED25519) {
+		attribPub.set_bytes<CKA_EC_PARAMS>(ed25519Params, sizeof(ed25519Params));
+	}
+	else {
+		attribPub.set_bytes<CKA_EC_PARAMS>(ed448Params, sizeof(ed448Params));
+	}
+	attribPub.set_bytes<CKA_LABEL>(pubLabel, sizeof(pubLabel));
+	attribPrv.set_bytes<CKA_LABEL>(prvLabel, sizeof(prvLabel));
+
+	return check_operation(funclistPtr->C_GenerateKeyPair(hSession, &mech,
+											attribPub.data(), attribPub.size(),
+											attribPrv.data(), attribPrv.size(),
+											&hPub, &hPrv), "C_GenerateKeyPair()");
+}
+
+
+
+/**
+ * The function signs given message using CKM_EDDSA i.e., PureEdDSA without context
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant EdDSA private key handle
+ * curve is the Edwards curve of the private key, which gives the signature length
+ * message is an alias of constant message to be signed
+ * signature is an alias of the signature to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_EdDSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPrv, const edwards_curve curve,
+				const std::string& message, std::string& signature)
+{
+	// Without a parameter, CKM_EDDSA is Ed25519 or Ed448 without pre-hashing and context
+	CK_MECHANISM mech = {CKM_EDDSA, NULL_PTR, 0};
+	CK_ULONG sigLen = EdDSA_signature_length(curve);
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	if (check_operation(funclistPtr->C_SignInit(hSession, &mech, hPrv), "C_SignInit()")) {
+		return 3;
+	}
+	signature.resize(sigLen);
+	if (check_operation(funclistPtr->C_Sign(hSession, msgPtr, message.length(),
+											reinterpret_cast<CK_BYTE_PTR>(&signature[0]), &sigLen), "C_Sign()")) {
+		signature.clear();
+		return 3;
+	}
+	signature.resize(sigLen);
+	return 0;
+}
+
+
+
+/**
+ * The function verifies given signature on the message using CKM_EDDSA
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of constant EdDSA public key handle
+ * message is an alias of constant message that was signed
+ * signature is an alias of constant signature to be verified
+ *
+ * On success i.e., the signature is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_EdDSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPub, const std::string& message, const std::string& signature)
+{
+	CK_MECHANISM mech = {CKM_EDDSA, NULL_PTR, 0};
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+	CK_BYTE_PTR sigPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(signature.data()));
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+	if (check_operation(funclistPtr->C_VerifyInit(hSession, &mech, hPub), "C_VerifyInit()")) {
+		return 4;
+	}
+	return check_operation(funclistPtr->C_Verify(hSession, msgPtr, message.length(), sigPtr, signature.length()),
+							"C_Verify()");
+}
+
+
+
+/**
+ * The function signs (or verifies if signatures is not NULL_PTR) the messages in chunks across
+ * the worker sessions of given executor, see async_batch().
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int EdDSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const edwards_curve curve,
+						const std::vector<std::string>& messages, std::string* producedSigs,
+						const std::string* signatures, std::vector<int>& results)
+{
+	results.assign(messages.size(), 0);
+	if (async_batch(executor, messages.size(), SIGNATURES_PER_CHUNK,
+					[&](const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const size_t i) {
+						return signatures ? verify_EdDSA(funclistPtr, hSession, hKey, messages[i], signatures[i])
+										: sign_EdDSA(funclistPtr, hSession, hKey, curve, messages[i], producedSigs[i]);
+					}, results.data())) {
+		return 5;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function signs many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hPrv is an alias of constant EdDSA private key handle
+ * curve is the Edwards curve of the private key
+ * messages is an alias of constant list of messages
+ * signatures is an alias of the signatures to be returned, where signatures[i] is the signature
+ * of messages[i] and empty if that signing failed
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_EdDSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPrv, const edwards_curve curve,
+						const std::vector<std::string>& messages, std::vector<std::string>& signatures)
+{
+	std::vector<int> results;
+
+	signatures.assign(messages.size(), std::string());
+	return EdDSA_batch(executor, hPrv, curve, messages, signatures.data(), NULL_PTR, results);
+}
+
+
+
+/**
+ * The function verifies the signatures of many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hPub is an alias of constant EdDSA public key handle
+ * messages is an alias of constant list of messages
+ * signatures is an alias of constant list of signatures, where signatures[i] is the signature of messages[i]
+ * results is an alias of the results, where results[i] is 0 if signatures[i] is valid
+ *
+ * On success i.e., all signatures are valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_EdDSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPub,
+						const std::vector<std::string>& messages, const std::vector<std::string>& signatures,
+						std::vector<int>& results)
+{
+	if (signatures.size() != messages.size()) {
+		cout << "Error, number of signatures and messages are different\n";
+		return 6;
+	}
+	// The curve is not needed to verify
+	return EdDSA_batch(executor, hPub, ED25519, messages, NULL_PTR, signatures.data(), results);
+}
@@ -0,0 +1,554 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\sign_verify_RSA.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/sign_verify_RSA.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The number of messages signed or verified by one queued operation of the batch mode
+*/
+const size_t SIGNATURES_PER_CHUNK = 16;
+
+
+/**
+ * The hash algorithms of RSA signatures i.e., the MGF1 of PSS, the digest length, which is also
+ * the salt length of PSS, and the DER encoded DigestInfo prefix of PKCS #1 v1.5
+*/
+struct rsa_hash
+{
+	CK_MECHANISM_TYPE hashAlg;
+	CK_RSA_PKCS_MGF_TYPE mgf;
+	CK_ULONG digestLen;
+	CK_BYTE digestInfo[19];
+	CK_ULONG digestInfoLen;
+};
+
+const rsa_hash rsaHashes[] = {
+	{CKM_SHA_1, CKG_MGF1_SHA1, 20,
+		{0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2b, 0x0e, 0x03, 0x02, 0x1a, 0x05, 0x00, 0x04, 0x14}, 15},
+	{CKM_SHA224, CKG_MGF1_SHA224, 28,
+		{0x30, 0x2d, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, 0x05, 0x00, 0x04, 0x1c}, 19},
+	{CKM_SHA256, CKG_MGF1_SHA256, 32,
+		{0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20}, 19},
+	{CKM_SHA384, CKG_MGF1_SHA384, 48,
+		{0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30}, 19},
+	{CKM_SHA512, CKG_MGF1_SHA512, 64,
+		{0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40}, 19}
+};
+
+
+
+/**
+ * The signature mechanism with its PSS parameters, which have to live as long as the mechanism
+*/
+struct rsa_mechanism
+{
+	CK_RSA_PKCS_PSS_PARAMS paramPSS;
+	CK_MECHANISM mech;
+};
+
+
+
+/**
+ * The function finds the hash algorithm of RSA signatures
+ *
+ * The hash algorithm is returned, or NULL_PTR if it is not supported.
+*/
+static const rsa_hash* find_hash(const CK_MECHANISM_TYPE hashAlg)
+{
+	for (size_t i = 0; i < sizeof(rsaHashes) / sizeof(rsaHashes[0]); ++i) {
+		if (rsaHashes[i].hashAlg == hashAlg) {
+			return &rsaHashes[i];
+		}
+	}
+	return NULL_PTR;
+}
+
+
+
+/**
+ * The function gets the hash algorithm of the PSS mechanisms which hash on the token
+ *
+ * The hash algorithm is returned, or CKM_VENDOR_DEFINED if given mechanism is not one of them.
+*/
+static CK_MECHANISM_TYPE PSS_hash(const CK_MECHANISM_TYPE signMech)
+{
+	switch (signMech) {
+	case CKM_SHA1_RSA_PKCS_PSS:		return CKM_SHA_1;
+	case CKM_SHA224_RSA_PKCS_PSS:	return CKM_SHA224;
+	case CKM_SHA256_RSA_PKCS_PSS:	return CKM_SHA256;
+	case CKM_SHA384_RSA_PKCS_PSS:	return CKM_SHA384;
+	case CKM_SHA512_RSA_PKCS_PSS:	return CKM_SHA512;
+	default:						return CKM_VENDOR_DEFINED;
+	}
+}
+
+
+
+/**
+ * The function sets up the signature mechanism, where the PSS mechanisms get the parameters
+ * of given hash algorithm i.e., MGF1 with the same hash and the salt as long as the digest
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int make_mechanism(const CK_MECHANISM_TYPE signMech, const CK_MECHANISM_TYPE hashAlg, rsa_mechanism& mech)
+{
+	mech.mech.mechanism = signMech;
+	mech.mech.pParameter = NULL_PTR;
+	mech.mech.ulParameterLen = 0;
+
+	if (signMech != CKM_RSA_PKCS_PSS && PSS_hash(signMech) == CKM_VENDOR_DEFINED) {
+		// PKCS #1 v1.5 mechanisms do not have a parameter
+		return 0;
+	}
+
+	const rsa_hash* hash = find_hash(hashAlg);
+	if (!hash) {
+		cout << "Error, hash algorithm 0x" << std::hex << hashAlg << std::dec << " is not supported\n";
+		return 1;
+	}
+
+	/**
+	 * CK_RSA_PKCS_PSS_PARAMS is a structure that provides the parameters to the CKM_RSA_PKCS_PSS mechanism
+	 *
+	 * hashAlg is the hash algorithm used in the PSS encoding; for the hashed mechanisms
+	 * 		e.g., CKM_SHA256_RSA_PKCS_PSS, it must be the same hash
+	 * mgf is the mask generation function to apply to the encoded block
+	 * sLen is the length, in bytes, of the salt value used in the PSS encoding
+	*/
+	mech.paramPSS.hashAlg = hash->hashAlg;
+	mech.paramPSS.mgf = hash->mgf;
+	mech.paramPSS.sLen = hash->digestLen;
+	mech.mech.pParameter = &mech.paramPSS;
+	mech.mech.ulParameterLen = sizeof(mech.paramPSS);
+	return 0;
+}
+
+
+
+/**
+ * The function produces the signature of the initialized signing operation in a single part
+ * i.e., C_Sign(), or finishes it i.e., C_SignFinal() if dataPtr is NULL_PTR. If modulusLen is
+ * too short, the signature is produced again with the length returned by the token.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int produce_signature(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+								CK_BYTE_PTR const dataPtr, const CK_ULONG dataLen, const CK_ULONG modulusLen,
+								std::string& signature)
+{
+	CK_RV rv = CKR_OK;
+	CK_ULONG sigLen = modulusLen;
+
+	if (!sigLen) {
+		// Only the length is returned, the operation is not finished
+		rv = dataPtr ? funclistPtr->C_Sign(hSession, dataPtr, dataLen, NULL_PTR, &sigLen)
+						: funclistPtr->C_SignFinal(hSession, NULL_PTR, &sigLen);
+		if (check_operation(rv, dataPtr ? "C_Sign()" : "C_SignFinal()")) {
+			return 1;
+		}
+	}
+	signature.resize(sigLen);
+	CK_BYTE_PTR sigPtr = reinterpret_cast<CK_BYTE_PTR>(&signature[0]);
+	rv = dataPtr ? funclistPtr->C_Sign(hSession, dataPtr, dataLen, sigPtr, &sigLen)
+					: funclistPtr->C_SignFinal(hSession, sigPtr, &sigLen);
+	if (rv == CKR_BUFFER_TOO_SMALL) {
+		// The given modulus length was too short, sigLen holds the needed length. The operation
+		// is still active, so it is finished here, otherwise the next C_SignInit() would fail
+		signature.resize(sigLen);
+		sigPtr = reinterpret_cast<CK_BYTE_PTR>(&signature[0]);
+		rv = dataPtr ? funclistPtr->C_Sign(hSession, dataPtr, dataLen, sigPtr, &sigLen)
+						: funclistPtr->C_SignFinal(hSession, sigPtr, &sigLen);
+	}
+	if (check_operation(rv, dataPtr ? "C_Sign()" : "C_SignFinal()")) {
+		signature.clear();
+		return 1;
+	}
+	signature.resize(sigLen);
+	return 0;
+}
+
+
+
+/**
+ * The function initializes signing with an RSA private key
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant RSA private key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech)
+{
+	rsa_mechanism mech;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	if (make_mechanism(signMech, PSS_hash(signMech), mech)) {
+		return 2;
+	}
+	return check_operation(funclistPtr->C_SignInit(hSession, &mech.mech, hPrv), "C_SignInit()");
+}
+
+
+
+/**
+ * The function continues multi-part signing with the next part of the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * partPtr is a constant pointer to the part of the message
+ * partLen represents the byte-length of the part
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					CK_BYTE_PTR const partPtr, const CK_ULONG partLen)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+	return check_operation(funclistPtr->C_SignUpdate(hSession, partPtr, partLen), "C_SignUpdate()");
+}
+
+
+
+/**
+ * The function finishes multi-part signing
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * modulusLen represents the byte-length of the modulus, or 0 to ask the token
+ * signature is an alias of the signature to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_ULONG modulusLen, std::string& signature)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+	return produce_signature(funclistPtr, hSession, NULL_PTR, 0, modulusLen, signature) ? 4 : 0;
+}
+
+
+
+/**
+ * The function signs given message in a single part, where the token hashes the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant RSA private key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ * modulusLen represents the byte-length of the modulus, or 0 to ask the token
+ * message is an alias of constant message to be signed
+ * signature is an alias of the signature to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech, const CK_ULONG modulusLen,
+				const std::string& message, std::string& signature)
+{
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+
+	if (sign_RSA_init(funclistPtr, hSession, hPrv, signMech)) {
+		return 5;
+	}
+	return produce_signature(funclistPtr, hSession, msgPtr, message.length(), modulusLen, signature) ? 5 : 0;
+}
+
+
+
+/**
+ * The function initializes verifying with an RSA public key
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of constant RSA public key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA_init(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech)
+{
+	rsa_mechanism mech;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 6;
+	}
+	if (make_mechanism(signMech, PSS_hash(signMech), mech)) {
+		return 6;
+	}
+	return check_operation(funclistPtr->C_VerifyInit(hSession, &mech.mech, hPub), "C_VerifyInit()");
+}
+
+
+
+/**
+ * The function continues multi-part verifying with the next part of the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * partPtr is a constant pointer to the part of the message
+ * partLen represents the byte-length of the part
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA_update(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						CK_BYTE_PTR const partPtr, const CK_ULONG partLen)
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 7;
+	}
+	return check_operation(funclistPtr->C_VerifyUpdate(hSession, partPtr, partLen), "C_VerifyUpdate()");
+}
+
+
+
+/**
+ * The function finishes multi-part verifying
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * signature is an alias of constant signature to be verified
+ *
+ * On success i.e., the signature is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA_final(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const std::string& signature)
+{
+	CK_BYTE_PTR sigPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(signature.data()));
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 8;
+	}
+	return check_operation(funclistPtr->C_VerifyFinal(hSession, sigPtr, signature.length()), "C_VerifyFinal()");
+}
+
+
+
+/**
+ * The function verifies given signature on the message in a single part, where the token hashes the message
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of constant RSA public key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ * message is an alias of constant message that was signed
+ * signature is an alias of constant signature to be verified
+ *
+ * On success i.e., the signature is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+				const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech,
+				const std::string& message, const std::string& signature)
+{
+	CK_BYTE_PTR msgPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(message.data()));
+	CK_BYTE_PTR sigPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(signature.data()));
+
+	if (verify_RSA_init(funclistPtr, hSession, hPub, signMech)) {
+		return 9;
+	}
+	return check_operation(funclistPtr->C_Verify(hSession, msgPtr, message.length(), sigPtr, signature.length()),
+							"C_Verify()");
+}
+
+
+
+/**
+ * The function gets the data given to the raw mechanisms for a digest i.e., the digest itself
+ * for CKM_RSA_PKCS_PSS and the DigestInfo (prefix || digest) for CKM_RSA_PKCS
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int digest_data(const CK_MECHANISM_TYPE rawMech, const CK_MECHANISM_TYPE hashAlg,
+						const std::string& digest, std::string& data)
+{
+	const rsa_hash* hash = find_hash(hashAlg);
+
+	if (rawMech != CKM_RSA_PKCS_PSS && rawMech != CKM_RSA_PKCS) {
+		cout << "Error, mechanism 0x" << std::hex << rawMech << std::dec << " does not sign a digest\n";
+		return 1;
+	}
+	if (!hash || digest.length() != hash->digestLen) {
+		cout << "Error, digest does not match the hash algorithm\n";
+		return 1;
+	}
+	if (rawMech == CKM_RSA_PKCS) {
+		data.assign(reinterpret_cast<const char*>(hash->digestInfo), hash->digestInfoLen);
+		data += digest;
+	}
+	else {
+		data = digest;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function signs given digest computed on the host, using a raw mechanism
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPrv is an alias of constant RSA private key handle
+ * rawMech is the raw signature mechanism i.e., CKM_RSA_PKCS_PSS or CKM_RSA_PKCS
+ * hashAlg is the hash algorithm of the digest e.g., CKM_SHA256
+ * modulusLen represents the byte-length of the modulus, or 0 to ask the token
+ * digest is an alias of constant digest to be signed
+ * signature is an alias of the signature to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA_digest(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+					const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE rawMech, const CK_MECHANISM_TYPE hashAlg,
+					const CK_ULONG modulusLen, const std::string& digest, std::string& signature)
+{
+	rsa_mechanism mech;
+	std::string data;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 10;
+	}
+	if (digest_data(rawMech, hashAlg, digest, data) || make_mechanism(rawMech, hashAlg, mech)) {
+		return 10;
+	}
+	if (check_operation(funclistPtr->C_SignInit(hSession, &mech.mech, hPrv), "C_SignInit()")) {
+		return 10;
+	}
+	return produce_signature(funclistPtr, hSession, reinterpret_cast<CK_BYTE_PTR>(&data[0]), data.length(),
+								modulusLen, signature) ? 10 : 0;
+}
+
+
+
+/**
+ * The function verifies given signature on the digest computed on the host, using a raw mechanism
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of session ID/handle
+ * hPub is an alias of constant RSA public key handle
+ * rawMech is the raw signature mechanism i.e., CKM_RSA_PKCS_PSS or CKM_RSA_PKCS
+ * hashAlg is the hash algorithm of the digest e.g., CKM_SHA256
+ * digest is an alias of constant digest that was signed
+ * signature is an alias of constant signature to be verified
+ *
+ * On success i.e., the signature is valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA_digest(const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession,
+						const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE rawMech, const CK_MECHANISM_TYPE hashAlg,
+						const std::string& digest, const std::string& signature)
+{
+	rsa_mechanism mech;
+	std::string data;
+	CK_BYTE_PTR sigPtr = reinterpret_cast<CK_BYTE_PTR>(const_cast<char*>(signature.data()));
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 11;
+	}
+	if (digest_data(rawMech, hashAlg, digest, data) || make_mechanism(rawMech, hashAlg, mech)) {
+		return 11;
+	}
+	if (check_operation(funclistPtr->C_VerifyInit(hSession, &mech.mech, hPub), "C_VerifyInit()")) {
+		return 11;
+	}
+	return check_operation(funclistPtr->C_Verify(hSession, reinterpret_cast<CK_BYTE_PTR>(&data[0]), data.length(),
+													sigPtr, signature.length()), "C_Verify()");
+}
+
+
+
+/**
+ * The function signs (or verifies if signatures is not NULL_PTR) the messages in chunks across
+ * the worker sessions of given executor, see async_batch().
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+static int RSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hKey, const CK_MECHANISM_TYPE signMech,
+						const CK_ULONG modulusLen, const std::vector<std::string>& messages,
+						std::string* producedSigs, const std::string* signatures, std::vector<int>& results)
+{
+	results.assign(messages.size(), 0);
+	if (async_batch(executor, messages.size(), SIGNATURES_PER_CHUNK,
+					[&](const CK_FUNCTION_LIST_PTR funclistPtr, CK_SESSION_HANDLE& hSession, const size_t i) {
+						return signatures ? verify_RSA(funclistPtr, hSession, hKey, signMech, messages[i], signatures[i])
+										: sign_RSA(funclistPtr, hSession, hKey, signMech, modulusLen, messages[i],
+													producedSigs[i]);
+					}, results.data())) {
+		return 12;
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function signs many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hPrv is an alias of constant RSA private key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ * modulusLen represents the byte-length of the modulus, or 0 to ask the token for each signature
+ * messages is an alias of constant list of messages
+ * signatures is an alias of the signatures to be returned, where signatures[i] is the signature
+ * of messages[i] and empty if that signing failed
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int sign_RSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPrv, const CK_MECHANISM_TYPE signMech,
+					const CK_ULONG modulusLen, const std::vector<std::string>& messages,
+					std::vector<std::string>& signatures)
+{
+	std::vector<int> results;
+
+	signatures.assign(messages.size(), std::string());
+	return RSA_batch(executor, hPrv, signMech, modulusLen, messages, signatures.data(), NULL_PTR, results);
+}
+
+
+
+/**
+ * The function verifies the signatures of many messages across the worker sessions of given executor
+ *
+ * executor is an alias of started async_executor
+ * hPub is an alias of constant RSA public key handle
+ * signMech is the signature mechanism e.g., CKM_SHA256_RSA_PKCS_PSS, CKM_SHA256_RSA_PKCS
+ * messages is an alias of constant list of messages
+ * signatures is an alias of constant list of signatures, where signatures[i] is the signature of messages[i]
+ * results is an alias of the results, where results[i] is 0 if signatures[i] is valid
+ *
+ * On success i.e., all signatures are valid, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int verify_RSA_batch(async_executor& executor, const CK_OBJECT_HANDLE& hPub, const CK_MECHANISM_TYPE signMech,
+						const std::vector<std::string>& messages, const std::vector<std::string>& signatures,
+						std::vector<int>& results)
+{
+	if (signatures.size() != messages.size()) {
+		cout << "Error, number of signatures and messages are different\n";
+		return 13;
+	}
+	return RSA_batch(executor, hPub, signMech, 0, messages, NULL_PTR, signatures.data(), results);
+}
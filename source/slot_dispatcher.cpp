@@ -0,0 +1,271 @@
+#include <iostream>
+#include <chrono>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\login_manager.hpp"
+	#include "..\header\mechanism_cache.hpp"
+	#include "..\header\slot_dispatcher.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/login_manager.hpp"
+	#include "../header/mechanism_cache.hpp"
+	#include "../header/slot_dispatcher.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+/**
+ * The weight of the latest latency in the exponentially weighted moving average (EWMA)
+*/
+const double EWMA_WEIGHT = 0.2;
+
+
+
+/**
+ * The function finds the first object matching the given key selector
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * hSession is an alias of constant session ID/handle
+ * selector is an alias of constant key selector i.e., label, ID and class of the key
+ * hKey is an alias of key handle to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int find_key(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SESSION_HANDLE& hSession,
+				const key_selector& selector, CK_OBJECT_HANDLE& hKey)
+{
+	int retVal = 0;
+	CK_ULONG objCount = 0;
+	CK_OBJECT_CLASS keyClass = selector.keyClass;
+	CK_ATTRIBUTE findAttrb[3];
+	CK_ULONG attrbCount = 0;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+
+	if (!selector.label.empty()) {
+		findAttrb[attrbCount++] = {CKA_LABEL, const_cast<char*>(selector.label.c_str()), selector.label.length()};
+	}
+	if (!selector.id.empty()) {
+		findAttrb[attrbCount++] = {CKA_ID, const_cast<char*>(selector.id.c_str()), selector.id.length()};
+	}
+	if (keyClass != CK_UNAVAILABLE_INFORMATION) {
+		findAttrb[attrbCount++] = {CKA_CLASS, &keyClass, sizeof(keyClass)};
+	}
+
+	/**
+	 * CK_RV C_FindObjectsInit(CK_SESSION_HANDLE hSession, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG ulCount);
+	 *
+	 * C_FindObjectsInit() initializes a search for token and session objects that match a template.
+	 * hSession is the session’s handle;
+	 * pTemplate points to a search template that specifies the attribute values to match;
+	 * ulCount is the number of attributes in the search template.
+	 *
+	 * C_FindObjects() continues the search and C_FindObjectsFinal() terminates it.
+	*/
+	retVal = check_operation(funclistPtr->C_FindObjectsInit(hSession, findAttrb, attrbCount), "C_FindObjectsInit()");
+	if (!retVal) {
+		retVal = check_operation(funclistPtr->C_FindObjects(hSession, &hKey, 1, &objCount), "C_FindObjects()");
+		check_operation(funclistPtr->C_FindObjectsFinal(hSession), "C_FindObjectsFinal()");
+		if (!retVal && !objCount) {
+			// No matching key on this token
+			retVal = 2;
+		}
+	}
+	return retVal;
+}
+
+
+
+slot_dispatcher::slot_dispatcher()
+{
+}
+
+
+slot_dispatcher::~slot_dispatcher()
+{
+	stop();
+}
+
+
+
+/**
+ * The function adds every slot with a token present that holds the required key
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * selector is an alias of constant key selector
+ * usrPIN is an alias of user PIN used to login to every token
+ * workersPerSlot represents the number of worker threads (and sessions) per slot
+ *
+ * On success i.e., at least one slot is eligible, integer 0 is returned.
+ * Otherwise, non-zero integer is returned.
+*/
+int slot_dispatcher::start(const CK_FUNCTION_LIST_PTR funclistPtr, const key_selector& selector,
+							const std::string& usrPIN, const size_t workersPerSlot)
+{
+	CK_ULONG slotsCount = 0;
+	std::vector<CK_SLOT_ID> slotList;
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 3;
+	}
+
+	if (check_operation(funclistPtr->C_GetSlotList(CK_TRUE, NULL_PTR, &slotsCount), "C_GetSlotList()")) {
+		return 3;
+	}
+	slotList.resize(slotsCount);
+	if (slotsCount && check_operation(funclistPtr->C_GetSlotList(CK_TRUE, slotList.data(), &slotsCount),
+										"C_GetSlotList()")) {
+		return 3;
+	}
+
+	for (CK_ULONG i = 0; i < slotsCount; ++i) {
+		if (add_slot(funclistPtr, slotList[i], selector, usrPIN, workersPerSlot)) {
+			cout << "Slot ID " << slotList[i] << " is not eligible, skipped" << endl;
+		}
+	}
+	return slots.empty() ? 3 : 0;
+}
+
+
+
+/**
+ * The function logs in to the token of given slot (once per token, see login_manager), caches its mechanisms
+ * (see application_mechanisms()), finds the required key and starts an async_executor on that slot.
+ *
+ * funclistPtr is a pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ * selector is an alias of constant key selector
+ * usrPIN is an alias of user PIN
+ * workersPerSlot represents the number of worker threads (and sessions) on the slot
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int slot_dispatcher::add_slot(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+								const key_selector& selector, const std::string& usrPIN,
+								const size_t workersPerSlot)
+{
+	int retVal = 0;
+	std::unique_ptr<dispatch_slot> slot(new dispatch_slot());
+
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 4;
+	}
+	slot->funclistPtr = funclistPtr;
+	slot->slotID = slotID;
+	slot->pending = 0;
+	slot->ewmaMicros = 0.0;
+
+	retVal = check_operation(funclistPtr->C_OpenSession(slotID, CKF_SERIAL_SESSION | CKF_RW_SESSION,
+														NULL_PTR, NULL_PTR, &slot->hControl),
+								"C_OpenSession()");
+	if (retVal) {
+		return 4;
+	}
+
+	// The mechanisms are cached once per slot, as connect_slot() does, a failure is not fatal
+	if (application_mechanisms().build(funclistPtr, slotID)) {
+		cout << "Error, mechanisms of slot ID " << slotID << " are not cached\n";
+	}
+
+	// The login state is shared by all sessions of the application with a token
+	if (application_login().acquire(funclistPtr, slotID, slot->hControl, usrPIN)) {
+		check_operation(funclistPtr->C_CloseSession(slot->hControl), "C_CloseSession()");
+		return 4;
+	}
+	retVal = find_key(funclistPtr, slot->hControl, selector, slot->hKey);
+	if (!retVal) {
+		retVal = slot->executor.start_slot(funclistPtr, slotID, workersPerSlot);
+	}
+
+	if (retVal) {
+		application_login().release(funclistPtr, slotID, slot->hControl);
+		check_operation(funclistPtr->C_CloseSession(slot->hControl), "C_CloseSession()");
+		return 4;
+	}
+	slots.push_back(std::move(slot));
+	return 0;
+}
+
+
+
+/**
+ * The function stops the executors of all slots, releases their login references and
+ * closes the control sessions.
+ *
+ * The function does not return anything.
+*/
+void slot_dispatcher::stop()
+{
+	for (size_t i = 0; i < slots.size(); ++i) {
+		slots[i]->executor.stop();
+		application_login().release(slots[i]->funclistPtr, slots[i]->slotID, slots[i]->hControl);
+		check_operation(slots[i]->funclistPtr->C_CloseSession(slots[i]->hControl), "C_CloseSession()");
+	}
+	slots.clear();
+}
+
+
+
+/**
+ * The function picks the slot with the lowest (queued operations + 1) * EWMA latency.
+ * A slot without any measured latency is preferred so every slot gets measured.
+ *
+ * The pointer to the least-loaded slot is returned, or NULL_PTR if there is no slot.
+*/
+slot_dispatcher::dispatch_slot* slot_dispatcher::least_loaded()
+{
+	dispatch_slot* chosen = NULL_PTR;
+	double chosenCost = 0.0;
+
+	for (size_t i = 0; i < slots.size(); ++i) {
+		double latency = slots[i]->ewmaMicros.load();
+		double cost = (slots[i]->pending.load() + 1) * (latency > 0.0 ? latency : 1.0);
+		if (!chosen || cost < chosenCost) {
+			chosen = slots[i].get();
+			chosenCost = cost;
+		}
+	}
+	return chosen;
+}
+
+
+
+/**
+ * The function queues given operation on the least-loaded slot
+ *
+ * operation is the operation to be performed with the key found on the chosen slot
+ *
+ * The std::future holding the value returned by operation is returned.
+*/
+std::future<int> slot_dispatcher::submit(keyed_operation operation)
+{
+	dispatch_slot* slot = least_loaded();
+
+	if (!slot) {
+		cout << "Error, no slot is available for dispatching\n";
+		std::promise<int> noSlot;
+		noSlot.set_value(5);
+		return noSlot.get_future();
+	}
+
+	++slot->pending;
+	return slot->executor.submit([slot, operation](CK_SESSION_HANDLE& hWorker) {
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		int retVal = operation(slot->funclistPtr, hWorker, slot->hKey);
+		double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+		// Concurrent updates may lose a sample which is acceptable for an estimate
+		double ewma = slot->ewmaMicros.load();
+		slot->ewmaMicros.store(ewma > 0.0 ? ewma + EWMA_WEIGHT * (latency - ewma) : latency);
+		--slot->pending;
+		return retVal;
+	});
+}
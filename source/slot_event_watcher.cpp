@@ -0,0 +1,280 @@
+#include <iostream>
+#ifdef WIND
+	#include "..\header\common_basic_operation.hpp"
+	#include "..\header\slot_event_watcher.hpp"
+#else
+	#include "../header/common_basic_operation.hpp"
+	#include "../header/slot_event_watcher.hpp"
+#endif
+
+
+using std::cout;
+using std::endl;
+
+
+
+/**
+ * funclistPtr is a const pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * interval is the sleep time between checks when no event is pending
+*/
+slot_event_watcher::slot_event_watcher(const CK_FUNCTION_LIST_PTR funclistPtr,
+										const std::chrono::milliseconds interval)
+	: funclistPtr(funclistPtr), interval(interval), nextSubscriberID(0), stopping(false), polling(false)
+{
+}
+
+
+slot_event_watcher::~slot_event_watcher()
+{
+	stop();
+}
+
+
+
+/**
+ * The function adds given callback to the subscribers of slot events
+ *
+ * callback is the callback invoked on the watcher thread for every slot event
+ *
+ * The subscriber ID to be used with unsubscribe() is returned.
+*/
+size_t slot_event_watcher::subscribe(slot_event_callback callback)
+{
+	std::lock_guard<std::mutex> lock(watcherMutex);
+	subscribers[nextSubscriberID] = callback;
+	return nextSubscriberID++;
+}
+
+
+void slot_event_watcher::unsubscribe(const size_t subscriberID)
+{
+	std::lock_guard<std::mutex> lock(watcherMutex);
+	subscribers.erase(subscriberID);
+}
+
+
+
+/**
+ * The function reads the current slot states and starts the watcher thread
+ * Note that Cryptoki library should be initialized before calling this function.
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int slot_event_watcher::start()
+{
+	// Checking whether funclistPtr is null or not
+	if (is_nullptr(funclistPtr)) {
+		return 2;
+	}
+	if (watcher.joinable()) {
+		cout << "Error, slot event watcher is already started\n";
+		return 2;
+	}
+	if (read_slot_states(knownSlots)) {
+		return 2;
+	}
+	stopping = false;
+	polling = false;
+	watcher = std::thread(&slot_event_watcher::run, this);
+	return 0;
+}
+
+
+
+/**
+ * The function stops and joins the watcher thread
+ *
+ * The function does not return anything.
+*/
+void slot_event_watcher::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(watcherMutex);
+		stopping = true;
+	}
+	stopRequested.notify_all();
+	if (watcher.joinable()) {
+		watcher.join();
+	}
+}
+
+
+
+/**
+ * The function is executed by the watcher thread until stop() is called
+ *
+ * The function does not return anything.
+*/
+void slot_event_watcher::run()
+{
+	CK_SLOT_ID slotID = 0;
+	CK_SLOT_INFO slotInfo;
+	CK_RV rv = CKR_OK;
+	CK_RV reportedRV = CKR_OK;		// The error already reported, until C_WaitForSlotEvent() recovers
+
+	for (;;) {
+		{
+			// Checked on every iteration, since pending events are read without sleeping
+			std::lock_guard<std::mutex> lock(watcherMutex);
+			if (stopping) {
+				return;
+			}
+		}
+		if (polling) {
+			poll_slots();
+		}
+		else {
+			/**
+			 * CK_RV C_WaitForSlotEvent(CK_FLAGS flags, CK_SLOT_ID_PTR pSlot, CK_VOID_PTR pReserved);
+			 *
+			 * C_WaitForSlotEvent() waits for a slot event, such as token insertion or token removal, to occur.
+			 *
+			 * flags determines whether or not the C_WaitForSlotEvent() call blocks i.e., CKF_DONT_BLOCK
+			 * pSlot points to a location which will receive the ID of the slot that the event occurred in
+			 * pReserved is reserved for future versions, it should be NULL_PTR
+			 *
+			 * With CKF_DONT_BLOCK, CKR_NO_EVENT is returned if there is no pending event.
+			*/
+			rv = funclistPtr->C_WaitForSlotEvent(CKF_DONT_BLOCK, &slotID, NULL_PTR);
+			if (rv == CKR_OK) {
+				slot_event event = {slotID, false};
+				if (funclistPtr->C_GetSlotInfo(slotID, &slotInfo) == CKR_OK) {
+					event.tokenPresent = (slotInfo.flags & CKF_TOKEN_PRESENT) != 0;
+				}
+				knownSlots[slotID] = event.tokenPresent;
+				publish(event);
+				reportedRV = CKR_OK;
+				// Several events may be pending, check again without sleeping
+				continue;
+			}
+			if (rv == CKR_FUNCTION_NOT_SUPPORTED) {
+				cout << "C_WaitForSlotEvent() is not supported, polling the slots instead" << endl;
+				polling = true;
+				continue;
+			}
+			if (rv == CKR_NO_EVENT) {
+				reportedRV = CKR_OK;
+			}
+			else if (rv != reportedRV) {
+				// A persistent error is reported once instead of every interval
+				check_operation(rv, "C_WaitForSlotEvent()");
+				reportedRV = rv;
+			}
+		}
+
+		if (!sleep_interval()) {
+			// stop() was called
+			return;
+		}
+	}
+}
+
+
+
+/**
+ * The function reads the token present state of all slots
+ *
+ * states is an alias of map of slot ID to token present state to be returned
+ *
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int slot_event_watcher::read_slot_states(std::map<CK_SLOT_ID, bool>& states)
+{
+	CK_ULONG slotsCount = 0;
+	std::vector<CK_SLOT_ID> slotList;
+	CK_SLOT_INFO slotInfo;
+
+	if (check_operation(funclistPtr->C_GetSlotList(CK_FALSE, NULL_PTR, &slotsCount), "C_GetSlotList()")) {
+		return 3;
+	}
+	slotList.resize(slotsCount);
+	if (slotsCount && check_operation(funclistPtr->C_GetSlotList(CK_FALSE, slotList.data(), &slotsCount),
+										"C_GetSlotList()")) {
+		return 3;
+	}
+
+	states.clear();
+	for (CK_ULONG i = 0; i < slotsCount; ++i) {
+		// Only the slot information is read, it is much cheaper than C_GetTokenInfo()
+		if (funclistPtr->C_GetSlotInfo(slotList[i], &slotInfo) == CKR_OK) {
+			states[slotList[i]] = (slotInfo.flags & CKF_TOKEN_PRESENT) != 0;
+		}
+	}
+	return 0;
+}
+
+
+
+/**
+ * The function compares the current slot states with the known ones and publishes
+ * an event for every changed, added or removed slot.
+ *
+ * The function does not return anything.
+*/
+void slot_event_watcher::poll_slots()
+{
+	std::map<CK_SLOT_ID, bool> currentSlots;
+
+	if (!read_slot_states(currentSlots)) {
+		for (std::map<CK_SLOT_ID, bool>::const_iterator it = currentSlots.begin(); it != currentSlots.end(); ++it) {
+			std::map<CK_SLOT_ID, bool>::const_iterator known = knownSlots.find(it->first);
+			if (known == knownSlots.end() || known->second != it->second) {
+				slot_event event = {it->first, it->second};
+				publish(event);
+			}
+		}
+		for (std::map<CK_SLOT_ID, bool>::const_iterator it = knownSlots.begin(); it != knownSlots.end(); ++it) {
+			if (it->second && currentSlots.find(it->first) == currentSlots.end()) {
+				slot_event event = {it->first, false};
+				publish(event);
+			}
+		}
+		knownSlots.swap(currentSlots);
+	}
+}
+
+
+
+void slot_event_watcher::publish(const slot_event& event)
+{
+	std::map<size_t, slot_event_callback> current;
+	{
+		std::lock_guard<std::mutex> lock(watcherMutex);
+		current = subscribers;
+	}
+	for (std::map<size_t, slot_event_callback>::const_iterator it = current.begin(); it != current.end(); ++it) {
+		it->second(event);
+	}
+}
+
+
+
+/**
+ * The function sleeps for the interval unless stop() is called
+ *
+ * If the watcher should continue, true is returned. Otherwise, false is returned.
+*/
+bool slot_event_watcher::sleep_interval()
+{
+	std::unique_lock<std::mutex> lock(watcherMutex);
+	return !stopRequested.wait_for(lock, interval, [this] { return stopping; });
+}
+
+
+
+/**
+ * The function subscribes given inventory, so only the changed slot is re-read
+ * instead of a full rescan of every slot.
+ *
+ * watcher is an alias of slot_event_watcher
+ * inventory is an alias of slot_inventory, it should outlive the watcher thread
+ *
+ * The function does not return anything.
+*/
+void watch_inventory(slot_event_watcher& watcher, slot_inventory& inventory)
+{
+	slot_inventory* inventoryPtr = &inventory;
+	watcher.subscribe([inventoryPtr](const slot_event& event) {
+		inventoryPtr->refresh_slot(event.slotID);
+	});
+}
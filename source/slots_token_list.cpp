@@ -199,4 +199,176 @@ int display_all_slot_token(const CK_FUNCTION_LIST_PTR funclistPtr)
 	retVal = check_operation(funclistPtr->C_Finalize(NULL_PTR), "C_Finalize()");
 	return retVal;
 	
-}
\ No newline at end of file
+}
+
+
+/**
+ * The function gets the slot information and, if a token is present, the token information
+ * Note that Cryptoki library should be initialized before calling this function.
+ * If the token information cannot be read e.g., the token was removed or is not recognized,
+ * the slot is still reported with tokenPresent set to false.
+ * 
+ * funclistPtr is a const pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * slotID is the ID of the slot
+ * info is an alias of slot and token information to be returned
+ * 
+ * On success i.e., the slot information is read, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int get_slot_token_info(const CK_FUNCTION_LIST_PTR funclistPtr, const CK_SLOT_ID slotID,
+						slot_token_info& info)
+{
+	int retVal = 0;
+
+	// Checking whether funclistPtr is null or not 
+	if (is_nullptr(funclistPtr)) {
+		return 7;
+	}
+
+	info.slotID = slotID;
+	info.tokenPresent = false;
+	retVal = check_operation(funclistPtr->C_GetSlotInfo(slotID, &info.slotInfo), "C_GetSlotInfo()");
+	if (!retVal && (info.slotInfo.flags & CKF_TOKEN_PRESENT)) {
+		// The slot exists, so only its token is reported as missing
+		info.tokenPresent = !check_operation(funclistPtr->C_GetTokenInfo(slotID, &info.tokenInfo), "C_GetTokenInfo()");
+	}
+	return retVal;
+}
+
+
+
+/**
+ * The constructor does not call any Cryptoki function, the inventory is filled
+ * on the first refresh() or lookup().
+ * 
+ * funclistPtr is a const pointer to the list of functions i.e., CK_FUNCTION_LIST_PTR
+ * ttl is the time-to-live of the cached information
+*/
+slot_inventory::slot_inventory(const CK_FUNCTION_LIST_PTR funclistPtr, const std::chrono::milliseconds ttl)
+	: funclistPtr(funclistPtr), ttl(ttl), refreshed(false)
+{
+}
+
+
+
+/**
+ * The function re-reads the information of all slots (with or without token)
+ * Note that Cryptoki library should be initialized before calling this function.
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int slot_inventory::refresh()
+{
+	std::lock_guard<std::mutex> lock(slotsMutex);
+	return refresh_locked();
+}
+
+
+int slot_inventory::refresh_locked()
+{
+	int retVal = 0;
+	CK_ULONG slotsCount = 0;
+	std::vector<CK_SLOT_ID> slotList;
+	slot_token_info info;
+
+	// Checking whether funclistPtr is null or not 
+	if (is_nullptr(funclistPtr)) {
+		return 8;
+	}
+
+	retVal = check_operation(funclistPtr->C_GetSlotList(CK_FALSE, NULL_PTR, &slotsCount), "C_GetSlotList()");
+	if (!retVal) {
+		slotList.resize(slotsCount);
+		if (slotsCount) {
+			retVal = check_operation(funclistPtr->C_GetSlotList(CK_FALSE, slotList.data(), &slotsCount), "C_GetSlotList()");
+		}
+	}
+	if (retVal) {
+		return 8;
+	}
+
+	slots.clear();
+	for (CK_ULONG i = 0; i < slotsCount; ++i) {
+		if (!get_slot_token_info(funclistPtr, slotList[i], info)) {
+			slots[info.slotID] = info;
+		}
+	}
+	refreshedAt = std::chrono::steady_clock::now();
+	refreshed = true;
+	return 0;
+}
+
+
+
+/**
+ * The function re-reads the information of given slot only e.g., when a slot event is reported.
+ * If the slot does not exist anymore, then it is removed from the inventory.
+ * 
+ * slotID is the ID of the slot
+ * 
+ * On success, integer 0 is returned. Otherwise, non-zero integer is returned.
+*/
+int slot_inventory::refresh_slot(const CK_SLOT_ID slotID)
+{
+	slot_token_info info;
+	std::lock_guard<std::mutex> lock(slotsMutex);
+
+	if (get_slot_token_info(funclistPtr, slotID, info)) {
+		slots.erase(slotID);
+		return 9;
+	}
+	slots[slotID] = info;
+	return 0;
+}
+
+
+
+/**
+ * The function looks up the cached information of given slot. If the inventory
+ * is older than its TTL, then it is refreshed first.
+ * 
+ * slotID is the ID of the slot
+ * info is an alias of slot and token information to be returned
+ * 
+ * If the slot is found, true is returned. Otherwise, false is returned.
+*/
+bool slot_inventory::lookup(const CK_SLOT_ID slotID, slot_token_info& info)
+{
+	std::lock_guard<std::mutex> lock(slotsMutex);
+
+	if (is_stale()) {
+		refresh_locked();
+	}
+	std::unordered_map<CK_SLOT_ID, slot_token_info>::const_iterator found = slots.find(slotID);
+	if (found == slots.end()) {
+		return false;
+	}
+	info = found->second;
+	return true;
+}
+
+
+
+/**
+ * The function returns a copy of the information of all slots, refreshed first
+ * if the inventory is older than its TTL.
+*/
+std::vector<slot_token_info> slot_inventory::snapshot()
+{
+	std::vector<slot_token_info> allSlots;
+	std::lock_guard<std::mutex> lock(slotsMutex);
+
+	if (is_stale()) {
+		refresh_locked();
+	}
+	allSlots.reserve(slots.size());
+	for (std::unordered_map<CK_SLOT_ID, slot_token_info>::const_iterator it = slots.begin(); it != slots.end(); ++it) {
+		allSlots.push_back(it->second);
+	}
+	return allSlots;
+}
+
+
+bool slot_inventory::is_stale() const
+{
+	return !refreshed || std::chrono::steady_clock::now() - refreshedAt >= ttl;
+}